@@ -45,6 +45,7 @@ set(mrv2_ARGS
     -DMRV2_PYBIND11=${MRV2_PYBIND11}
     -DMRV2_PDF=${MRV2_PDF}
     -DMRV2_PYFLTK=${MRV2_PYFLTK}
+    -DMRV2_BENCHMARKS=${MRV2_BENCHMARKS}
 
     # defined when FLTK is built
     -DFLTK_BUILD_SHARED_LIBS=${FLTK_BUILD_SHARED_LIBS}  
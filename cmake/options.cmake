@@ -16,6 +16,7 @@ set(MRV2_PYBIND11 TRUE CACHE BOOL "Enable pybind11 building" )
 set(MRV2_PYFLTK   TRUE CACHE BOOL "Enable pyFLTK binding" )
 set(MRV2_NETWORK TRUE CACHE BOOL "Enable Networking in mrv2" )
 set(MRV2_PDF TRUE CACHE BOOL "Enable PDF creation in mrv2" )
+set(MRV2_BENCHMARKS FALSE CACHE BOOL "Enable building mrv2's benchmarks" )
 
 option(GIT_SUBMODULE "Check tlRender submodule during build if missing" ON)
 
@@ -0,0 +1,522 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// mrv2
+// Copyright Contributors to the mrv2 Project. All rights reserved.
+
+//
+// Load test of mrv2's network sync.
+//
+// It starts a relay server on localhost that hands the messages of each
+// connection to mrv2's MessagePublisher, like ConnectionHandler does, and
+// connects N simulated clients to it.  The first client is the presenter:
+// it replays a trace through mrv2's TCP send queue (with its coalescing and
+// rate control).  The others receive the relayed messages and measure
+// their end-to-end latency.
+//
+// Usage:
+//     mrv2NetworkBench [-clients N] [-trace scrub|draw|pan|<file.jsonl>]
+//                      [-duration seconds] [-rate events/second]
+//                      [-sendRate sends/second] [-port port]
+//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#    include <windows.h>
+#endif
+
+#include <Poco/Net/ServerSocket.h>
+#include <Poco/Net/SocketAddress.h>
+#include <Poco/Net/StreamSocket.h>
+#include <Poco/Net/TCPServer.h>
+#include <Poco/Net/TCPServerConnection.h>
+#include <Poco/Net/TCPServerConnectionFactory.h>
+#include <Poco/Timespan.h>
+
+#include "mrvNetwork/mrvMessage.h"
+#include "mrvNetwork/mrvMessagePublisher.h"
+#include "mrvNetwork/mrvTCP.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    const Poco::Timespan kPollTimeout(0, 250000);
+
+    //! Field added to each message with the time it was pushed.
+    const char* kTimeField = "benchTime";
+
+    struct Options
+    {
+        int clients = 4;
+        int16_t port = 5801;
+        std::string trace = "scrub";
+        double duration = 10.0;
+        int rate = 240;
+        int sendRate = mrv::TCP::maxSendRate();
+    };
+
+    std::atomic<bool> stopping = false;
+
+    mrv::MessagePublisher publisher;
+
+    int64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   Clock::now().time_since_epoch())
+            .count();
+    }
+
+    //! CPU time used by the calling thread, in seconds.
+    double threadCPUTime()
+    {
+#ifdef _WIN32
+        FILETIME creation, exit, kernel, user;
+        if (!GetThreadTimes(
+                GetCurrentThread(), &creation, &exit, &kernel, &user))
+            return 0.0;
+        ULARGE_INTEGER k, u;
+        k.LowPart = kernel.dwLowDateTime;
+        k.HighPart = kernel.dwHighDateTime;
+        u.LowPart = user.dwLowDateTime;
+        u.HighPart = user.dwHighDateTime;
+        return (k.QuadPart + u.QuadPart) * 1e-7;
+#else
+        timespec ts;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+    }
+
+    //! Receive a length prefixed message.  Returns false when the
+    //! connection is closed.
+    bool receiveFrame(
+        Poco::Net::StreamSocket& socket, std::vector<uint8_t>& buffer,
+        size_t& bytes)
+    {
+        int messageLength = 0;
+        int size = socket.receiveBytes(&messageLength, sizeof(messageLength));
+        if (size <= 0)
+            return false;
+        messageLength = ntohl(messageLength);
+        if (messageLength <= 0)
+            return false;
+
+        buffer.resize(messageLength);
+        int len = 0;
+        while (len < messageLength)
+        {
+            size = socket.receiveBytes(
+                buffer.data() + len, messageLength - len);
+            if (size <= 0)
+                return false;
+            len += size;
+        }
+        bytes += sizeof(messageLength) + messageLength;
+        return true;
+    }
+
+    //! Server side of a connection, relaying its messages to the other
+    //! connections through the MessagePublisher.
+    class RelayConnection : public Poco::Net::TCPServerConnection
+    {
+    public:
+        RelayConnection(const Poco::Net::StreamSocket& socket) :
+            Poco::Net::TCPServerConnection(socket)
+        {
+        }
+
+        void run() override
+        {
+            auto& s = socket();
+            const std::string key = s.peerAddress().toString();
+            publisher.add(key, s);
+
+            std::vector<uint8_t> buffer;
+            size_t bytes = 0;
+            try
+            {
+                while (!stopping)
+                {
+                    if (!s.poll(kPollTimeout, Poco::Net::Socket::SELECT_READ))
+                        continue;
+                    if (!receiveFrame(s, buffer, bytes))
+                        break;
+                    const mrv::Message message =
+                        nlohmann::json::from_bson(buffer);
+                    publisher.publish(message, key);
+                }
+            }
+            catch (const std::exception& e)
+            {
+                std::cerr << "relay: " << e.what() << std::endl;
+            }
+            publisher.remove(key);
+        }
+    };
+
+    //! Simulated presenter, sending through mrv2's TCP send queue.
+    class Presenter : public mrv::TCP
+    {
+    public:
+        Presenter(const std::string& host, int16_t port) :
+            TCP(host, port)
+        {
+            m_socket.connect(m_address);
+            m_running = true;
+            m_threads.push_back(new std::thread(
+                [this]
+                {
+                    while (m_running)
+                    {
+                        waitForSend();
+                        sendMessages();
+                    }
+                    cpu = threadCPUTime();
+                }));
+        }
+
+        void sendMessages() override
+        {
+            for (auto& message : takeSend())
+            {
+                mrv::packMessage(message);
+                const std::vector<uint8_t> v_bson =
+                    nlohmann::json::to_bson(message);
+                const int messageLength = v_bson.size();
+                const int messageLengthHtoNL = htonl(messageLength);
+                m_socket.sendBytes(&messageLengthHtoNL, sizeof(messageLength));
+                int len = 0;
+                while (len < messageLength)
+                {
+                    int size = m_socket.sendBytes(
+                        v_bson.data() + len, messageLength - len);
+                    if (size <= 0)
+                        return;
+                    len += size;
+                }
+                ++messages;
+                bytes += sizeof(messageLength) + messageLength;
+            }
+        }
+
+        void receiveMessages() override {}
+
+        size_t messages = 0;
+        size_t bytes = 0;
+        double cpu = 0.0;
+    };
+
+    //! Simulated client receiving the relayed messages.
+    class Receiver
+    {
+    public:
+        Receiver(const Poco::Net::SocketAddress& address)
+        {
+            socket.connect(address);
+            thread = std::thread([this] { _run(); });
+        }
+
+        void join()
+        {
+            if (thread.joinable())
+                thread.join();
+            socket.close();
+        }
+
+        std::vector<double> latencies;
+        size_t messages = 0;
+        size_t bytes = 0;
+        double cpu = 0.0;
+
+    private:
+        void _run()
+        {
+            std::vector<uint8_t> buffer;
+            try
+            {
+                while (!stopping)
+                {
+                    if (!socket.poll(
+                            kPollTimeout, Poco::Net::Socket::SELECT_READ))
+                        continue;
+                    if (!receiveFrame(socket, buffer, bytes))
+                        break;
+                    const mrv::Message message =
+                        nlohmann::json::from_bson(buffer);
+                    ++messages;
+                    if (message.contains(kTimeField))
+                    {
+                        const int64_t sent = message[kTimeField];
+                        latencies.push_back((now() - sent) / 1e6);
+                    }
+                }
+            }
+            catch (const std::exception& e)
+            {
+                std::cerr << "receiver: " << e.what() << std::endl;
+            }
+            cpu = threadCPUTime();
+        }
+
+        Poco::Net::StreamSocket socket;
+        std::thread thread;
+    };
+
+    nlohmann::json makePoint(double x, double y)
+    {
+        return {{"x", x}, {"y", y}};
+    }
+
+    nlohmann::json makePathShape(const nlohmann::json& pts)
+    {
+        return {
+            {"type", "DrawPath"},
+            {"matrix", std::vector<float>{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0,
+                                          0, 0, 0, 1}},
+            {"color", std::vector<float>{0.F, 1.F, 0.F, 1.F}},
+            {"pen_size", 5.F},
+            {"soft", false},
+            {"laser", false},
+            {"fade", 1.F},
+            {"pts", pts}};
+    }
+
+    //! Build the messages of a trace, one per input event.
+    std::vector<mrv::Message> makeTrace(const Options& options)
+    {
+        std::vector<mrv::Message> out;
+        const int events = std::max(1, options.rate) * 10;
+
+        if (options.trace == "scrub")
+        {
+            for (int i = 0; i < events; ++i)
+            {
+                const double X = (i % 1000) / 1000.0;
+                out.push_back(
+                    {{"command", "Timeline Mouse Move"}, {"X", X}, {"Y", 0.5}});
+                out.push_back(
+                    {{"command", "seek"},
+                     {"value", {{"value", i % 1000}, {"rate", 24.0}}}});
+            }
+        }
+        else if (options.trace == "draw")
+        {
+            const int pointsPerStroke = 200;
+            for (int i = 0; i < events; i += pointsPerStroke)
+            {
+                nlohmann::json pts = nlohmann::json::array();
+                pts.push_back(makePoint(i, 0));
+                out.push_back(
+                    {{"command", "Create Shape"},
+                     {"value", makePathShape(pts)}});
+                for (int j = 1; j < pointsPerStroke; ++j)
+                {
+                    const auto pnt = makePoint(i + j, j * 0.5);
+                    pts.push_back(pnt);
+                    out.push_back(
+                        {{"command", "Add Shape Point"}, {"value", pnt}});
+                }
+                out.push_back(
+                    {{"command", "End Shape"}, {"value", makePathShape(pts)}});
+            }
+        }
+        else if (options.trace == "pan")
+        {
+            for (int i = 0; i < events; ++i)
+            {
+                out.push_back(
+                    {{"command", "viewPosAndZoom"},
+                     {"viewPos", {{"x", i % 500}, {"y", i % 300}}},
+                     {"zoom", 1.0 + (i % 100) / 100.0},
+                     {"viewport", {{"w", 1920}, {"h", 1080}}}});
+            }
+        }
+        else
+        {
+            // A recorded trace, with one message per line.
+            std::ifstream file(options.trace);
+            if (!file.is_open())
+                throw std::runtime_error("Could not open " + options.trace);
+            std::string line;
+            while (std::getline(file, line))
+            {
+                if (line.empty())
+                    continue;
+                out.push_back(nlohmann::json::parse(line));
+            }
+        }
+        return out;
+    }
+
+    double percentile(const std::vector<double>& sorted, double p)
+    {
+        if (sorted.empty())
+            return 0.0;
+        const size_t i = std::min(
+            sorted.size() - 1, static_cast<size_t>(p * sorted.size()));
+        return sorted[i];
+    }
+
+    void usage()
+    {
+        std::cout << "mrv2NetworkBench [-clients N] "
+                     "[-trace scrub|draw|pan|<file.jsonl>]" << std::endl
+                  << "                 [-duration seconds] "
+                     "[-rate events/second]" << std::endl
+                  << "                 [-sendRate sends/second] [-port port]"
+                  << std::endl;
+    }
+
+    bool parseOptions(int argc, char* argv[], Options& options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string arg = argv[i];
+            if (arg == "-h" || arg == "-help")
+                return false;
+            if (i + 1 >= argc)
+            {
+                std::cerr << "Missing value for " << arg << std::endl;
+                return false;
+            }
+            const std::string value = argv[++i];
+            if (arg == "-clients")
+                options.clients = std::max(2, std::stoi(value));
+            else if (arg == "-port")
+                options.port = static_cast<int16_t>(std::stoi(value));
+            else if (arg == "-trace")
+                options.trace = value;
+            else if (arg == "-duration")
+                options.duration = std::stod(value);
+            else if (arg == "-rate")
+                options.rate = std::max(1, std::stoi(value));
+            else if (arg == "-sendRate")
+                options.sendRate = std::stoi(value);
+            else
+            {
+                std::cerr << "Unknown option " << arg << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    using namespace mrv;
+
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        usage();
+        return 1;
+    }
+
+    try
+    {
+        TCP::setMaxSendRate(options.sendRate);
+
+        const std::vector<Message> trace = makeTrace(options);
+
+        const Poco::Net::SocketAddress address("127.0.0.1", options.port);
+        Poco::Net::ServerSocket serverSocket(address);
+        Poco::Net::TCPServer server(
+            new Poco::Net::TCPServerConnectionFactoryImpl<RelayConnection>(),
+            serverSocket);
+        server.start();
+
+        std::vector<std::unique_ptr<Receiver> > receivers;
+        for (int i = 1; i < options.clients; ++i)
+            receivers.push_back(std::make_unique<Receiver>(address));
+        auto presenter = std::make_unique<Presenter>(
+            address.host().toString(), options.port);
+
+        // Let the server register all the connections.
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+        const std::clock_t cpuStart = std::clock();
+        const auto start = Clock::now();
+        const auto end =
+            start + std::chrono::microseconds(
+                        static_cast<int64_t>(options.duration * 1e6));
+        const auto interval = std::chrono::microseconds(1000000 / options.rate);
+        size_t events = 0;
+        for (auto next = start; next < end; next += interval)
+        {
+            std::this_thread::sleep_until(next);
+            Message message = trace[events % trace.size()];
+            message[kTimeField] = now();
+            presenter->pushMessage(message);
+            ++events;
+        }
+
+        // Let the last messages arrive.
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        stopping = true;
+        presenter->stop();
+        for (auto& receiver : receivers)
+            receiver->join();
+        presenter->close();
+        server.stop();
+
+        const double cpu =
+            static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "Trace " << options.trace << ": " << events
+                  << " events at " << options.rate << " events/s, "
+                  << options.clients - 1 << " receivers, send rate "
+                  << options.sendRate << "/s" << std::endl;
+        std::cout << "Presenter: " << presenter->messages << " messages ("
+                  << (events ? 100.0 * presenter->messages / events : 0.0)
+                  << "% of events), " << presenter->bytes << " bytes, "
+                  << presenter->cpu * 1000.0 << " ms CPU" << std::endl;
+        std::cout << "Process: " << cpu * 1000.0 << " ms CPU" << std::endl;
+        std::cout << std::endl;
+        std::cout << std::setw(8) << "Client" << std::setw(10) << "Messages"
+                  << std::setw(12) << "Bytes" << std::setw(10) << "p50 ms"
+                  << std::setw(10) << "p90 ms" << std::setw(10) << "p99 ms"
+                  << std::setw(10) << "max ms" << std::setw(10) << "CPU ms"
+                  << std::endl;
+
+        std::vector<double> all;
+        for (size_t i = 0; i < receivers.size(); ++i)
+        {
+            auto& r = *receivers[i];
+            std::sort(r.latencies.begin(), r.latencies.end());
+            all.insert(all.end(), r.latencies.begin(), r.latencies.end());
+            std::cout << std::setw(8) << i + 1 << std::setw(10) << r.messages
+                      << std::setw(12) << r.bytes << std::setw(10)
+                      << percentile(r.latencies, 0.5) << std::setw(10)
+                      << percentile(r.latencies, 0.9) << std::setw(10)
+                      << percentile(r.latencies, 0.99) << std::setw(10)
+                      << (r.latencies.empty() ? 0.0 : r.latencies.back())
+                      << std::setw(10) << r.cpu * 1000.0 << std::endl;
+        }
+        std::sort(all.begin(), all.end());
+        std::cout << std::setw(8) << "all" << std::setw(10) << all.size()
+                  << std::setw(12) << "" << std::setw(10)
+                  << percentile(all, 0.5) << std::setw(10)
+                  << percentile(all, 0.9) << std::setw(10)
+                  << percentile(all, 0.99) << std::setw(10)
+                  << (all.empty() ? 0.0 : all.back()) << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
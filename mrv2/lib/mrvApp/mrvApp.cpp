@@ -2,7 +2,11 @@
 // mrv2
 // Copyright Contributors to the mrv2 Project. All rights reserved.
 
+#include <atomic>
 #include <fstream>
+#include <future>
+#include <list>
+#include <map>
 #include <sstream>
 
 #include <tlIO/System.h>
@@ -21,6 +25,8 @@ namespace py = pybind11;
 #endif
 
 #include "mrvCore/mrvOS.h" // do not move up
+#include "mrvCore/mrvCPU.h"
+#include "mrvCore/mrvFileWatcher.h"
 #include "mrvCore/mrvMemory.h"
 #include "mrvCore/mrvHome.h"
 #include "mrvCore/mrvHotkey.h"
@@ -31,6 +37,8 @@ namespace py = pybind11;
 #include "mrvFl/mrvContextObject.h"
 #include "mrvFl/mrvLanguages.h"
 #include "mrvFl/mrvPreferences.h"
+#include "mrvFl/mrvRenderQueue.h"
+#include "mrvFl/mrvSave.h"
 #include "mrvFl/mrvSession.h"
 #include "mrvFl/mrvTimelinePlayer.h"
 
@@ -80,6 +88,7 @@ namespace py = pybind11;
 #include <FL/platform.H>
 #include <FL/filename.H>
 #include <FL/fl_ask.H>
+#include <FL/Fl_Preferences.H>
 #include <FL/Fl.H>
 
 #ifdef __linux__
@@ -120,7 +129,48 @@ namespace mrv
     namespace
     {
         const float errorTimeout = 5.F;
-    }
+
+        //! Minimum number of threads used to create timelines.  Probing
+        //! media on network drives is mostly waiting, so we use more
+        //! threads than cores on small machines.
+        const size_t kMinLoadThreads = 8;
+
+        std::string loadKey(const file::Path& path, const file::Path& audioPath)
+        {
+            return path.get() + "|" + audioPath.get();
+        }
+
+        //! Number of players kept for the files that were active before.
+        const size_t kPlayerPoolSize = 4;
+
+        //! Part of the cache shared by the kept players.
+        const double kPlayerPoolCacheShare = 0.25;
+
+        //! How often the changed files are re-read, in seconds.
+        const double kFileWatchTimeout = 0.5;
+
+        //! Whether a changed file is the file of a path, or any frame of it
+        //! if it is a sequence.
+        bool isSameFile(const file::Path& path, const file::Path& changed)
+        {
+            if (path.isEmpty() ||
+                path.getDirectory() != changed.getDirectory() ||
+                path.getBaseName() != changed.getBaseName() ||
+                path.getExtension() != changed.getExtension())
+                return false;
+            if (path.isSequence())
+                return !changed.getNumber().empty();
+            return path.getNumber() == changed.getNumber();
+        }
+
+        struct LoadJob
+        {
+            file::Path path;
+            file::Path audioPath;
+            timeline::Options options;
+            std::promise<std::shared_ptr<timeline::Timeline> > promise;
+        };
+    } // namespace
 
     struct Options
     {
@@ -151,6 +201,11 @@ namespace mrv
         timeline::OCIOOptions ocioOptions;
         timeline::LUTOptions lutOptions;
 
+        std::string outputFileName;
+        SaveOptions saveOptions;
+        int outputScale = 1;
+        int outputLayer = 0;
+
         bool hud = true;
         bool resetSettings = false;
         bool resetHotkeys = false;
@@ -183,6 +238,8 @@ namespace mrv
         std::unique_ptr<PythonArgs> pythonArgs;
 #endif
 
+        std::unique_ptr<RenderQueue> renderQueue;
+
         std::shared_ptr<PlaylistsModel> playlistsModel;
         std::shared_ptr<FilesModel> filesModel;
         std::vector<std::shared_ptr<FilesModelItem> > files;
@@ -216,6 +273,37 @@ namespace mrv
 
         bool session = false;
         bool running = false;
+
+        //! Players of the files that were active before, most recent
+        //! first.  They keep their caches, so switching back is instant.
+        std::list<std::pair<
+            std::shared_ptr<FilesModelItem>, std::shared_ptr<TimelinePlayer> > >
+            playerPool;
+
+        //! Paths of the files passed to prefetch().
+        std::map<std::string, std::vector<file::Path> > pendingPaths;
+
+        //! Timelines being created in the background, by loadKey().
+        std::map<
+            std::string, std::future<std::shared_ptr<timeline::Timeline> > >
+            pendingTimelines;
+
+        //! Watches the directories of the loaded files for changes.
+        std::unique_ptr<FileWatcher> fileWatcher;
+
+        //! Number of times each file changed on disk, by loadKey().  It is
+        //! passed to the readers, so the I/O cache does not return the old
+        //! frames.
+        std::map<std::string, int> fileRevisions;
+
+        //! Frames that changed on disk while their file had no player.
+        std::map<
+            std::shared_ptr<FilesModelItem>, std::vector<otime::RationalTime> >
+            staleFrames;
+
+        //! Background threads creating the timelines.  Keep it last, so they
+        //! are waited for first.
+        std::vector<std::future<void> > loadTasks;
     };
 
     ViewerUI* App::ui = nullptr;
@@ -245,6 +333,13 @@ namespace mrv
 #endif
         }
 
+        void file_watch_cb(App* app)
+        {
+            app->updateChangedFiles();
+            Fl::repeat_timeout(
+                kFileWatchTimeout, (Fl_Timeout_Handler)file_watch_cb, app);
+        }
+
     } // namespace
 
     App::App(
@@ -363,6 +458,106 @@ namespace mrv
                         _("LUT operation order."),
                         string::Format("{0}").arg(p.options.lutOptions.order),
                         string::join(timeline::getLUTOrderLabels(), ", ")),
+                    app::CmdLineValueOption<std::string>::create(
+                        p.options.outputFileName, {"-output", "-o"},
+                        _("Save the inputs to a movie, sequence or image "
+                          "without opening the main window and exit.  The "
+                          "-inOutRange, -ocio* and -lut options are applied.  "
+                          "It does not need a display.")),
+                    app::CmdLineValueOption<int>::create(
+                        p.options.outputScale, {"-outputScale"},
+                        _("Divide the resolution saved with -output by 1, 2 "
+                          "or 4."),
+                        string::Format("{0}").arg(p.options.outputScale),
+                        "1, 2, 4"),
+                    app::CmdLineValueOption<int>::create(
+                        p.options.outputLayer, {"-outputLayer"},
+                        _("Index of the video layer saved with -output."),
+                        string::Format("{0}").arg(p.options.outputLayer)),
+                    app::CmdLineValueOption<int>::create(
+                        p.options.saveOptions.zipCompressionLevel,
+                        {"-outputZipLevel"},
+                        _("ZIP compression level of the images saved with "
+                          "-output."),
+                        string::Format("{0}").arg(
+                            p.options.saveOptions.zipCompressionLevel)),
+                    app::CmdLineValueOption<float>::create(
+                        p.options.saveOptions.dwaCompressionLevel,
+                        {"-outputDWALevel"},
+                        _("DWA compression level of the images saved with "
+                          "-output."),
+                        string::Format("{0}").arg(
+                            p.options.saveOptions.dwaCompressionLevel)),
+#ifdef TLRENDER_FFMPEG
+                    app::CmdLineValueOption<ffmpeg::Profile>::create(
+                        p.options.saveOptions.ffmpegProfile,
+                        {"-outputProfile"},
+                        _("FFmpeg profile of the movie saved with -output."),
+                        string::Format("{0}").arg(
+                            p.options.saveOptions.ffmpegProfile),
+                        string::join(ffmpeg::getProfileLabels(), ", ")),
+                    app::CmdLineValueOption<std::string>::create(
+                        p.options.saveOptions.ffmpegPreset,
+                        {"-outputPreset"},
+                        _("FFmpeg preset file of the movie saved with "
+                          "-output.")),
+                    app::CmdLineValueOption<std::string>::create(
+                        p.options.saveOptions.ffmpegPixelFormat,
+                        {"-outputPixelFormat"},
+                        _("FFmpeg pixel format of the movie saved with "
+                          "-output."),
+                        p.options.saveOptions.ffmpegPixelFormat),
+                    app::CmdLineValueOption<ffmpeg::AudioCodec>::create(
+                        p.options.saveOptions.ffmpegAudioCodec,
+                        {"-outputAudioCodec"},
+                        _("FFmpeg audio codec of the movie saved with "
+                          "-output."),
+                        string::Format("{0}").arg(
+                            p.options.saveOptions.ffmpegAudioCodec),
+                        string::join(ffmpeg::getAudioCodecLabels(), ", ")),
+                    app::CmdLineFlagOption::create(
+                        p.options.saveOptions.ffmpegHardwareEncode,
+                        {"-outputHardwareEncode"},
+                        _("Use hardware encoding for the movie saved with "
+                          "-output.")),
+                    app::CmdLineValueOption<std::string>::create(
+                        p.options.saveOptions.ffmpegColorRange,
+                        {"-outputColorRange"},
+                        _("FFmpeg color range of the movie saved with "
+                          "-output.")),
+                    app::CmdLineValueOption<std::string>::create(
+                        p.options.saveOptions.ffmpegColorSpace,
+                        {"-outputColorSpace"},
+                        _("FFmpeg color space of the movie saved with "
+                          "-output.")),
+                    app::CmdLineValueOption<std::string>::create(
+                        p.options.saveOptions.ffmpegColorPrimaries,
+                        {"-outputColorPrimaries"},
+                        _("FFmpeg color primaries of the movie saved with "
+                          "-output.")),
+                    app::CmdLineValueOption<std::string>::create(
+                        p.options.saveOptions.ffmpegColorTRC,
+                        {"-outputColorTRC"},
+                        _("FFmpeg color transfer characteristics of the "
+                          "movie saved with -output.")),
+#endif
+#ifdef TLRENDER_EXR
+                    app::CmdLineValueOption<exr::Compression>::create(
+                        p.options.saveOptions.exrCompression,
+                        {"-outputCompression"},
+                        _("OpenEXR compression of the images saved with "
+                          "-output."),
+                        string::Format("{0}").arg(
+                            p.options.saveOptions.exrCompression),
+                        string::join(exr::getCompressionLabels(), ", ")),
+                    app::CmdLineValueOption<image::PixelType>::create(
+                        p.options.saveOptions.exrPixelType,
+                        {"-outputPixelType"},
+                        _("OpenEXR pixel type of the images saved with "
+                          "-output."),
+                        string::Format("{0}").arg(
+                            p.options.saveOptions.exrPixelType)),
+#endif
 #ifdef MRV2_PYBIND11
                     app::CmdLineValueOption<std::string>::create(
                         p.options.pythonScript, {"-pythonScript", "-ps"},
@@ -480,6 +675,14 @@ namespace mrv
             return;
         }
 
+        // Saving with -output does not create the interface, so it does not
+        // need a display.
+        if (isBatch())
+        {
+            _exit = _saveOutput();
+            return;
+        }
+
         // Initialize FLTK.
         Fl::scheme("gtk+");
         Fl::option(Fl::OPTION_VISIBLE_FOCUS, false);
@@ -646,6 +849,10 @@ namespace mrv
                     const std::vector< std::shared_ptr<FilesModelItem> >& value)
                 { _activeUpdate(value); });
 
+        p.fileWatcher = std::make_unique<FileWatcher>();
+        Fl::add_timeout(
+            kFileWatchTimeout, (Fl_Timeout_Handler)file_watch_cb, this);
+
         p.layersObserver = observer::ListObserver<int>::create(
             p.filesModel->observeLayers(),
             [this](const std::vector<int>& value) { _layersUpdate(value); });
@@ -774,6 +981,18 @@ namespace mrv
 
         if (!p.options.fileNames.empty())
         {
+            // The file with the audio is not prefetched.
+            std::vector<std::string> fileNames;
+            bool hasAudio = !p.options.audioFileName.empty();
+            for (const auto& fileName : p.options.fileNames)
+            {
+                if (hasAudio && file::isSequence(fileName))
+                    hasAudio = false;
+                else
+                    fileNames.push_back(fileName);
+            }
+            prefetch(fileNames);
+
             bool foundAudio = false;
             for (const auto& fileName : p.options.fileNames)
             {
@@ -880,6 +1099,13 @@ namespace mrv
             ui->uiSecondary->window()->show();
         }
 
+        _ocioOptionsFromCommandLine();
+    }
+
+    void App::_ocioOptionsFromCommandLine()
+    {
+        TLRENDER_P();
+
         try
         {
             if (!p.options.ocioOptions.input.empty())
@@ -902,6 +1128,141 @@ namespace mrv
         }
     }
 
+    int App::_saveOutput()
+    {
+        TLRENDER_P();
+
+        if (p.options.fileNames.empty())
+        {
+            std::cerr << _("Nothing to save.  Pass the inputs to save to "
+                           "-output.")
+                      << std::endl;
+            return 1;
+        }
+
+        const std::string& file = p.options.outputFileName;
+        const file::Path path(file);
+        const std::string extension = string::toLower(path.getExtension());
+        if (extension.empty())
+        {
+            std::cerr << _("File extension cannot be empty.") << std::endl;
+            return 1;
+        }
+
+        p.settings = new SettingsObject();
+        if (p.options.singleImages)
+            p.settings->setValue("Misc/MaxFileSequenceDigits", 0);
+        tcp = new DummyClient();
+
+        // Only the first input is saved.
+        std::shared_ptr<timeline::Player> player;
+        try
+        {
+            file::PathOptions pathOptions;
+            pathOptions.maxNumberDigits =
+                p.settings->getValue<int>("Misc/MaxFileSequenceDigits");
+            const auto& paths = timeline::getPaths(
+                file::Path(p.options.fileNames[0]), pathOptions, _context);
+            if (paths.empty())
+                throw std::runtime_error(
+                    string::Format(_("Filename '{0}' does not exist or does "
+                                     "not have read permissions."))
+                        .arg(p.options.fileNames[0]));
+
+            auto item = std::make_shared<FilesModelItem>();
+            item->path = paths[0];
+            item->audioPath = file::Path(p.options.audioFileName);
+
+            timeline::PlayerOptions playerOptions;
+            _playerOptions(playerOptions, item);
+            player = timeline::Player::create(
+                _createTimeline(item), _context, playerOptions);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+
+        if (p.options.speed > 0.0)
+            player->setSpeed(p.options.speed);
+        if (time::isValid(p.options.inOutRange))
+        {
+            player->setInOutRange(p.options.inOutRange);
+            player->seek(p.options.inOutRange.start_time());
+        }
+        if (time::isValid(p.options.seek))
+            player->seek(p.options.seek);
+
+        SaveSource source;
+        source.player = player;
+        source.videoLayer = p.options.outputLayer;
+        source.lutOptions = p.options.lutOptions;
+        source.ocioOptions = p.options.ocioOptions;
+        if (!source.ocioOptions.input.empty())
+        {
+            // Use the same config as the viewer: $OCIO, the preferences or
+            // the default one.
+            const char* var = fl_getenv("OCIO");
+            if (var && strlen(var) > 0)
+            {
+                source.ocioOptions.fileName = var;
+            }
+            else
+            {
+                Fl_Preferences base(
+                    prefspath().c_str(), "filmaura", "mrv2",
+                    (Fl_Preferences::Root)0);
+                Fl_Preferences gui(base, "ui");
+                Fl_Preferences view(gui, "view");
+                Fl_Preferences ocio(view, "ocio");
+                char config[2048];
+                ocio.get("config", config, "", 2048);
+                source.ocioOptions.fileName =
+                    strlen(config) > 0 ? config : ocio::ocioDefault;
+            }
+            source.ocioOptions.enabled = true;
+        }
+
+        LOG_INFO(std::string(
+            string::Format(_("Saving '{0}' without a window.")).arg(file)));
+
+        // Sequences, movies and audio are saved from the in/out range.
+        // Single images are saved from the current frame.
+        SaveOptions options = p.options.saveOptions;
+#ifdef TLRENDER_FFMPEG
+        options.ffmpegOverride = !options.ffmpegColorRange.empty() ||
+                                 !options.ffmpegColorSpace.empty() ||
+                                 !options.ffmpegColorPrimaries.empty() ||
+                                 !options.ffmpegColorTRC.empty();
+#endif
+        switch (p.options.outputScale)
+        {
+        case 2:
+            options.resolution = SaveResolution::kHalfSize;
+            break;
+        case 4:
+            options.resolution = SaveResolution::kQuarterSize;
+            break;
+        default:
+            options.resolution = SaveResolution::kSameSize;
+            break;
+        }
+
+        int ret;
+        if (file::isMovie(extension) || file::isAudio(extension) ||
+            !path.getNumber().empty())
+        {
+            ret = save_movie(file, source, options);
+        }
+        else
+        {
+            options.noRename = true;
+            ret = save_single_frame(file, source, options);
+        }
+        return ret == 0 ? 0 : 1;
+    }
+
     void App::cleanResources()
     {
         TLRENDER_P();
@@ -920,6 +1281,20 @@ namespace mrv
 #endif
         removeListener();
 
+        // Stop the background saves.
+        p.renderQueue.reset();
+
+        p.playerPool.clear();
+        p.staleFrames.clear();
+
+        Fl::remove_timeout((Fl_Timeout_Handler)file_watch_cb, this);
+        p.fileWatcher.reset();
+
+        // Wait for the timelines being created in the background.
+        p.loadTasks.clear();
+        p.pendingTimelines.clear();
+        p.pendingPaths.clear();
+
         delete ui;
         ui = nullptr;
 
@@ -947,6 +1322,14 @@ namespace mrv
         return _p->timeUnitsModel;
     }
 
+    RenderQueue* App::renderQueue()
+    {
+        TLRENDER_P();
+        if (!p.renderQueue)
+            p.renderQueue = std::make_unique<RenderQueue>();
+        return p.renderQueue.get();
+    }
+
     SettingsObject* App::settings() const
     {
         return _p->settings;
@@ -1151,11 +1534,25 @@ namespace mrv
         return _p->running;
     }
 
+    bool App::isBatch() const
+    {
+        return !_p->options.outputFileName.empty();
+    }
+
     void
     App::open(const std::string& fileName, const std::string& audioFileName)
     {
         TLRENDER_P();
 
+        // Paths found by prefetch(), if any.
+        std::vector<file::Path> paths;
+        auto i = p.pendingPaths.find(fileName);
+        if (i != p.pendingPaths.end())
+        {
+            paths = i->second;
+            p.pendingPaths.erase(i);
+        }
+
         file::Path filePath(fileName);
 
         if (filePath.getExtension() == ".mrv2s")
@@ -1179,13 +1576,35 @@ namespace mrv
             return;
         }
 
-        for (const auto& path :
-             timeline::getPaths(filePath, pathOptions, _context))
+        if (paths.empty())
+        {
+            paths = timeline::getPaths(filePath, pathOptions, _context);
+
+            // Create the timelines of a directory concurrently.
+            if (paths.size() > 1)
+                _loadTimelines(paths, file::Path(audioFileName));
+        }
+
+        for (const auto& path : paths)
         {
             auto item = std::make_shared<FilesModelItem>();
             item->path = path;
             item->audioPath = file::Path(audioFileName);
 
+            // Drop the timelines created for the path with another audio
+            // file, so a later open of the path does not pick them up.
+            const std::string& key = loadKey(item->path, item->audioPath);
+            const std::string& prefix = loadKey(item->path, file::Path());
+            for (auto j = p.pendingTimelines.lower_bound(prefix);
+                 j != p.pendingTimelines.end() &&
+                 j->first.compare(0, prefix.size(), prefix) == 0;)
+            {
+                if (j->first != key)
+                    j = p.pendingTimelines.erase(j);
+                else
+                    ++j;
+            }
+
             p.filesModel->add(item);
         }
 
@@ -1199,6 +1618,115 @@ namespace mrv
         }
     }
 
+    void App::prefetch(const std::vector<std::string>& fileNames)
+    {
+        TLRENDER_P();
+
+        if (fileNames.size() < 2)
+            return;
+
+        file::PathOptions pathOptions;
+        pathOptions.maxNumberDigits =
+            p.settings->getValue<int>("Misc/MaxFileSequenceDigits");
+
+        std::vector<file::Path> paths;
+        for (const auto& fileName : fileNames)
+        {
+            file::Path filePath(fileName);
+            if (filePath.getExtension() == ".mrv2s" ||
+                (!file::isDirectory(fileName) && !file::isReadable(fileName)))
+                continue;
+
+            try
+            {
+                const auto& filePaths =
+                    timeline::getPaths(filePath, pathOptions, _context);
+                p.pendingPaths[fileName] = filePaths;
+                paths.insert(paths.end(), filePaths.begin(), filePaths.end());
+            }
+            catch (const std::exception& e)
+            {
+                // open() will report the error.
+            }
+        }
+
+        _loadTimelines(paths, file::Path());
+    }
+
+    void App::_loadTimelines(
+        const std::vector<file::Path>& paths, const file::Path& audioPath)
+    {
+        TLRENDER_P();
+
+        auto jobs = std::make_shared<std::vector<LoadJob> >();
+        for (const auto& path : paths)
+        {
+            // USD files need the Python GIL released on the main thread
+            // (see _createTimeline()), so they are not created here.
+            if (file::isUSD(path))
+                continue;
+            const std::string& key = loadKey(path, audioPath);
+            if (p.pendingTimelines.count(key))
+                continue;
+            LoadJob job;
+            job.path = path;
+            job.audioPath = audioPath;
+            // The settings are not thread safe, so read them here.
+            job.options = _timelineOptions(path, audioPath);
+            p.pendingTimelines[key] = job.promise.get_future();
+            jobs->push_back(std::move(job));
+        }
+        if (jobs->empty())
+            return;
+
+        // Forget about the threads that are done.
+        p.loadTasks.erase(
+            std::remove_if(
+                p.loadTasks.begin(), p.loadTasks.end(),
+                [](const std::future<void>& task)
+                {
+                    return task.wait_for(std::chrono::seconds(0)) ==
+                           std::future_status::ready;
+                }),
+            p.loadTasks.end());
+
+        const auto context = _context;
+        auto next = std::make_shared<std::atomic<size_t> >(0);
+        const size_t threads = std::min(
+            jobs->size(),
+            std::max(kMinLoadThreads, static_cast<size_t>(cpu_count())));
+        for (size_t t = 0; t < threads; ++t)
+        {
+            p.loadTasks.push_back(std::async(
+                std::launch::async,
+                [jobs, next, context]
+                {
+                    size_t i;
+                    while ((i = (*next)++) < jobs->size())
+                    {
+                        auto& job = (*jobs)[i];
+                        try
+                        {
+                            auto otioTimeline =
+                                job.audioPath.isEmpty()
+                                    ? timeline::create(
+                                          job.path, context, job.options)
+                                    : timeline::create(
+                                          job.path, job.audioPath, context,
+                                          job.options);
+                            job.promise.set_value(timeline::Timeline::create(
+                                otioTimeline, context, job.options));
+                        }
+                        catch (...)
+                        {
+                            job.promise.set_exception(
+                                std::current_exception());
+                        }
+                    }
+                }));
+        }
+    }
+
     void App::openSeparateAudioDialog()
     {
         auto dialog = std::make_unique<OpenSeparateAudioDialog>(_context, ui);
@@ -1304,13 +1832,16 @@ namespace mrv
 
         out["SequenceIO/ThreadCount"] = string::Format("{0}").arg(
             p.settings->getValue<int>("SequenceIO/ThreadCount"));
-        out["SequenceIO/DefaultSpeed"] =
-            string::Format("{0}").arg(ui->uiPrefs->uiPrefsFPS->value());
-
+        // There is no interface when saving with -output.
+        if (ui)
+        {
+            out["SequenceIO/DefaultSpeed"] =
+                string::Format("{0}").arg(ui->uiPrefs->uiPrefsFPS->value());
 #if defined(TLRENDER_EXR)
-        out["OpenEXR/IgnoreDisplayWindow"] =
-            string::Format("{0}").arg(ui->uiView->getIgnoreDisplayWindow());
+            out["OpenEXR/IgnoreDisplayWindow"] = string::Format("{0}").arg(
+                ui->uiView->getIgnoreDisplayWindow());
 #endif
+        }
 #if defined(TLRENDER_EXR) || defined(TLRENDER_STB)
         out["AutoNormalize"] =
             string::Format("{0}").arg(p.displayOptions.normalize.enabled);
@@ -1328,9 +1859,12 @@ namespace mrv
         out["FFmpeg/ThreadCount"] = string::Format("{0}").arg(
             p.settings->getValue<int>("Performance/FFmpegThreadCount"));
 
-        TimelineClass* c = ui->uiTimeWindow;
-        int idx = c->uiAudioTracks->current_track();
-        out["FFmpeg/AudioTrack"] = string::Format("{0}").arg(idx);
+        if (ui)
+        {
+            TimelineClass* c = ui->uiTimeWindow;
+            int idx = c->uiAudioTracks->current_track();
+            out["FFmpeg/AudioTrack"] = string::Format("{0}").arg(idx);
+        }
 #endif // TLRENDER_FFMPEG
 
 #if defined(TLRENDER_USD)
@@ -1382,7 +1916,26 @@ namespace mrv
                 const auto& item = files[i];
                 try
                 {
-                    timelines[i] = _createTimeline(item);
+                    auto pending = p.pendingTimelines.find(
+                        loadKey(item->path, item->audioPath));
+                    if (pending != p.pendingTimelines.end())
+                    {
+                        // Take the future out first, so a failed timeline
+                        // is not left behind.
+                        auto future = std::move(pending->second);
+                        p.pendingTimelines.erase(pending);
+                        {
+#ifdef MRV2_PYBIND11
+                            py::gil_scoped_release release;
+#endif
+                            timelines[i] = future.get();
+                        }
+                        _openFileCallbacks(item);
+                    }
+                    else
+                    {
+                        timelines[i] = _createTimeline(item);
+                    }
                     const auto info = timelines[i]->getIOInfo();
                     for (const auto& video : info.video)
                     {
@@ -1399,9 +1952,68 @@ namespace mrv
         p.files = files;
         p.timelines = timelines;
 
+        // Drop the players of closed files.
+        p.playerPool.remove_if(
+            [&files](const auto& pooled)
+            {
+                return std::find(files.begin(), files.end(), pooled.first) ==
+                       files.end();
+            });
+        for (auto i = p.staleFrames.begin(); i != p.staleFrames.end();)
+        {
+            if (std::find(files.begin(), files.end(), i->first) == files.end())
+                i = p.staleFrames.erase(i);
+            else
+                ++i;
+        }
+
+        _watchFiles();
+
         panel::refreshThumbnails();
     }
 
+    void App::_poolPlayer(
+        const std::shared_ptr<FilesModelItem>& item,
+        const std::shared_ptr<TimelinePlayer>& player)
+    {
+        TLRENDER_P();
+
+        if (file::isTemporaryNDI(item->path) ||
+            std::find(p.files.begin(), p.files.end(), item) == p.files.end())
+            return;
+
+        // Stop it without sending it to the network, and keep it from
+        // updating the view.
+        player->player()->setPlayback(timeline::Playback::Stop);
+        player->setTimelineViewport(nullptr);
+
+        p.playerPool.remove_if([&item](const auto& pooled)
+                               { return pooled.first == item; });
+        p.playerPool.push_front(std::make_pair(item, player));
+        while (p.playerPool.size() > kPlayerPoolSize)
+            p.playerPool.pop_back();
+    }
+
+    std::shared_ptr<TimelinePlayer> App::_takePlayer(
+        const std::shared_ptr<FilesModelItem>& item,
+        const std::shared_ptr<timeline::Timeline>& timeline)
+    {
+        TLRENDER_P();
+
+        std::shared_ptr<TimelinePlayer> out;
+        auto i = std::find_if(
+            p.playerPool.begin(), p.playerPool.end(),
+            [&item](const auto& pooled) { return pooled.first == item; });
+        if (i != p.playerPool.end())
+        {
+            // EDLs and refreshed files get a new timeline.
+            if (i->second->timeline() == timeline)
+                out = i->second;
+            p.playerPool.erase(i);
+        }
+        return out;
+    }
+
     void App::_playerOptions(
         timeline::PlayerOptions& playerOptions,
         const std::shared_ptr<FilesModelItem>& item)
@@ -1417,8 +2029,8 @@ namespace mrv
             p.settings->getValue<int>("Performance/AudioBufferFrameCount");
     }
 
-    std::shared_ptr<timeline::Timeline>
-    App::_createTimeline(const std::shared_ptr<FilesModelItem>& item)
+    timeline::Options App::_timelineOptions(
+        const file::Path& path, const file::Path& audioPath) const
     {
         TLRENDER_P();
 
@@ -1440,6 +2052,21 @@ namespace mrv
         options.pathOptions.maxNumberDigits = std::min(
             p.settings->getValue<int>("Misc/MaxFileSequenceDigits"), 255);
 
+        // Files that changed on disk get new I/O cache keys.
+        const auto i = p.fileRevisions.find(loadKey(path, audioPath));
+        if (i != p.fileRevisions.end())
+            options.ioOptions["ClearCache"] =
+                string::Format("{0}").arg(i->second);
+
+        return options;
+    }
+
+    std::shared_ptr<timeline::Timeline>
+    App::_createTimeline(const std::shared_ptr<FilesModelItem>& item)
+    {
+        const timeline::Options options =
+            _timelineOptions(item->path, item->audioPath);
+
         otio::SerializableObject::Retainer<otio::Timeline> otioTimeline;
 
         if (file::isUSD(item->path))
@@ -1464,6 +2091,13 @@ namespace mrv
 
         auto out = timeline::Timeline::create(otioTimeline, _context, options);
 
+        _openFileCallbacks(item);
+        return out;
+    }
+
+    void
+    App::_openFileCallbacks(const std::shared_ptr<FilesModelItem>& item)
+    {
 #ifdef MRV2_PYBIND11
         const std::string& path = item->path.get();
         const std::string& audioPath = item->audioPath.get();
@@ -1472,7 +2106,188 @@ namespace mrv
             run_python_open_file_cb(pythonCb, path, audioPath);
         }
 #endif
-        return out;
+    }
+
+    void App::invalidateFile(const std::string& fileName, const bool allFrames)
+    {
+        std::vector<std::shared_ptr<FilesModelItem> > reloads;
+        const bool found = _invalidateFile(fileName, allFrames, reloads);
+        _reloadFiles(reloads);
+        if (found)
+            panel::redrawThumbnails(true);
+    }
+
+    bool App::isWatched(const std::string& fileName) const
+    {
+        TLRENDER_P();
+
+        if (!p.fileWatcher)
+            return false;
+        return p.fileWatcher->isWatching(file::Path(fileName).getDirectory());
+    }
+
+    void App::updateChangedFiles()
+    {
+        TLRENDER_P();
+
+        if (!p.fileWatcher)
+            return;
+
+        // Several frames of a sequence usually arrive in the same poll, so
+        // reload each file once at the end.
+        std::vector<std::shared_ptr<FilesModelItem> > reloads;
+        bool found = false;
+        for (const auto& fileName : p.fileWatcher->takeChanged())
+        {
+            if (_invalidateFile(fileName, false, reloads))
+                found = true;
+        }
+        _reloadFiles(reloads);
+        if (found)
+            panel::redrawThumbnails(true);
+    }
+
+    bool App::_invalidateFile(
+        const std::string& fileName, const bool allFrames,
+        std::vector<std::shared_ptr<FilesModelItem> >& reloads)
+    {
+        TLRENDER_P();
+
+        const file::Path changed(fileName);
+        bool found = false;
+        for (size_t i = 0; i < p.files.size(); ++i)
+        {
+            const auto& item = p.files[i];
+            if (!p.timelines[i] || file::isTemporaryEDL(item->path) ||
+                file::isTemporaryNDI(item->path))
+                continue;
+
+            if (isSameFile(item->audioPath, changed) ||
+                (isSameFile(item->path, changed) &&
+                 (allFrames || !item->path.isSequence())))
+            {
+                // The whole file changed, so its frames get new I/O cache
+                // keys.
+                ++p.fileRevisions[loadKey(item->path, item->audioPath)];
+                p.staleFrames.erase(item);
+                if (std::find(reloads.begin(), reloads.end(), item) ==
+                    reloads.end())
+                    reloads.push_back(item);
+                found = true;
+            }
+            else if (isSameFile(item->path, changed))
+            {
+                const auto& timeRange = p.timelines[i]->getTimeRange();
+                const otime::RationalTime time(
+                    std::atoi(changed.getNumber().c_str()),
+                    timeRange.duration().rate());
+                if (timeRange.contains(time))
+                {
+                    _updateFrame(item, time);
+                }
+                else if (
+                    std::find(reloads.begin(), reloads.end(), item) ==
+                    reloads.end())
+                {
+                    // A new frame, the frames already read are still good.
+                    reloads.push_back(item);
+                }
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    void App::_reloadFiles(
+        const std::vector<std::shared_ptr<FilesModelItem> >& items)
+    {
+        TLRENDER_P();
+
+        for (const auto& item : items)
+        {
+            // Look the file up again, as reloading the active file replaces
+            // the files.
+            const auto i = std::find(p.files.begin(), p.files.end(), item);
+            if (i != p.files.end())
+                _reloadFile(i - p.files.begin());
+        }
+    }
+
+    void App::_updateFrame(
+        const std::shared_ptr<FilesModelItem>& item,
+        const otime::RationalTime& time)
+    {
+        TLRENDER_P();
+
+        // Use the timeline::Player directly, as the other viewers in a
+        // network session watch their own files.
+        if (!p.activeFiles.empty() && p.activeFiles[0] == item && p.player)
+        {
+            p.player->player()->updateVideoCache(time);
+            return;
+        }
+
+        auto i = std::find_if(
+            p.playerPool.begin(), p.playerPool.end(),
+            [&item](const auto& pooled) { return pooled.first == item; });
+        if (i != p.playerPool.end())
+        {
+            i->second->player()->updateVideoCache(time);
+            return;
+        }
+
+        p.staleFrames[item].push_back(time);
+    }
+
+    void App::_reloadFile(const size_t index)
+    {
+        TLRENDER_P();
+
+        const auto item = p.files[index];
+        if (!p.activeFiles.empty() && p.activeFiles[0] == item && p.player)
+        {
+            // Same as File/Refresh Media, which keeps the current frame
+            // and playback.
+            refresh_media_cb(nullptr, nullptr);
+            return;
+        }
+
+        p.playerPool.remove_if([&item](const auto& pooled)
+                               { return pooled.first == item; });
+        try
+        {
+            p.timelines[index] = _createTimeline(item);
+        }
+        catch (const std::exception& e)
+        {
+            _log(e.what(), log::Type::Error);
+        }
+    }
+
+    void App::_watchFiles()
+    {
+        TLRENDER_P();
+
+        if (!p.fileWatcher)
+            return;
+
+        std::vector<std::string> directories;
+        for (const auto& item : p.files)
+        {
+            if (file::isTemporaryEDL(item->path) ||
+                file::isTemporaryNDI(item->path))
+                continue;
+
+            for (const auto& path : {item->path, item->audioPath})
+            {
+                const std::string& protocol = path.getProtocol();
+                if (path.isEmpty() || path.getDirectory().empty() ||
+                    (!protocol.empty() && protocol != "file://"))
+                    continue;
+                directories.push_back(path.getDirectory());
+            }
+        }
+        p.fileWatcher->setDirectories(directories);
     }
 
     void App::_activeUpdate(
@@ -1502,6 +2317,8 @@ namespace mrv
             }
             else
             {
+                if (!p.activeFiles.empty() && p.player)
+                    _poolPlayer(p.activeFiles[0], p.player);
 
                 auto i =
                     std::find(p.files.begin(), p.files.end(), activeFiles[0]);
@@ -1524,10 +2341,24 @@ namespace mrv
                         auto timeline = p.timelines[idx];
                         if (!timeline)
                             return;
-                        player.reset(new TimelinePlayer(
-                            timeline::Player::create(
-                                timeline, _context, playerOptions),
-                            _context));
+                        player = _takePlayer(item, timeline);
+                        if (!player)
+                        {
+                            player.reset(new TimelinePlayer(
+                                timeline::Player::create(
+                                    timeline, _context, playerOptions),
+                                _context));
+                        }
+
+                        // Re-read the frames that changed while the file
+                        // had no player.
+                        auto stale = p.staleFrames.find(item);
+                        if (stale != p.staleFrames.end())
+                        {
+                            for (const auto& time : stale->second)
+                                player->player()->updateVideoCache(time);
+                            p.staleFrames.erase(stale);
+                        }
 
                         item->timeRange = player->timeRange();
                         item->ioInfo = player->ioInfo();
@@ -1616,7 +2447,8 @@ namespace mrv
                 if (j != p.files.end())
                 {
                     auto timeline = p.timelines[j - p.files.begin()];
-                    auto info = timeline->getIOInfo();
+                    if (!timeline)
+                        continue;
                     compare.push_back(timeline);
                 }
             }
@@ -1740,6 +2572,23 @@ namespace mrv
             }
         }
 
+        // The warm players keep part of the cache, so switching back to
+        // them is instant.
+        const double poolShare =
+            p.playerPool.empty() ? 0.0 : kPlayerPoolCacheShare;
+        p.player->setCacheOptions(_cacheOptions(p.player, 1.0 - poolShare));
+        for (const auto& pooled : p.playerPool)
+        {
+            pooled.second->setCacheOptions(_cacheOptions(
+                pooled.second, poolShare / p.playerPool.size()));
+        }
+    }
+
+    timeline::PlayerCacheOptions App::_cacheOptions(
+        const std::shared_ptr<TimelinePlayer>& player, const double share) const
+    {
+        TLRENDER_P();
+
         uint64_t Gbytes =
             static_cast<uint64_t>(p.settings->getValue<int>("Cache/GBytes"));
 
@@ -1747,7 +2596,7 @@ namespace mrv
         options.readAhead = _cacheReadAhead();
         options.readBehind = _cacheReadBehind();
 
-        const auto& info = p.player->ioInfo();
+        const auto& info = player->ioInfo();
 
         bool movieIsLong = false;
         if (info.audio.trackCount > 1)
@@ -1755,12 +2604,12 @@ namespace mrv
             // If movie is longer than 30 minutes, and has multiple audio tracks
             // use a short readAhead/readBehind so we can quickly switch among
             // them.
-            const auto& timeRange = p.player->inOutRange();
+            const auto& timeRange = player->inOutRange();
             if (timeRange.duration().to_seconds() > 60 * 30)
                 movieIsLong = true;
         }
 
-        if (file::isTemporaryNDI(p.player->path()) || movieIsLong)
+        if (file::isTemporaryNDI(player->path()) || movieIsLong)
         {
             options.readAhead = otime::RationalTime(4.0, 1.0);
             options.readBehind = otime::RationalTime(0.0, 1.0);
@@ -1789,15 +2638,21 @@ namespace mrv
 
             uint64_t bytes = Gbytes * memory::gigabyte;
 
-            // Update the I/O cache.
+            // Update the I/O cache.  It is shared by all the players and
+            // keeps the full size: the kept players only read their own
+            // part below, and evicting I/O cache entries of the active
+            // file does not drop the frames cached by its player.
             auto ioSystem = _context->getSystem<io::System>();
             ioSystem->getCache()->setMax(bytes);
 
+            // This player's part of the cache.
+            bytes = static_cast<uint64_t>(bytes * share);
+
             // old readAhead/readBehind code used when playing sequences.
-            const auto timeline = p.player->timeline();
+            const auto timeline = player->timeline();
             const auto ioInfo = timeline->getIOInfo();
 
-            const auto path = p.player->path();
+            const auto path = player->path();
             const bool isSequence = file::isSequence(path.get());
             if (isSequence)
             {
@@ -1807,7 +2662,7 @@ namespace mrv
                     const auto& video = ioInfo.video[0];
                     std::size_t size = tl::image::getDataByteCount(video);
                     double frames = bytes / static_cast<double>(size);
-                    seconds = frames / p.player->defaultSpeed();
+                    seconds = frames / player->defaultSpeed();
                 }
 
                 if (ioInfo.audio.isValid())
@@ -1839,9 +2694,16 @@ namespace mrv
                 options.readAhead = otime::RationalTime(readAhead, 1.0);
                 options.readBehind = otime::RationalTime(readBehind, 1.0);
             }
+            else if (share < 1.0)
+            {
+                options.readAhead = otime::RationalTime(
+                    options.readAhead.to_seconds() * share, 1.0);
+                options.readBehind = otime::RationalTime(
+                    options.readBehind.to_seconds() * share, 1.0);
+            }
         }
 
-        p.player->setCacheOptions(options);
+        return options;
     }
 
     void App::_audioUpdate()
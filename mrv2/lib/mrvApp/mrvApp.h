@@ -7,6 +7,7 @@
 #include <tlBaseApp/BaseApp.h>
 
 #include <tlTimeline/PlayerOptions.h>
+#include <tlTimeline/Timeline.h>
 #include <tlTimeline/IRender.h>
 #include <tlTimeline/TimeUnits.h>
 
@@ -33,7 +34,9 @@ namespace mrv
     class DevicesModel;
     class FilesModel;
     class PlaylistsModel;
+    class RenderQueue;
     class SettingsObject;
+    class TimelinePlayer;
 
     //! Application.
     class App : public tl::app::BaseApp
@@ -75,6 +78,9 @@ namespace mrv
         //! Get the devices model.
         const std::shared_ptr<DevicesModel>& devicesModel() const;
 
+        //! Get the queue of background saves, creating it if needed.
+        RenderQueue* renderQueue();
+
         //! Create a new application.
         static std::shared_ptr<App>
         create(int argc, char* argv[], const std::shared_ptr<system::Context>&);
@@ -85,6 +91,10 @@ namespace mrv
         //! Whether FLTK is running.
         bool isRunning() const;
 
+        //! Whether the inputs are being saved with -output, without
+        //! showing the main window.
+        bool isBatch() const;
+
     public:
 #ifdef MRV2_PYBIND11
         const std::vector<std::string>& getPythonArgs() const;
@@ -93,6 +103,11 @@ namespace mrv
         //! Open a file (with optional audio) or directory.
         void open(const std::string&, const std::string& = std::string());
 
+        //! Start creating the timelines of several files in background
+        //! threads, so the open() calls that follow do not probe them one
+        //! after the other.
+        void prefetch(const std::vector<std::string>& fileNames);
+
         //! Open a file dialog.
         void openDialog();
 
@@ -161,6 +176,19 @@ namespace mrv
         //! with a string, but I think it is simpler to make it public).
         void cacheUpdate();
 
+        //! Re-read a file that changed on disk, dropping only its frames
+        //! from the caches.  For a frame of a sequence, only that frame is
+        //! re-read, unless allFrames is true.
+        void invalidateFile(
+            const std::string& fileName, const bool allFrames = false);
+
+        //! Returns true if the file watcher reports the changes of the
+        //! file, so it does not need to be invalidated by hand.
+        bool isWatched(const std::string& fileName) const;
+
+        //! Re-read the files the file watcher saw change.  FLTK callback.
+        void updateChangedFiles();
+
     public:
         static ViewerUI* ui;
         static App* app;
@@ -173,6 +201,20 @@ namespace mrv
         otime::RationalTime _cacheReadAhead() const;
         otime::RationalTime _cacheReadBehind() const;
 
+        //! Cache options of a player using a share of the cache.
+        timeline::PlayerCacheOptions _cacheOptions(
+            const std::shared_ptr<TimelinePlayer>&, const double share) const;
+
+        //! Keep the player of a file that is no longer active.
+        void _poolPlayer(
+            const std::shared_ptr<FilesModelItem>&,
+            const std::shared_ptr<TimelinePlayer>&);
+
+        //! Take the kept player of a file, if it still plays the timeline.
+        std::shared_ptr<TimelinePlayer> _takePlayer(
+            const std::shared_ptr<FilesModelItem>&,
+            const std::shared_ptr<timeline::Timeline>&);
+
         void _filesUpdate(const std::vector<std::shared_ptr<FilesModelItem> >&);
 
         void
@@ -182,13 +224,50 @@ namespace mrv
 
         void _audioUpdate();
 
+        timeline::Options _timelineOptions(
+            const file::Path& path, const file::Path& audioPath) const;
+
         std::shared_ptr<timeline::Timeline>
         _createTimeline(const std::shared_ptr<FilesModelItem>& item);
 
+        //! Create the timelines of several paths in background threads.
+        void _loadTimelines(
+            const std::vector<file::Path>& paths, const file::Path& audioPath);
+
+        void _openFileCallbacks(const std::shared_ptr<FilesModelItem>& item);
+
+        //! Returns true if the file is one of the loaded files.  The files
+        //! to reload are added to reloads.
+        bool _invalidateFile(
+            const std::string& fileName, const bool allFrames,
+            std::vector<std::shared_ptr<FilesModelItem> >& reloads);
+
+        //! Re-read a frame of a file, now or when it gets a player.
+        void _updateFrame(
+            const std::shared_ptr<FilesModelItem>&,
+            const otime::RationalTime&);
+
+        //! Create the timeline of a file again.
+        void _reloadFile(const size_t index);
+
+        //! Create the timelines of the files again, if still loaded.
+        void _reloadFiles(
+            const std::vector<std::shared_ptr<FilesModelItem> >& items);
+
+        //! Watch the directories of the loaded files.
+        void _watchFiles();
+
         void _playerOptions(
             timeline::PlayerOptions& playerOptions,
             const std::shared_ptr<FilesModelItem>& item);
 
+        //! Apply the OpenColorIO options given in the command-line.
+        void _ocioOptionsFromCommandLine();
+
+        //! Save the inputs to the -output file without showing the main
+        //! window.  Returns the exit code.
+        int _saveOutput();
+
         TLRENDER_PRIVATE();
     };
 } // namespace mrv
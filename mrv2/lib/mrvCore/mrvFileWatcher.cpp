@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// mrv2
+// Copyright Contributors to the mrv2 Project. All rights reserved.
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#ifdef __linux__
+#    include <poll.h>
+#    include <sys/inotify.h>
+#    include <unistd.h>
+#endif
+
+#include "mrvCore/mrvFileWatcher.h"
+
+namespace mrv
+{
+
+    struct FileWatcher::Private
+    {
+        std::mutex mutex;
+        std::set<std::string> changed;
+
+#ifdef __linux__
+        void run();
+
+        int fd = -1;
+        std::atomic<bool> running = false;
+        std::thread thread;
+
+        // Protected by the mutex.
+        std::map<std::string, int> watches;
+        std::map<int, std::string> directories;
+#endif
+    };
+
+#ifdef __linux__
+    void FileWatcher::Private::run()
+    {
+        alignas(struct inotify_event) char buf[16384];
+        struct pollfd pfd = {fd, POLLIN, 0};
+        while (running)
+        {
+            // Time out so the thread notices when it has to stop.
+            if (poll(&pfd, 1, 250) <= 0)
+                continue;
+
+            const ssize_t length = read(fd, buf, sizeof(buf));
+            if (length <= 0)
+                continue;
+
+            std::lock_guard lk(mutex);
+            for (char* ptr = buf; ptr < buf + length;)
+            {
+                const auto event =
+                    reinterpret_cast<const struct inotify_event*>(ptr);
+                ptr += sizeof(struct inotify_event) + event->len;
+                if (event->len == 0 || (event->mask & IN_ISDIR))
+                    continue;
+                auto i = directories.find(event->wd);
+                if (i == directories.end())
+                    continue;
+                changed.insert(i->second + event->name);
+            }
+        }
+    }
+#endif
+
+    FileWatcher::FileWatcher() :
+        _p(new Private)
+    {
+#ifdef __linux__
+        TLRENDER_P();
+
+        p.fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (p.fd < 0)
+            return;
+        p.running = true;
+        p.thread = std::thread([this] { _p->run(); });
+#endif
+    }
+
+    FileWatcher::~FileWatcher()
+    {
+#ifdef __linux__
+        TLRENDER_P();
+
+        p.running = false;
+        if (p.thread.joinable())
+            p.thread.join();
+        if (p.fd >= 0)
+            close(p.fd);
+#endif
+    }
+
+    void FileWatcher::setDirectories(const std::vector<std::string>& values)
+    {
+#ifdef __linux__
+        TLRENDER_P();
+
+        if (p.fd < 0)
+            return;
+
+        const std::set<std::string> wanted(values.begin(), values.end());
+
+        std::lock_guard lk(p.mutex);
+        for (auto i = p.watches.begin(); i != p.watches.end();)
+        {
+            if (wanted.count(i->first))
+            {
+                ++i;
+                continue;
+            }
+            inotify_rm_watch(p.fd, i->second);
+            p.directories.erase(i->second);
+            i = p.watches.erase(i);
+        }
+
+        for (const auto& directory : wanted)
+        {
+            if (p.watches.count(directory))
+                continue;
+
+            // Only report files once they are complete: either closed
+            // after writing or renamed into place.
+            const int wd = inotify_add_watch(
+                p.fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+            if (wd < 0)
+                continue;
+            p.watches[directory] = wd;
+            p.directories[wd] = directory;
+        }
+#endif
+    }
+
+    bool FileWatcher::isWatching(const std::string& directory) const
+    {
+#ifdef __linux__
+        TLRENDER_P();
+
+        std::lock_guard lk(p.mutex);
+        return p.watches.count(directory) > 0;
+#else
+        return false;
+#endif
+    }
+
+    std::vector<std::string> FileWatcher::takeChanged()
+    {
+        TLRENDER_P();
+
+        std::lock_guard lk(p.mutex);
+        std::vector<std::string> out(p.changed.begin(), p.changed.end());
+        p.changed.clear();
+        return out;
+    }
+
+} // namespace mrv
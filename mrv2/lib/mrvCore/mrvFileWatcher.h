@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// mrv2
+// Copyright Contributors to the mrv2 Project. All rights reserved.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <tlCore/Util.h>
+
+namespace mrv
+{
+
+    /**
+     * Watches directories for files that get written or moved into them,
+     * in a background thread.  It uses inotify on Linux and does nothing
+     * on other platforms.
+     */
+    class FileWatcher
+    {
+    public:
+        FileWatcher();
+        ~FileWatcher();
+
+        //! Set the directories to watch (with a trailing slash).
+        void setDirectories(const std::vector<std::string>& directories);
+
+        //! Returns true if the directory (with a trailing slash) is
+        //! watched.
+        bool isWatching(const std::string& directory) const;
+
+        //! Return the full paths of the files that changed since the
+        //! last call, without duplicates.
+        std::vector<std::string> takeChanged();
+
+    private:
+        TLRENDER_PRIVATE();
+    };
+
+} // namespace mrv
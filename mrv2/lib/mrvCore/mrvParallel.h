@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// mrv2
+// Copyright Contributors to the mrv2 Project. All rights reserved.
+
+#pragma once
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "mrvCore/mrvCPU.h"
+
+namespace mrv
+{
+
+    /**
+     * Return the number of chunks parallel_for will split a range in.
+     *
+     * @param size     size of the range.
+     * @param minChunk minimum number of elements of a chunk.
+     *
+     * @return number of chunks (at least 1).
+     */
+    inline int parallel_chunks(const int size, const int minChunk = 64)
+    {
+        static const int threads = std::max(1U, cpu_count());
+        const int chunks = std::min(threads, size / std::max(1, minChunk));
+        return std::max(1, chunks);
+    }
+
+    /**
+     * Split the range [begin, end) in parallel_chunks() chunks and call
+     * func(chunk, chunkBegin, chunkEnd) for each one of them in its own
+     * thread.  The first chunk runs in the calling thread.  Blocks until
+     * all chunks are done.
+     *
+     * @param begin    start of the range.
+     * @param end      end of the range (not included).
+     * @param func     function to call for each chunk.
+     * @param minChunk minimum number of elements of a chunk.
+     */
+    template < typename F >
+    inline void parallel_for(
+        const int begin, const int end, F&& func, const int minChunk = 64)
+    {
+        const int size = end - begin;
+        if (size <= 0)
+            return;
+
+        const int chunks = parallel_chunks(size, minChunk);
+        if (chunks == 1)
+        {
+            func(0, begin, end);
+            return;
+        }
+
+        const int chunkSize = (size + chunks - 1) / chunks;
+        std::vector<std::thread> threads;
+        threads.reserve(chunks - 1);
+        for (int i = 1; i < chunks; ++i)
+        {
+            const int chunkBegin = begin + i * chunkSize;
+            const int chunkEnd = std::min(end, chunkBegin + chunkSize);
+            if (chunkBegin >= chunkEnd)
+                break;
+            threads.emplace_back(
+                [&func, i, chunkBegin, chunkEnd]
+                { func(i, chunkBegin, chunkEnd); });
+        }
+
+        func(0, begin, std::min(end, begin + chunkSize));
+
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+} // namespace mrv
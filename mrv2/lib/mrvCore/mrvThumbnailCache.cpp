@@ -0,0 +1,475 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// mrv2
+// Copyright Contributors to the mrv2 Project. All rights reserved.
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <filesystem>
+namespace fs = std::filesystem;
+
+#include <FL/Fl_RGB_Image.H>
+
+#include "mrvCore/mrvHome.h"
+#include "mrvCore/mrvThumbnailCache.h"
+
+namespace mrv
+{
+    namespace thumbnail
+    {
+        namespace
+        {
+            const char kMagic[4] = {'M', 'R', 'V', 'T'};
+            const uint32_t kVersion = 1;
+            const int kDepth = 4;
+            const char* kExtension = ".thumb";
+
+            //! Stable 64-bit FNV-1a hash, used for the cache file names.
+            uint64_t hashKey(const std::string& key)
+            {
+                uint64_t out = 14695981039346656037ULL;
+                for (const unsigned char c : key)
+                {
+                    out ^= c;
+                    out *= 1099511628211ULL;
+                }
+                return out;
+            }
+
+            std::string cacheDirectory()
+            {
+                return prefspath() + "thumbnails/";
+            }
+
+            std::string cacheFile(const std::string& key)
+            {
+                char buf[32];
+                snprintf(
+                    buf, sizeof(buf), "%016llx",
+                    static_cast<unsigned long long>(hashKey(key)));
+                return cacheDirectory() + buf + kExtension;
+            }
+
+            template <typename T> void writeValue(std::ofstream& s, T value)
+            {
+                s.write(reinterpret_cast<const char*>(&value), sizeof(T));
+            }
+
+            template <typename T> bool readValue(std::ifstream& s, T& value)
+            {
+                s.read(reinterpret_cast<char*>(&value), sizeof(T));
+                return s.good();
+            }
+
+            //! Background writer and LRU index of the on-disk thumbnails.
+            class DiskCache
+            {
+            public:
+                ~DiskCache();
+
+                void write(
+                    const std::string& key, int w, int h,
+                    const std::shared_ptr<std::vector<uint8_t> >& pixels);
+                void touch(const std::string& key);
+                void clear();
+
+                std::atomic<uint64_t> maxBytes = 256 * 1024 * 1024;
+
+            private:
+                enum class Op { Write, Touch, Clear };
+
+                struct Item
+                {
+                    Op op;
+                    std::string key;
+                    int w = 0;
+                    int h = 0;
+                    std::shared_ptr<std::vector<uint8_t> > pixels;
+                };
+
+                struct Entry
+                {
+                    uint64_t bytes = 0;
+                    std::list<std::string>::iterator lru;
+                };
+
+                void _push(Item&& item);
+                void _run();
+                void _scan();
+                void _write(const Item&);
+                void _touch(const std::string& fileName);
+                void _clear();
+                void _add(const std::string& fileName, uint64_t bytes);
+                void _evict();
+
+                std::mutex mutex;
+                std::condition_variable condition;
+                std::deque<Item> items;
+                bool stopped = false;
+                std::thread thread;
+
+                // Only accessed from the writer thread.
+                std::list<std::string> lru; // most recently used first
+                std::unordered_map<std::string, Entry> entries;
+                uint64_t totalBytes = 0;
+            };
+
+            DiskCache diskCache;
+
+            DiskCache::~DiskCache()
+            {
+                {
+                    std::lock_guard lk(mutex);
+                    stopped = true;
+                }
+                condition.notify_one();
+                if (thread.joinable())
+                    thread.join();
+            }
+
+            void DiskCache::write(
+                const std::string& key, int w, int h,
+                const std::shared_ptr<std::vector<uint8_t> >& pixels)
+            {
+                _push({Op::Write, key, w, h, pixels});
+            }
+
+            void DiskCache::touch(const std::string& key)
+            {
+                _push({Op::Touch, key});
+            }
+
+            void DiskCache::clear()
+            {
+                {
+                    std::lock_guard lk(mutex);
+                    items.clear();
+                }
+                _push({Op::Clear});
+            }
+
+            void DiskCache::_push(Item&& item)
+            {
+                {
+                    std::lock_guard lk(mutex);
+                    if (stopped)
+                        return;
+                    if (!thread.joinable())
+                        thread = std::thread([this] { _run(); });
+                    items.push_back(std::move(item));
+                }
+                condition.notify_one();
+            }
+
+            void DiskCache::_run()
+            {
+                _scan();
+                while (true)
+                {
+                    Item item;
+                    {
+                        std::unique_lock lk(mutex);
+                        condition.wait(
+                            lk, [this] { return !items.empty() || stopped; });
+                        if (items.empty())
+                            break;
+                        item = std::move(items.front());
+                        items.pop_front();
+                    }
+
+                    switch (item.op)
+                    {
+                    case Op::Write:
+                        _write(item);
+                        break;
+                    case Op::Touch:
+                        _touch(cacheFile(item.key));
+                        break;
+                    case Op::Clear:
+                        _clear();
+                        break;
+                    }
+                }
+            }
+
+            //! Build the LRU index from the files already on disk, using
+            //! their modification time as the last use.
+            void DiskCache::_scan()
+            {
+                std::error_code ec;
+                const fs::path dir = cacheDirectory();
+                fs::create_directories(dir, ec);
+
+                std::vector<std::pair<fs::file_time_type, fs::path> > files;
+                for (const auto& entry : fs::directory_iterator(dir, ec))
+                {
+                    if (!entry.is_regular_file(ec) ||
+                        entry.path().extension() != kExtension)
+                        continue;
+                    files.push_back({entry.last_write_time(ec), entry.path()});
+                }
+                std::sort(
+                    files.begin(), files.end(),
+                    [](const auto& a, const auto& b)
+                    { return a.first < b.first; });
+                for (const auto& file : files)
+                {
+                    const auto bytes = fs::file_size(file.second, ec);
+                    if (!ec)
+                        _add(
+                            cacheDirectory() + file.second.filename().string(),
+                            bytes);
+                }
+                _evict();
+            }
+
+            void DiskCache::_write(const Item& item)
+            {
+                const std::string fileName = cacheFile(item.key);
+                const std::string tmpName = fileName + ".tmp";
+                {
+                    std::ofstream s(tmpName, std::ios::binary);
+                    if (!s.is_open())
+                        return;
+                    s.write(kMagic, sizeof(kMagic));
+                    writeValue<uint32_t>(s, kVersion);
+                    writeValue<uint32_t>(s, item.key.size());
+                    s.write(item.key.data(), item.key.size());
+                    writeValue<uint32_t>(s, item.w);
+                    writeValue<uint32_t>(s, item.h);
+                    s.write(
+                        reinterpret_cast<const char*>(item.pixels->data()),
+                        item.pixels->size());
+                    s.close();
+                    if (!s.good())
+                    {
+                        // Like a full disk.
+                        std::error_code ec;
+                        fs::remove(tmpName, ec);
+                        return;
+                    }
+                }
+
+                // Rename so readers never see a partially written file.
+                std::error_code ec;
+                fs::rename(tmpName, fileName, ec);
+                if (ec)
+                {
+                    fs::remove(tmpName, ec);
+                    return;
+                }
+
+                const auto bytes = fs::file_size(fileName, ec);
+                if (ec)
+                    return;
+                _add(fileName, bytes);
+                _evict();
+            }
+
+            void DiskCache::_touch(const std::string& fileName)
+            {
+                auto i = entries.find(fileName);
+                if (i == entries.end())
+                    return;
+                lru.splice(lru.begin(), lru, i->second.lru);
+
+                std::error_code ec;
+                fs::last_write_time(
+                    fileName, fs::file_time_type::clock::now(), ec);
+            }
+
+            void DiskCache::_clear()
+            {
+                std::error_code ec;
+                for (const auto& fileName : lru)
+                    fs::remove(fileName, ec);
+                lru.clear();
+                entries.clear();
+                totalBytes = 0;
+            }
+
+            void DiskCache::_add(const std::string& fileName, uint64_t bytes)
+            {
+                auto i = entries.find(fileName);
+                if (i != entries.end())
+                {
+                    totalBytes -= i->second.bytes;
+                    lru.erase(i->second.lru);
+                    entries.erase(i);
+                }
+                lru.push_front(fileName);
+                entries[fileName] = {bytes, lru.begin()};
+                totalBytes += bytes;
+            }
+
+            void DiskCache::_evict()
+            {
+                std::error_code ec;
+                const uint64_t max = maxBytes;
+                while (totalBytes > max && !lru.empty())
+                {
+                    const std::string fileName = lru.back();
+                    lru.pop_back();
+                    auto i = entries.find(fileName);
+                    totalBytes -= i->second.bytes;
+                    entries.erase(i);
+                    fs::remove(fileName, ec);
+                }
+            }
+        } // namespace
+
+        std::string cacheKey(
+            const file::Path& path, const int height,
+            const otime::RationalTime& time, const int layer)
+        {
+            const std::string& protocol = path.getProtocol();
+            if (path.isEmpty() || (!protocol.empty() && protocol != "file://"))
+                return std::string();
+
+            std::error_code ec;
+
+            // For sequences, stat the frame that gets decoded, so a frame
+            // that is rendered again gets a new key.
+            fs::path file = path.get();
+            if (path.isSequence() && time::isValid(time))
+            {
+                const fs::path frameFile =
+                    path.get(static_cast<int>(std::round(time.value())));
+                if (fs::exists(frameFile, ec))
+                    file = frameFile;
+            }
+
+            const auto mtime = fs::last_write_time(file, ec);
+            if (ec)
+                return std::string();
+            const auto size = fs::file_size(file, ec);
+            if (ec)
+                return std::string();
+
+            // Frames added to or removed from a sequence change the
+            // directory, not the file we stat.
+            int64_t dirTime = 0;
+            if (path.isSequence())
+            {
+                const auto dtime =
+                    fs::last_write_time(path.getDirectory(), ec);
+                if (!ec)
+                    dirTime = dtime.time_since_epoch().count();
+            }
+
+            std::stringstream s;
+            s << path.get() << '|' << mtime.time_since_epoch().count() << '|'
+              << dirTime << '|' << size << '|';
+            if (time::isValid(time))
+                s << time.value() << '/' << time.rate();
+            else
+                s << "none";
+            s << '|' << layer << '|' << height;
+            return s.str();
+        }
+
+        Fl_RGB_Image* cachedImage(const std::string& key)
+        {
+            if (key.empty())
+                return nullptr;
+
+            std::ifstream s(cacheFile(key), std::ios::binary);
+            if (!s.is_open())
+                return nullptr;
+
+            char magic[sizeof(kMagic)];
+            s.read(magic, sizeof(magic));
+            uint32_t version = 0, keySize = 0;
+            if (!s.good() || memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+                !readValue(s, version) || version != kVersion ||
+                !readValue(s, keySize) || keySize != key.size())
+                return nullptr;
+
+            // Guard against hash collisions.
+            std::string fileKey(keySize, '\0');
+            s.read(fileKey.data(), keySize);
+            if (!s.good() || fileKey != key)
+                return nullptr;
+
+            uint32_t w = 0, h = 0;
+            if (!readValue(s, w) || !readValue(s, h) || w == 0 || h == 0 ||
+                w > 4096 || h > 4096)
+                return nullptr;
+
+            const size_t bytes = static_cast<size_t>(w) * h * kDepth;
+            uint8_t* pixelData = new uint8_t[bytes];
+            s.read(reinterpret_cast<char*>(pixelData), bytes);
+            if (static_cast<size_t>(s.gcount()) != bytes)
+            {
+                delete[] pixelData;
+                return nullptr;
+            }
+
+            auto rgbImage = new Fl_RGB_Image(pixelData, w, h, kDepth);
+            rgbImage->alloc_array = true;
+
+            diskCache.touch(key);
+            return rgbImage;
+        }
+
+        Fl_RGB_Image* storeImage(
+            const std::string& key, const std::shared_ptr<image::Image>& image)
+        {
+            if (!image || image::PixelType::RGBA_U8 != image->getPixelType())
+                return nullptr;
+
+            const int w = image->getWidth();
+            const int h = image->getHeight();
+            const size_t stride = static_cast<size_t>(w) * kDepth;
+
+            uint8_t* pixelData = new uint8_t[stride * h];
+
+            auto rgbImage = new Fl_RGB_Image(pixelData, w, h, kDepth);
+            rgbImage->alloc_array = true;
+
+            uint8_t* d = pixelData;
+            const uint8_t* s = image->getData();
+            for (int y = 0; y < h; ++y)
+            {
+                memcpy(d + (h - 1 - y) * stride, s + y * stride, stride);
+            }
+
+            if (!key.empty())
+            {
+                auto pixels = std::make_shared<std::vector<uint8_t> >(
+                    pixelData, pixelData + stride * h);
+                diskCache.write(key, w, h, pixels);
+            }
+
+            return rgbImage;
+        }
+
+        void setCacheSize(const int megabytes)
+        {
+            diskCache.maxBytes =
+                static_cast<uint64_t>(std::max(megabytes, 0)) * 1024 * 1024;
+        }
+
+        int cacheSize()
+        {
+            return static_cast<int>(diskCache.maxBytes / (1024 * 1024));
+        }
+
+        void clearCache()
+        {
+            diskCache.clear();
+        }
+
+    } // namespace thumbnail
+} // namespace mrv
@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// mrv2
+// Copyright Contributors to the mrv2 Project. All rights reserved.
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <tlCore/Image.h>
+#include <tlCore/Path.h>
+#include <tlCore/Time.h>
+
+class Fl_RGB_Image;
+
+namespace mrv
+{
+    namespace thumbnail
+    {
+        using namespace tl;
+
+        /**
+         * Return the persistent cache key of a thumbnail.  The key includes
+         * the modification time and size of the file on disk (for
+         * sequences, of the frame at time), so a file that gets overwritten
+         * gets a new key.
+         *
+         * @param path media path.
+         * @param height thumbnail height.
+         * @param time requested time (can be invalid).
+         * @param layer video layer.
+         *
+         * @return the key or an empty string if the path cannot be cached
+         *         (URLs, missing files, etc).
+         */
+        std::string cacheKey(
+            const file::Path& path, const int height,
+            const otime::RationalTime& time, const int layer = 0);
+
+        /**
+         * Load a thumbnail from the persistent cache.
+         *
+         * @param key key returned by cacheKey().
+         *
+         * @return a new Fl_RGB_Image (owned by the caller) or nullptr if the
+         *         thumbnail is not in the cache.
+         */
+        Fl_RGB_Image* cachedImage(const std::string& key);
+
+        /**
+         * Convert an RGBA_U8 thumbnail from ui::ThumbnailSystem to an
+         * Fl_RGB_Image, flipping it vertically.  If key is not empty, the
+         * flipped pixels are also written to the persistent cache in a
+         * background thread.
+         *
+         * @param key key returned by cacheKey() or empty.
+         * @param image thumbnail image.
+         *
+         * @return a new Fl_RGB_Image (owned by the caller) or nullptr if the
+         *         image is not RGBA_U8.
+         */
+        Fl_RGB_Image* storeImage(
+            const std::string& key, const std::shared_ptr<image::Image>& image);
+
+        //! Set the maximum size of the persistent cache in megabytes.
+        void setCacheSize(const int megabytes);
+
+        //! Return the maximum size of the persistent cache in megabytes.
+        int cacheSize();
+
+        //! Remove all thumbnails from the persistent cache.
+        void clearCache();
+
+    } // namespace thumbnail
+} // namespace mrv
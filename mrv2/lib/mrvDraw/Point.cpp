@@ -2,6 +2,8 @@
 // mrv2
 // Copyright Contributors to the mrv2 Project. All rights reserved.
 
+#include <cstring>
+
 #include "mrvDraw/Point.h"
 
 namespace mrv
@@ -21,5 +23,33 @@ namespace mrv
             json.at("x").get_to(value.x);
             json.at("y").get_to(value.y);
         }
+
+        std::vector<uint8_t> packPoints(const PointList& value)
+        {
+            std::vector<uint8_t> out(value.size() * 2 * sizeof(float));
+            uint8_t* p = out.data();
+            for (const auto& pnt : value)
+            {
+                const float xy[2] = {
+                    static_cast<float>(pnt.x), static_cast<float>(pnt.y)};
+                memcpy(p, xy, sizeof(xy));
+                p += sizeof(xy);
+            }
+            return out;
+        }
+
+        void unpackPoints(const std::vector<uint8_t>& data, PointList& value)
+        {
+            const size_t size = data.size() / (2 * sizeof(float));
+            value.resize(size);
+            const uint8_t* p = data.data();
+            for (size_t i = 0; i < size; ++i)
+            {
+                float xy[2];
+                memcpy(xy, p, sizeof(xy));
+                p += sizeof(xy);
+                value[i] = Point(xy[0], xy[1]);
+            }
+        }
     } // namespace draw
 } // namespace mrv
@@ -77,6 +77,13 @@ namespace mrv
         void from_json(const nlohmann::json& json, Point& value);
 
         typedef std::vector< Point > PointList;
+
+        //! Pack a point list as consecutive float32 x and y values, to send
+        //! it through the network as a binary blob.
+        std::vector<uint8_t> packPoints(const PointList& value);
+
+        //! Unpack a point list packed with packPoints.
+        void unpackPoints(const std::vector<uint8_t>& data, PointList& value);
     } // namespace draw
 
 } // namespace mrv
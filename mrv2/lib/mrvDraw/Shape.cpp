@@ -45,7 +45,11 @@ namespace mrv
         void from_json(const nlohmann::json& j, PathShape& value)
         {
             from_json(j, static_cast<Shape&>(value));
-            j.at("pts").get_to(value.pts);
+            const nlohmann::json& pts = j.at("pts");
+            if (pts.is_binary())
+                unpackPoints(pts.get_binary(), value.pts);
+            else
+                pts.get_to(value.pts);
         }
 
         void to_json(nlohmann::json& j, const NoteShape& value)
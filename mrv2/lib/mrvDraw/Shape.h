@@ -33,7 +33,8 @@ namespace mrv
                 soft(false),
                 laser(false),
                 fade(1.0F),
-                pen_size(5) {};
+                pen_size(5),
+                version(0) {};
 
             virtual ~Shape() {};
 
@@ -48,6 +49,10 @@ namespace mrv
             bool laser;
             float fade;
             float pen_size;
+
+            //! Increased when the shape is edited in place, so drawings
+            //! cached from it are updated.
+            unsigned version;
         };
 
         class PathShape : public Shape
@@ -633,10 +633,14 @@ namespace mrv
         }
 
         //! Offset annotations by offset time.  Used in cut/insert frame.
+        //! The annotations are copied, as the player indexes them by time.
         std::vector<std::shared_ptr<draw::Annotation>> offsetAnnotations(
             const RationalTime& time, const RationalTime& offset,
-            const std::vector<std::shared_ptr<draw::Annotation>>& annotations)
+            const std::vector<std::shared_ptr<draw::Annotation>>&
+                originalAnnotations)
         {
+            const auto& annotations = deepCopyAnnotations(originalAnnotations);
+
             std::vector<std::shared_ptr<draw::Annotation>> out;
             // Append annotations that come before.
             for (auto a : annotations)
@@ -2252,8 +2256,9 @@ namespace mrv
         if (startTimeOpt.has_value())
         {
             startTime = startTimeOpt.value();
-            offsetAnnotations(
+            auto annotations = offsetAnnotations(
                 startTime, -startTime, player->getAllAnnotations());
+            player->setAllAnnotations(annotations);
         }
 
         const auto& stack = timeline->tracks();
@@ -21,6 +21,7 @@
 
 #include "mrvCore/mrvFile.h"
 #include "mrvCore/mrvI8N.h"
+#include "mrvCore/mrvThumbnailCache.h"
 
 #include "mrvUI/mrvAsk.h"
 #include "mrvUI/mrvUtil.h"
@@ -95,6 +96,9 @@ struct Flu_Entry::Private
     {
         bool init = true;
         ui::ThumbnailRequest request;
+
+        //! Key of the persistent thumbnail cache.
+        std::string cacheKey;
     };
     ThumbnailData thumbnail;
 
@@ -162,35 +166,14 @@ void Flu_Entry::timerEvent()
         p.thumbnail.request.future.wait_for(std::chrono::seconds(0)) ==
             std::future_status::ready)
     {
-        if (auto image = p.thumbnail.request.future.get())
+        if (auto rgbImage = mrv::thumbnail::storeImage(
+                p.thumbnail.cacheKey, p.thumbnail.request.future.get()))
         {
-            if (image::PixelType::RGBA_U8 == image->getPixelType())
-            {
-                const int w = image->getWidth();
-                const int h = image->getHeight();
-                const int depth = 4;
-
-                uint8_t* pixelData = new uint8_t[w * h * depth];
-
-                auto rgbImage = new Fl_RGB_Image(pixelData, w, h, depth);
-                rgbImage->alloc_array = true;
-
-                uint8_t* d = pixelData;
-                const uint8_t* s = image->getData();
-                for (int y = 0; y < h; ++y)
-                {
-                    memcpy(d + (h - 1 - y) * w * 4, s + y * w * 4, w * 4);
-                }
-                bind_image(rgbImage);
-                updateSize();
-                redraw();
-                Fl_Group* g = chooser->getEntryGroup();
-                g->redraw();
-            }
-            else
-            {
-                isPicture = false;
-            }
+            bind_image(rgbImage);
+            updateSize();
+            redraw();
+            Fl_Group* g = chooser->getEntryGroup();
+            g->redraw();
         }
         else
         {
@@ -937,6 +920,17 @@ void Flu_Entry::startRequest()
 
     // Needed to change icon when user saved over the same image name.
 
+    p.thumbnail.cacheKey = mrv::thumbnail::cacheKey(path, size.h, time);
+    if (auto rgbImage = mrv::thumbnail::cachedImage(p.thumbnail.cacheKey))
+    {
+        bind_image(rgbImage);
+        updateSize();
+        redraw();
+        p.thumbnail.init = false;
+        isPicture = true;
+        return;
+    }
+
     if (auto thumbnailSystem = p.thumbnailSystem.lock())
     {
         if (extension == ".otio" || extension == ".otioz")
@@ -23,6 +23,7 @@
 #include "mrvFl/mrvSaveOptions.h"
 #include "mrvFl/mrvVersioning.h"
 #include "mrvFl/mrvFileRequester.h"
+#include "mrvFl/mrvRenderQueue.h"
 #include "mrvFl/mrvSave.h"
 #include "mrvFl/mrvSession.h"
 #include "mrvFl/mrvStereo3DAux.h"
@@ -101,12 +102,14 @@ namespace mrv
 #ifdef MRV2_PYBIND11
         {_("Python"), (Fl_Callback*)python_panel_cb},
 #endif
+        {_("Render Queue"), (Fl_Callback*)render_queue_panel_cb},
         {_("Settings"), (Fl_Callback*)settings_panel_cb},
         {_("Stereo 3D"), (Fl_Callback*)stereo3D_panel_cb},
 #ifdef TLRENDER_USD
         {_("USD"), (Fl_Callback*)usd_panel_cb},
 #endif
         {_("Vectorscope"), (Fl_Callback*)vectorscope_panel_cb},
+        {_("Waveform"), (Fl_Callback*)waveform_panel_cb},
         {_("Hotkeys"), (Fl_Callback*)nullptr},
         {_("Preferences"), (Fl_Callback*)nullptr},
         {_("About"), (Fl_Callback*)nullptr},
@@ -154,6 +157,7 @@ namespace mrv
 
     void open_files_cb(const std::vector< std::string >& files, ViewerUI* ui)
     {
+        ui->app->prefetch(files);
         for (const auto& file : files)
         {
             ui->app->open(file);
@@ -168,6 +172,7 @@ namespace mrv
         int savedDigits = settings->getValue<int>("Misc/MaxFileSequenceDigits");
         settings->setValue("Misc/MaxFileSequenceDigits", 0);
         
+        ui->app->prefetch(files);
         for (const auto& file : files)
         {
             ui->app->open(file);
@@ -338,187 +343,241 @@ namespace mrv
         save_single_frame(file, ui, lastSavedOptions);
     }
 
-    void save_movie_cb(Fl_Menu_* w, ViewerUI* ui)
+    namespace
     {
-
-        auto player = ui->uiView->getTimelinePlayer();
-        if (!player)
-            return;
-
-        const auto& ioInfo = player->ioInfo();
-        bool audioOnly = ioInfo.video.empty();
-
-        std::string file;
-        if (audioOnly)
-            file = save_audio_file();
-        else
-            file = save_movie_or_sequence_file();
-        if (file.empty())
-            return;
-
-        std::string extension = tl::file::Path(file).getExtension();
-        extension = string::toLower(extension);
-        if (extension.empty())
+        //! Ask for the file to save the movie, sequence or audio to and
+        //! its options.  Returns false if cancelled.
+        bool request_save_movie(
+            ViewerUI* ui, std::string& file, SaveOptions& options)
         {
-            LOG_ERROR(_("File extension cannot be empty."));
-            return;
-        }
+            auto player = ui->uiView->getTimelinePlayer();
+            if (!player)
+                return false;
 
-        if (extension == ".otio")
-        {
-            save_timeline_to_disk(file);
-            return;
-        }
+            const auto& ioInfo = player->ioInfo();
+            bool audioOnly = ioInfo.video.empty();
 
-        mrv::SaveOptions options;
+            if (audioOnly)
+                file = save_audio_file();
+            else
+                file = save_movie_or_sequence_file();
+            if (file.empty())
+                return false;
 
-#ifdef TLRENDER_FFMPEG
-        if (file::isMovie(extension) || file::isAudio(extension))
-        {
-            bool hasAudio = false;
-            if (ioInfo.audio.isValid())
-                hasAudio = true;
-
-            bool hasVideo = !ioInfo.video.empty();
-
-            if (!hasAudio && file::isAudio(extension))
+            std::string extension = tl::file::Path(file).getExtension();
+            extension = string::toLower(extension);
+            if (extension.empty())
             {
-                LOG_ERROR(
-                    _("Saving audio but current clip does not have audio."));
-                return;
+                LOG_ERROR(_("File extension cannot be empty."));
+                return false;
             }
 
-            if (hasVideo && file::isAudio(extension))
+            if (extension == ".otio")
             {
-                LOG_ERROR(_("Saving video but with an audio extension."));
-                return;
+                save_timeline_to_disk(file);
+                return false;
             }
 
-            SaveMovieOptionsUI saveOptions(hasAudio, audioOnly);
-            if (saveOptions.cancel)
-                return;
+#ifdef TLRENDER_FFMPEG
+            if (file::isMovie(extension) || file::isAudio(extension))
+            {
+                bool hasAudio = false;
+                if (ioInfo.audio.isValid())
+                    hasAudio = true;
 
-            options.annotations =
-                static_cast<bool>(saveOptions.Annotations->value());
-            options.resolution =
-                static_cast<SaveResolution>(saveOptions.Resolution->value());
+                bool hasVideo = !ioInfo.video.empty();
 
-            int value;
-            value = saveOptions.Profile->value();
+                if (!hasAudio && file::isAudio(extension))
+                {
+                    LOG_ERROR(
+                        _("Saving audio but current clip does not have "
+                          "audio."));
+                    return false;
+                }
 
-            const Fl_Menu_Item* item = &saveOptions.Profile->menu()[value];
+                if (hasVideo && file::isAudio(extension))
+                {
+                    LOG_ERROR(_("Saving video but with an audio extension."));
+                    return false;
+                }
 
-            // We need to iterate through all the profiles, as some profiles
-            // may be hidden from the UI due to FFmpeg being compiled as
-            // LGPL.
-            int index = 0;
-            auto entries = tl::ffmpeg::getProfileLabels();
-            for (auto entry : entries)
-            {
-                if (entry == item->label())
+                SaveMovieOptionsUI saveOptions(hasAudio, audioOnly);
+                if (saveOptions.cancel)
+                    return false;
+
+                options.annotations =
+                    static_cast<bool>(saveOptions.Annotations->value());
+                options.resolution = static_cast<SaveResolution>(
+                    saveOptions.Resolution->value());
+
+                int value;
+                value = saveOptions.Profile->value();
+
+                const Fl_Menu_Item* item = &saveOptions.Profile->menu()[value];
+
+                // We need to iterate through all the profiles, as some profiles
+                // may be hidden from the UI due to FFmpeg being compiled as
+                // LGPL.
+                int index = 0;
+                auto entries = tl::ffmpeg::getProfileLabels();
+                for (auto entry : entries)
                 {
-                    options.ffmpegProfile =
-                        static_cast<tl::ffmpeg::Profile>(index);
+                    if (entry == item->label())
+                    {
+                        options.ffmpegProfile =
+                            static_cast<tl::ffmpeg::Profile>(index);
+                    }
+                    ++index;
                 }
-                ++index;
-            }
 
-            std::string preset;
-            value = saveOptions.Preset->value();
-            if (value >= 0)
-            {
-                const Fl_Menu_Item* item = &saveOptions.Preset->menu()[value];
-                if (item->label())
+                std::string preset;
+                value = saveOptions.Preset->value();
+                if (value >= 0)
                 {
-                    auto entries = tl::ffmpeg::getProfileLabels();
-                    std::string profileName =
-                        entries[(int)options.ffmpegProfile];
-                    preset = tl::string::toLower(profileName) + "-" +
-                             item->label() + ".pst";
-                    options.ffmpegPreset = presetspath() + preset;
-                    if (!file::isReadable(options.ffmpegPreset))
+                    const Fl_Menu_Item* item =
+                        &saveOptions.Preset->menu()[value];
+                    if (item->label())
                     {
-                        options.ffmpegPreset = "";
+                        auto entries = tl::ffmpeg::getProfileLabels();
+                        std::string profileName =
+                            entries[(int)options.ffmpegProfile];
+                        preset = tl::string::toLower(profileName) + "-" +
+                                 item->label() + ".pst";
+                        options.ffmpegPreset = presetspath() + preset;
+                        if (!file::isReadable(options.ffmpegPreset))
+                        {
+                            options.ffmpegPreset = "";
+                        }
                     }
                 }
-            }
 
-            std::string pixelFormat;
-            value = saveOptions.PixelFormat->value();
-            if (value >= 0)
-            {
-                const Fl_Menu_Item* item =
-                    &saveOptions.PixelFormat->menu()[value];
-                if (item->label())
+                std::string pixelFormat;
+                value = saveOptions.PixelFormat->value();
+                if (value >= 0)
                 {
-                    options.ffmpegPixelFormat = item->label();
+                    const Fl_Menu_Item* item =
+                        &saveOptions.PixelFormat->menu()[value];
+                    if (item->label())
+                    {
+                        options.ffmpegPixelFormat = item->label();
+                    }
                 }
-            }
-            value = saveOptions.AudioCodec->value();
-            options.ffmpegAudioCodec =
-                static_cast<tl::ffmpeg::AudioCodec>(value);
+                value = saveOptions.AudioCodec->value();
+                options.ffmpegAudioCodec =
+                    static_cast<tl::ffmpeg::AudioCodec>(value);
 
-            options.ffmpegHardwareEncode = saveOptions.Hardware->value();
-            options.ffmpegOverride = saveOptions.Override->value();
-            if (options.ffmpegOverride)
-            {
-                const Fl_Menu_Item* item;
+                options.ffmpegHardwareEncode = saveOptions.Hardware->value();
+                options.ffmpegOverride = saveOptions.Override->value();
+                if (options.ffmpegOverride)
+                {
+                    const Fl_Menu_Item* item;
 
-                item = &saveOptions.ColorRange
-                            ->menu()[saveOptions.ColorRange->value()];
-                options.ffmpegColorRange = item->label();
+                    item = &saveOptions.ColorRange
+                                ->menu()[saveOptions.ColorRange->value()];
+                    options.ffmpegColorRange = item->label();
 
-                item = &saveOptions.ColorSpace
-                            ->menu()[saveOptions.ColorSpace->value()];
-                options.ffmpegColorSpace = item->label();
+                    item = &saveOptions.ColorSpace
+                                ->menu()[saveOptions.ColorSpace->value()];
+                    options.ffmpegColorSpace = item->label();
 
-                item = &saveOptions.ColorPrimaries
-                            ->menu()[saveOptions.ColorPrimaries->value()];
-                options.ffmpegColorPrimaries = item->label();
+                    item = &saveOptions.ColorPrimaries
+                                ->menu()[saveOptions.ColorPrimaries->value()];
+                    options.ffmpegColorPrimaries = item->label();
 
-                item = &saveOptions.ColorTRC
-                            ->menu()[saveOptions.ColorTRC->value()];
-                options.ffmpegColorTRC = item->label();
+                    item = &saveOptions.ColorTRC
+                                ->menu()[saveOptions.ColorTRC->value()];
+                    options.ffmpegColorTRC = item->label();
+                }
             }
-        }
-        else
+            else
 #endif
-        {
-            bool valid_for_exr = false;
-            if (extension == ".exr")
             {
-                valid_for_exr = true;
-            }
+                bool valid_for_exr = false;
+                if (extension == ".exr")
+                {
+                    valid_for_exr = true;
+                }
 
-            SaveImageOptionsUI saveOptions(extension, valid_for_exr);
-            if (saveOptions.cancel)
-                return;
+                SaveImageOptionsUI saveOptions(extension, valid_for_exr);
+                if (saveOptions.cancel)
+                    return false;
 
-            options.annotations =
-                static_cast<bool>(saveOptions.Annotations->value());
+                options.annotations =
+                    static_cast<bool>(saveOptions.Annotations->value());
 
-            int value;
+                int value;
 
 #ifdef TLRENDER_EXR
-            value = saveOptions.PixelType->value();
-            if (value == 0)
-                options.exrPixelType = tl::image::PixelType::RGBA_F16;
-            if (value == 1)
-                options.exrPixelType = tl::image::PixelType::RGBA_F32;
-
-            value = saveOptions.Compression->value();
-            options.exrCompression = static_cast<tl::exr::Compression>(value);
-
-            options.zipCompressionLevel =
-                static_cast<int>(saveOptions.ZipCompressionLevel->value());
-            options.dwaCompressionLevel =
-                saveOptions.DWACompressionLevel->value();
+                value = saveOptions.PixelType->value();
+                if (value == 0)
+                    options.exrPixelType = tl::image::PixelType::RGBA_F16;
+                if (value == 1)
+                    options.exrPixelType = tl::image::PixelType::RGBA_F32;
+
+                value = saveOptions.Compression->value();
+                options.exrCompression =
+                    static_cast<tl::exr::Compression>(value);
+
+                options.zipCompressionLevel =
+                    static_cast<int>(saveOptions.ZipCompressionLevel->value());
+                options.dwaCompressionLevel =
+                    saveOptions.DWACompressionLevel->value();
 #endif
+            }
+
+            return true;
         }
+    } // namespace
+
+    void save_movie_cb(Fl_Menu_* w, ViewerUI* ui)
+    {
+        std::string file;
+        SaveOptions options;
+        if (!request_save_movie(ui, file, options))
+            return;
 
         save_movie(file, ui, options);
     }
 
+    void save_movie_in_background_cb(Fl_Menu_* w, ViewerUI* ui)
+    {
+        auto player = ui->uiView->getTimelinePlayer();
+        if (!player)
+            return;
+
+        auto model = ui->app->filesModel();
+        auto Aitem = model->observeA()->get();
+        if (!Aitem)
+            return;
+
+        std::string file;
+        SaveOptions options;
+        if (!request_save_movie(ui, file, options))
+            return;
+
+        if (options.annotations)
+        {
+            LOG_WARNING(_("Annotations are not saved in the background.  "
+                          "Use File/Save/Movie or Sequence to save them."));
+            options.annotations = false;
+        }
+
+        RenderJob job;
+        job.input = Aitem->path.get();
+        job.audioInput = Aitem->audioPath.get();
+        job.output = file;
+        job.inOutRange = player->inOutRange();
+        job.speed = player->speed();
+        job.videoLayer = ui->uiColorChannel->value();
+        job.ocioOptions = ui->uiView->getOCIOOptions();
+        job.lutOptions = ui->uiView->lutOptions();
+        job.options = options;
+        ui->app->renderQueue()->add(job);
+
+        if (!panel::renderQueuePanel)
+            render_queue_panel_cb(nullptr, ui);
+    }
+
     void save_pdf_cb(Fl_Menu_* w, ViewerUI* ui)
     {
 #ifdef MRV2_PDF
@@ -598,6 +657,10 @@ namespace mrv
             panel::histogramPanel->save();
         if (panel::vectorscopePanel)
             panel::vectorscopePanel->save();
+        if (panel::waveformPanel)
+            panel::waveformPanel->save();
+        if (panel::renderQueuePanel)
+            panel::renderQueuePanel->save();
         if (panel::environmentMapPanel)
             panel::environmentMapPanel->save();
 #ifdef MRV2_PYBIND11
@@ -2414,12 +2477,25 @@ namespace mrv
             return;
 
         auto app = App::app;
+        auto model = app->filesModel();
+        if (model->observeFiles()->getSize() < 1)
+            return;
 
-        // Update the I/O cache.
-        auto ioSystem = app->getContext()->getSystem<io::System>();
-        ioSystem->getCache()->clear();
+        // Temporary EDLs (edit mode) and NDI streams are not files on
+        // disk, so drop all the cached frames.
+        auto item = model->observeA()->get();
+        if (file::isTemporaryEDL(item->path) ||
+            file::isTemporaryNDI(item->path))
+        {
+            auto ioSystem = app->getContext()->getSystem<io::System>();
+            ioSystem->getCache()->clear();
+
+            player->clearCache();
+            return;
+        }
 
-        player->clearCache();
+        // Only drop the frames of the current file from the I/O cache.
+        app->invalidateFile(item->path.get(), true);
     }
 
     void copy_filename_cb(Fl_Menu_* m, void* d)
@@ -50,6 +50,7 @@ namespace mrv
     void save_single_frame_to_folder_cb(Fl_Menu_* w, ViewerUI* ui);
     void save_single_frame_cb(Fl_Menu_* w, ViewerUI* ui);
     void save_movie_cb(Fl_Menu_* w, ViewerUI* ui);
+    void save_movie_in_background_cb(Fl_Menu_* w, ViewerUI* ui);
     void save_pdf_cb(Fl_Menu_* w, ViewerUI* ui);
 
     void close_current_cb(Fl_Widget* w, ViewerUI* ui);
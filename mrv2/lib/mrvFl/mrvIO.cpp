@@ -2,8 +2,12 @@
 // mrv2
 // Copyright Contributors to the mrv2 Project. All rights reserved.
 
+#include <chrono>
+#include <condition_variable>
 #include <cstring> // for strcpy
+#include <mutex>
 #include <regex>
+#include <vector>
 
 #include "mrvCore/mrvHome.h"
 
@@ -17,6 +21,8 @@
 
 #include "mrvApp/mrvApp.h"
 
+#include "mrViewer.h"
+
 namespace mrv
 {
     namespace
@@ -53,72 +59,294 @@ namespace mrv
         std::ofstream logbuffer::out;
         std::thread::id logbuffer::mainThread;
 
-        logbuffer::logbuffer() :
-            string_stream()
+        namespace
         {
-            str().reserve(1024);
-            mainThread = std::this_thread::get_id();
-            open_file();
-        };
+            //! Minimum time between two batches of log lines.
+            const std::chrono::milliseconds kLogInterval(200);
 
-        logbuffer::~logbuffer()
-        {
-            if (out.is_open())
-                out.close();
-        };
+            //! Maximum number of lines waiting for the log display.
+            const size_t kMaxDisplayLines = 1000;
 
-        void logbuffer::open_file()
-        {
-            if (out.is_open())
-                return;
+            struct LogLine
+            {
+                char style;
+                std::string text;
+            };
+
+            //! Style of the lines printed with trace::print.  They only go
+            //! to the console.
+            const char kPrintStyle = 'P';
+
+            //! Style of the errors.  They are written right away.
+            const char kErrorStyle = 'D';
+
+            //! Writes the log lines to the console and debug.log from a
+            //! background thread, and hands them to the log display a few
+            //! times per second, so logging does not block the caller.
+            //! Errors are written synchronously, after the lines waiting,
+            //! so they are not lost if mrv2 crashes.
+            class LogWriter
+            {
+            public:
+                ~LogWriter();
 
-            out.open(tmppath() + "debug.log");
-        }
+                void push(char style, const char* text, bool toDisplay);
 
-        void logbuffer::open_ffmpeg_log_panel()
-        {
-            if (!App::ui || !App::app->isRunning())
-                return;
+                //! Take the lines waiting for the log display.
+                std::vector<LogLine> takeDisplay();
+
+            private:
+                void _run();
+
+                //! Protects the lines, the display and the thread.
+                std::mutex mutex;
+
+                //! Held while writing, so the lines are written in order.
+                //! It is locked before the mutex.
+                std::mutex writeMutex;
 
-            bool local = std::this_thread::get_id() == mainThread;
+                std::condition_variable condition;
+                std::vector<LogLine> lines;
+                std::vector<LogLine> display;
+                bool displayScheduled = false;
+                bool stopped = false;
+                std::thread thread;
+            };
 
-            if (LogDisplay::ffmpegPrefs == LogDisplay::kDockOnError)
+            //! Set when the log writer is destroyed, for the log lines of
+            //! the static destructors that run after it.
+            bool logWriterDestroyed = false;
+
+            LogWriter& getLogWriter()
             {
-                if (local)
-                    open_log_panel_cb(App::ui);
-                else
-                    Fl::awake((Fl_Awake_Handler)open_log_panel_cb, App::ui);
+                static LogWriter logWriter;
+                return logWriter;
             }
-            else if (LogDisplay::ffmpegPrefs == LogDisplay::kWindowOnError)
+
+            void log_display_cb(void*);
+
+            void open_log_panel(LogDisplay::ShowPreferences prefs)
             {
-                if (local)
+                if (!App::ui || !App::app->isRunning())
+                    return;
+
+                if (prefs == LogDisplay::kDockOnError)
+                    open_log_panel_cb(App::ui);
+                else if (prefs == LogDisplay::kWindowOnError)
                     open_log_window_cb(App::ui);
+            }
+
+            void writeConsole(const LogLine& line)
+            {
+                if (line.style == 'A' || line.style == kPrintStyle)
+                    std::cout << line.text;
                 else
-                    Fl::awake((Fl_Awake_Handler)open_log_window_cb, App::ui);
+                    std::cerr << line.text;
             }
-        }
 
-        void logbuffer::open_log_panel()
-        {
-            if (!App::ui || !App::app->isRunning())
-                return;
+            void writeLines(const std::vector<LogLine>& batch)
+            {
+                if (batch.empty())
+                    return;
+
+                for (const auto& line : batch)
+                {
+                    writeConsole(line);
+                    if (logbuffer::out.is_open() && line.style != kPrintStyle)
+                        logbuffer::out << line.text;
+                }
+                std::cout.flush();
+                std::cerr.flush();
+                if (logbuffer::out.is_open())
+                    logbuffer::out.flush();
+            }
 
-            bool local = std::this_thread::get_id() == mainThread;
+            void pushLine(char style, const char* text, bool toDisplay)
+            {
+                if (logWriterDestroyed)
+                {
+                    writeConsole({style, text});
+                    return;
+                }
+                getLogWriter().push(style, text, toDisplay);
+            }
 
-            if (LogDisplay::prefs == LogDisplay::kDockOnError)
+            void LogWriter::push(char style, const char* text, bool toDisplay)
             {
-                if (local)
-                    open_log_panel_cb(App::ui);
-                else
-                    Fl::awake((Fl_Awake_Handler)open_log_panel_cb, App::ui);
+                const bool now = style == kErrorStyle;
+                std::unique_lock wlk(writeMutex, std::defer_lock);
+                if (now)
+                    wlk.lock();
+
+                std::vector<LogLine> batch;
+                bool scheduleDisplay = false;
+                {
+                    std::lock_guard lk(mutex);
+                    if (toDisplay)
+                    {
+                        display.push_back({style, text});
+                        if (display.size() > kMaxDisplayLines)
+                            display.erase(display.begin());
+                    }
+                    if (now || stopped)
+                    {
+                        // Write the lines waiting first, to keep the order.
+                        batch.swap(lines);
+                        batch.push_back({style, text});
+                        if (toDisplay && !displayScheduled)
+                        {
+                            displayScheduled = true;
+                            scheduleDisplay = true;
+                        }
+                    }
+                    else
+                    {
+                        if (!thread.joinable())
+                            thread = std::thread([this] { _run(); });
+                        lines.push_back({style, text});
+                    }
+                }
+
+                if (batch.empty())
+                {
+                    condition.notify_one();
+                    return;
+                }
+                if (!now)
+                    wlk.lock();
+                writeLines(batch);
+                if (scheduleDisplay)
+                    Fl::awake((Fl_Awake_Handler)log_display_cb, nullptr);
             }
-            else if (LogDisplay::prefs == LogDisplay::kWindowOnError)
+
+            std::vector<LogLine> LogWriter::takeDisplay()
             {
-                if (local)
-                    open_log_window_cb(App::ui);
-                else
-                    Fl::awake((Fl_Awake_Handler)open_log_window_cb, App::ui);
+                std::vector<LogLine> out;
+                std::lock_guard lk(mutex);
+                out.swap(display);
+                displayScheduled = false;
+                return out;
             }
+
+            LogWriter::~LogWriter()
+            {
+                {
+                    std::lock_guard lk(mutex);
+                    stopped = true;
+                }
+                condition.notify_one();
+                if (thread.joinable())
+                    thread.join();
+                {
+                    std::lock_guard wlk(writeMutex);
+                    std::vector<LogLine> batch;
+                    {
+                        std::lock_guard lk(mutex);
+                        batch.swap(lines);
+                    }
+                    writeLines(batch);
+                    if (logbuffer::out.is_open())
+                        logbuffer::out.close();
+                }
+                logWriterDestroyed = true;
+            }
+
+            void LogWriter::_run()
+            {
+                while (true)
+                {
+                    {
+                        std::unique_lock lk(mutex);
+                        condition.wait(
+                            lk, [this] { return !lines.empty() || stopped; });
+                        if (stopped)
+                            break;
+                    }
+
+                    std::vector<LogLine> batch;
+                    bool scheduleDisplay = false;
+                    {
+                        std::lock_guard wlk(writeMutex);
+                        {
+                            std::lock_guard lk(mutex);
+                            batch.swap(lines);
+                            if (!display.empty() && !displayScheduled)
+                            {
+                                displayScheduled = true;
+                                scheduleDisplay = true;
+                            }
+                        }
+                        writeLines(batch);
+                    }
+                    if (scheduleDisplay)
+                        Fl::awake((Fl_Awake_Handler)log_display_cb, nullptr);
+
+                    // Let the next lines accumulate.
+                    std::unique_lock lk(mutex);
+                    condition.wait_for(
+                        lk, kLogInterval, [this] { return stopped; });
+                }
+            }
+
+            //! Append the pending lines to the log display, on the main thread.
+            void log_display_cb(void*)
+            {
+                const auto& lines = getLogWriter().takeDisplay();
+                if (!uiLogDisplay || lines.empty())
+                    return;
+
+                std::string text;
+                std::string style;
+                const LogLine* status = nullptr;
+                bool error = false;
+                bool ffmpegError = false;
+                for (const auto& line : lines)
+                {
+                    text += line.text;
+                    style.append(line.text.size(), line.style);
+                    if (line.style == 'C' || line.style == 'D')
+                        status = &line;
+                    if (line.style == 'D')
+                    {
+                        if (contains_ffmpeg(line.text))
+                            ffmpegError = true;
+                        else
+                            error = true;
+                    }
+                }
+                uiLogDisplay->append(text.c_str(), style.c_str());
+
+                if (status && App::ui)
+                {
+                    if (status->style == 'D')
+                        App::ui->uiStatusBar->error(status->text.c_str());
+                    else
+                        App::ui->uiStatusBar->warning(status->text.c_str());
+                }
+
+                if (ffmpegError)
+                    open_log_panel(LogDisplay::ffmpegPrefs);
+                if (error)
+                    open_log_panel(LogDisplay::prefs);
+            }
+        } // namespace
+
+        logbuffer::logbuffer() :
+            string_stream()
+        {
+            str().reserve(1024);
+            mainThread = std::this_thread::get_id();
+            open_file();
+        };
+
+        logbuffer::~logbuffer() {};
+
+        void logbuffer::open_file()
+        {
+            if (out.is_open())
+                return;
+
+            out.open(tmppath() + "debug.log");
         }
 
         int logbuffer::sync()
@@ -126,20 +354,10 @@ namespace mrv
             if (!pbase())
                 return 0;
 
-            // make sure to null terminate the string
-            sputc('\0');
-
-            // freeze and call the virtual print method
-            char* c = strdup(str().c_str());
-            if (!c)
-                return 1;
-
-            print(c);
+            print(str().c_str());
 
-            free(c);
-
-            // reset iterator to first position & unfreeze
-            seekoff(0, std::ios::beg);
+            // reset iterator to first position
+            str(std::string());
             return 0;
         }
 
@@ -148,22 +366,7 @@ namespace mrv
             if (Flu_File_Chooser::window)
                 return;
 
-            std::cerr << c;
-
-            if (out.is_open())
-            {
-                out << c << std::flush;
-            }
-
-            if (contains_ffmpeg(c))
-            {
-                open_ffmpeg_log_panel();
-            }
-            else
-                open_log_panel();
-
-            if (uiLogDisplay)
-                uiLogDisplay->error(c);
+            pushLine(kErrorStyle, c, uiLogDisplay != nullptr);
         }
 
         void warnbuffer::print(const char* c)
@@ -171,27 +374,17 @@ namespace mrv
             if (Flu_File_Chooser::window)
                 return;
 
-            if (out.is_open())
-            {
-                out << c << std::flush;
-            }
-
-            std::cerr << c;
-            if (uiLogDisplay)
-                uiLogDisplay->warning(c);
+            pushLine('C', c, uiLogDisplay != nullptr);
         }
 
         void infobuffer::print(const char* c)
         {
-            std::cout << c << std::flush;
-
-            if (out.is_open())
-            {
-                out << c << std::flush;
-            }
+            pushLine('A', c, uiLogDisplay != nullptr);
+        }
 
-            if (uiLogDisplay)
-                uiLogDisplay->info(c);
+        void print(const std::string& text)
+        {
+            pushLine(kPrintStyle, text.c_str(), false);
         }
 
         infostream info;
@@ -33,9 +33,6 @@ namespace mrv
 
             void open_file();
 
-            void open_ffmpeg_log_panel();
-            void open_log_panel();
-
             //! from basic_streambuf, stl function used to sync stream
             virtual int sync();
 
@@ -91,6 +88,10 @@ namespace mrv
         extern warnstream warn;
         extern errorstream error;
 
+        //! Print text to the standard output, in order with the log lines,
+        //! without adding it to debug.log or the log display.
+        void print(const std::string& text);
+
     } // namespace trace
 
 } // namespace mrv
@@ -17,10 +17,13 @@ namespace fs = std::filesystem;
 #include "mrvCore/mrvHotkey.h"
 #include "mrvCore/mrvLocale.h"
 #include "mrvCore/mrvMedia.h"
+#include "mrvCore/mrvThumbnailCache.h"
 #include "mrvCore/mrvUtil.h"
 
 #include "mrvWidgets/mrvLogDisplay.h"
 
+#include "mrvNetwork/mrvTCP.h"
+
 #ifdef MRV2_NETWORK
 #    include "mrvNetwork/mrvImageListener.h"
 #endif
@@ -304,6 +307,9 @@ namespace mrv
         gui.get("panel_thumbnails", tmp, 1);
         uiPrefs->uiPrefsPanelThumbnails->value(tmp);
 
+        gui.get("thumbnail_cache_size", tmp, 256);
+        thumbnail::setCacheSize(tmp);
+
         gui.get("remove_edls", tmp, 1);
         uiPrefs->uiPrefsRemoveEDLs->value(tmp);
 
@@ -817,6 +823,10 @@ namespace mrv
         network.get("receive_audio", tmp, 1);
         uiPrefs->ReceiveAudio->value(tmp);
 
+        // Only set in the prefs file.  See the Network preferences docs.
+        network.get("max_send_rate", tmp, 60);
+        TCP::setMaxSendRate(tmp);
+
         Fl_Preferences errors(base, "errors");
         errors.get("log_display", tmp, 2);
 
@@ -1223,6 +1233,7 @@ namespace mrv
         gui.set(
             "timeline_thumbnails", uiPrefs->uiPrefsTimelineThumbnails->value());
         gui.set("panel_thumbnails", uiPrefs->uiPrefsPanelThumbnails->value());
+        gui.set("thumbnail_cache_size", thumbnail::cacheSize());
         gui.set("remove_edls", uiPrefs->uiPrefsRemoveEDLs->value());
         gui.set("timeline_edit_mode", uiPrefs->uiPrefsEditMode->value());
         gui.set("timeline_edit_view", uiPrefs->uiPrefsEditView->value());
@@ -1452,6 +1463,8 @@ namespace mrv
 
         network.set("receive_audio", (int)uiPrefs->ReceiveAudio->value());
 
+        network.set("max_send_rate", TCP::maxSendRate());
+
         Fl_Preferences errors(base, "errors");
         errors.set(
             "log_display", (int)uiPrefs->uiPrefsRaiseLogWindowOnError->value());
@@ -0,0 +1,657 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// mrv2
+// Copyright Contributors to the mrv2 Project. All rights reserved.
+
+#ifdef _WIN32
+#    define WIN32_LEAN_AND_MEAN
+#    include <windows.h>
+#else
+#    include <signal.h>
+#    include <spawn.h>
+#    include <sys/wait.h>
+#    include <unistd.h>
+extern char** environ;
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include <tlCore/StringFormat.h>
+
+#include "mrvCore/mrvCPU.h"
+#include "mrvCore/mrvHome.h"
+#include "mrvCore/mrvI8N.h"
+
+#include "mrvFl/mrvIO.h"
+#include "mrvFl/mrvRenderQueue.h"
+
+namespace
+{
+    const char* kModule = "render";
+}
+
+namespace mrv
+{
+    const char* kRenderProgress = "mrv2 render progress: ";
+
+    namespace
+    {
+        //! Child process whose standard output and error are read as lines.
+        class Process
+        {
+        public:
+            //! Start the process.  Throws on error.
+            Process(const std::vector<std::string>& args);
+            ~Process();
+
+            //! Read a line of the output.  Returns false at its end.
+            bool readLine(std::string& line);
+
+            //! Wait for the process to end and return its exit code.
+            int wait();
+
+            void kill();
+
+        private:
+#ifdef _WIN32
+            PROCESS_INFORMATION _info;
+            HANDLE _output = nullptr;
+            std::string _buffer;
+#else
+            pid_t _pid = 0;
+            FILE* _output = nullptr;
+#endif
+        };
+
+#ifdef _WIN32
+        std::wstring to_wstring(const std::string& value)
+        {
+            const int size = MultiByteToWideChar(
+                CP_UTF8, 0, value.c_str(), -1, nullptr, 0);
+            std::wstring out(size > 0 ? size - 1 : 0, L'\0');
+            if (size > 1)
+                MultiByteToWideChar(
+                    CP_UTF8, 0, value.c_str(), -1, &out[0], size);
+            return out;
+        }
+
+        std::wstring quote(const std::string& value)
+        {
+            const std::wstring arg = to_wstring(value);
+            if (!arg.empty() && arg.find_first_of(L" \t\"") == std::wstring::npos)
+                return arg;
+
+            std::wstring out = L"\"";
+            for (const auto c : arg)
+            {
+                if (c == L'"')
+                    out += L'\\';
+                out += c;
+            }
+            out += L'"';
+            return out;
+        }
+
+        Process::Process(const std::vector<std::string>& args)
+        {
+            SECURITY_ATTRIBUTES security = {};
+            security.nLength = sizeof(security);
+            security.bInheritHandle = TRUE;
+
+            HANDLE write = nullptr;
+            if (!CreatePipe(&_output, &write, &security, 0))
+                throw std::runtime_error(_("Could not create a pipe."));
+            SetHandleInformation(_output, HANDLE_FLAG_INHERIT, 0);
+
+            STARTUPINFOW startup = {};
+            startup.cb = sizeof(startup);
+            startup.dwFlags = STARTF_USESTDHANDLES;
+            startup.hStdOutput = write;
+            startup.hStdError = write;
+            startup.hStdInput = GetStdHandle(STD_INPUT_HANDLE);
+
+            std::wstring command;
+            for (const auto& arg : args)
+            {
+                if (!command.empty())
+                    command += L' ';
+                command += quote(arg);
+            }
+
+            const BOOL ok = CreateProcessW(
+                nullptr, &command[0], nullptr, nullptr, TRUE,
+                CREATE_NO_WINDOW, nullptr, nullptr, &startup, &_info);
+            CloseHandle(write);
+            if (!ok)
+            {
+                CloseHandle(_output);
+                throw std::runtime_error(std::string(
+                    string::Format(_("Could not run {0}.")).arg(args[0])));
+            }
+            CloseHandle(_info.hThread);
+        }
+
+        Process::~Process()
+        {
+            CloseHandle(_output);
+            CloseHandle(_info.hProcess);
+        }
+
+        bool Process::readLine(std::string& line)
+        {
+            while (true)
+            {
+                const size_t pos = _buffer.find('\n');
+                if (pos != std::string::npos)
+                {
+                    line = _buffer.substr(0, pos);
+                    _buffer.erase(0, pos + 1);
+                    if (!line.empty() && line.back() == '\r')
+                        line.pop_back();
+                    return true;
+                }
+
+                char data[4096];
+                DWORD count = 0;
+                if (!ReadFile(_output, data, sizeof(data), &count, nullptr) ||
+                    count == 0)
+                {
+                    line = _buffer;
+                    _buffer.clear();
+                    return !line.empty();
+                }
+                _buffer.append(data, count);
+            }
+        }
+
+        int Process::wait()
+        {
+            WaitForSingleObject(_info.hProcess, INFINITE);
+            DWORD code = 1;
+            GetExitCodeProcess(_info.hProcess, &code);
+            return static_cast<int>(code);
+        }
+
+        void Process::kill()
+        {
+            TerminateProcess(_info.hProcess, 1);
+        }
+#else
+        Process::Process(const std::vector<std::string>& args)
+        {
+            int fds[2];
+            if (pipe(fds) != 0)
+                throw std::runtime_error(_("Could not create a pipe."));
+
+            posix_spawn_file_actions_t actions;
+            posix_spawn_file_actions_init(&actions);
+            posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+            posix_spawn_file_actions_adddup2(&actions, fds[1], STDERR_FILENO);
+            posix_spawn_file_actions_addclose(&actions, fds[0]);
+            posix_spawn_file_actions_addclose(&actions, fds[1]);
+
+            std::vector<char*> argv;
+            for (const auto& arg : args)
+                argv.push_back(const_cast<char*>(arg.c_str()));
+            argv.push_back(nullptr);
+
+            const int err = posix_spawn(
+                &_pid, args[0].c_str(), &actions, nullptr, argv.data(),
+                environ);
+            posix_spawn_file_actions_destroy(&actions);
+            close(fds[1]);
+            if (err != 0)
+            {
+                close(fds[0]);
+                throw std::runtime_error(std::string(
+                    string::Format(_("Could not run {0}.")).arg(args[0])));
+            }
+            _output = fdopen(fds[0], "r");
+        }
+
+        Process::~Process()
+        {
+            if (_output)
+                fclose(_output);
+        }
+
+        bool Process::readLine(std::string& line)
+        {
+            line.clear();
+            char data[4096];
+            while (fgets(data, sizeof(data), _output))
+            {
+                line += data;
+                if (line.back() == '\n')
+                {
+                    line.pop_back();
+                    return true;
+                }
+            }
+            return !line.empty();
+        }
+
+        int Process::wait()
+        {
+            int status = 0;
+            if (waitpid(_pid, &status, 0) < 0)
+                return -1;
+            return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+        }
+
+        void Process::kill()
+        {
+            ::kill(_pid, SIGTERM);
+        }
+#endif
+
+        //! Arguments of the mrv2 -output command that runs a job.
+        std::vector<std::string> getArguments(const RenderJob& job)
+        {
+            std::vector<std::string> out;
+#ifdef _WIN32
+            out.push_back(rootpath() + "/bin/mrv2.exe");
+#else
+            out.push_back(rootpath() + "/bin/mrv2");
+#endif
+            out.push_back(job.input);
+            out.push_back("-output");
+            out.push_back(job.output);
+            if (!job.audioInput.empty())
+            {
+                out.push_back("-audio");
+                out.push_back(job.audioInput);
+            }
+            if (time::isValid(job.inOutRange))
+            {
+                out.push_back("-inOutRange");
+                out.push_back(string::Format("{0}/{1}/{2}")
+                                  .arg(job.inOutRange.start_time().to_frames())
+                                  .arg(job.inOutRange.end_time_inclusive()
+                                           .to_frames())
+                                  .arg(job.inOutRange.duration().rate()));
+            }
+            if (job.speed > 0.0)
+            {
+                out.push_back("-speed");
+                out.push_back(string::Format("{0}").arg(job.speed));
+            }
+            if (job.videoLayer > 0)
+            {
+                out.push_back("-outputLayer");
+                out.push_back(string::Format("{0}").arg(job.videoLayer));
+            }
+
+            const auto& ocio = job.ocioOptions;
+            if (ocio.enabled)
+            {
+                const std::vector<std::pair<const char*, std::string> > args =
+                    {{"-ocioInput", ocio.input},
+                     {"-ocioDisplay", ocio.display},
+                     {"-ocioView", ocio.view},
+                     {"-ocioLook", ocio.look}};
+                for (const auto& arg : args)
+                {
+                    if (arg.second.empty())
+                        continue;
+                    out.push_back(arg.first);
+                    out.push_back(arg.second);
+                }
+            }
+
+            const auto& lut = job.lutOptions;
+            if (lut.enabled && !lut.fileName.empty())
+            {
+                out.push_back("-lut");
+                out.push_back(lut.fileName);
+                out.push_back("-lutOrder");
+                out.push_back(string::Format("{0}").arg(lut.order));
+            }
+
+            const auto& options = job.options;
+            switch (options.resolution)
+            {
+            case SaveResolution::kHalfSize:
+                out.push_back("-outputScale");
+                out.push_back("2");
+                break;
+            case SaveResolution::kQuarterSize:
+                out.push_back("-outputScale");
+                out.push_back("4");
+                break;
+            default:
+                break;
+            }
+#ifdef TLRENDER_FFMPEG
+            out.push_back("-outputProfile");
+            out.push_back(string::Format("{0}").arg(options.ffmpegProfile));
+            if (!options.ffmpegPreset.empty())
+            {
+                out.push_back("-outputPreset");
+                out.push_back(options.ffmpegPreset);
+            }
+            out.push_back("-outputPixelFormat");
+            out.push_back(options.ffmpegPixelFormat);
+            out.push_back("-outputAudioCodec");
+            out.push_back(string::Format("{0}").arg(options.ffmpegAudioCodec));
+            if (options.ffmpegHardwareEncode)
+                out.push_back("-outputHardwareEncode");
+            if (options.ffmpegOverride)
+            {
+                const std::vector<std::pair<const char*, std::string> > args =
+                    {{"-outputColorRange", options.ffmpegColorRange},
+                     {"-outputColorSpace", options.ffmpegColorSpace},
+                     {"-outputColorPrimaries", options.ffmpegColorPrimaries},
+                     {"-outputColorTRC", options.ffmpegColorTRC}};
+                for (const auto& arg : args)
+                {
+                    if (arg.second.empty())
+                        continue;
+                    out.push_back(arg.first);
+                    out.push_back(arg.second);
+                }
+            }
+#endif
+#ifdef TLRENDER_EXR
+            out.push_back("-outputCompression");
+            out.push_back(string::Format("{0}").arg(options.exrCompression));
+            out.push_back("-outputPixelType");
+            out.push_back(string::Format("{0}").arg(options.exrPixelType));
+#endif
+            out.push_back("-outputZipLevel");
+            out.push_back(
+                string::Format("{0}").arg(options.zipCompressionLevel));
+            out.push_back("-outputDWALevel");
+            out.push_back(
+                string::Format("{0}").arg(options.dwaCompressionLevel));
+            return out;
+        }
+    } // namespace
+
+    struct RenderQueue::Private
+    {
+        mutable std::mutex mutex;
+        std::vector<RenderJob> jobs;
+        int nextId = 1;
+        unsigned maxJobs = 1;
+
+        //! Processes of the running jobs.
+        std::map<int, std::shared_ptr<Process> > processes;
+
+        //! Threads of the jobs and the ids of those that ended and can be
+        //! joined.
+        std::map<int, std::thread> threads;
+        std::vector<int> finished;
+        bool stopped = false;
+
+        std::function<void()> callback;
+    };
+
+    RenderQueue::RenderQueue() :
+        _p(new Private)
+    {
+        // Each job decodes and encodes with several threads already.
+        _p->maxJobs = std::max(1U, cpu_count() / 4);
+    }
+
+    RenderQueue::~RenderQueue()
+    {
+        TLRENDER_P();
+
+        // Take the threads under the lock, as the jobs that end join the
+        // finished threads too.
+        std::map<int, std::thread> threads;
+        {
+            std::unique_lock<std::mutex> lock(p.mutex);
+            p.stopped = true;
+            p.callback = nullptr;
+            for (const auto& i : p.processes)
+                i.second->kill();
+            threads.swap(p.threads);
+            p.finished.clear();
+        }
+        for (auto& i : threads)
+            i.second.join();
+    }
+
+    int RenderQueue::add(RenderJob job)
+    {
+        TLRENDER_P();
+        int id;
+        {
+            std::unique_lock<std::mutex> lock(p.mutex);
+            id = job.id = p.nextId++;
+            job.status = RenderJob::Status::Queued;
+            p.jobs.push_back(job);
+        }
+        _changed();
+        _startJobs();
+        return id;
+    }
+
+    void RenderQueue::cancel(int id)
+    {
+        TLRENDER_P();
+        {
+            std::unique_lock<std::mutex> lock(p.mutex);
+            for (auto& job : p.jobs)
+            {
+                if (job.id != id)
+                    continue;
+                if (job.status == RenderJob::Status::Queued)
+                {
+                    job.status = RenderJob::Status::Cancelled;
+                }
+                else if (job.status == RenderJob::Status::Running)
+                {
+                    // The job's thread sets the status when the process
+                    // exits.
+                    job.status = RenderJob::Status::Cancelled;
+                    const auto i = p.processes.find(id);
+                    if (i != p.processes.end())
+                        i->second->kill();
+                }
+                break;
+            }
+        }
+        _changed();
+    }
+
+    void RenderQueue::clearFinished()
+    {
+        TLRENDER_P();
+        _joinFinished();
+        {
+            std::unique_lock<std::mutex> lock(p.mutex);
+            p.jobs.erase(
+                std::remove_if(
+                    p.jobs.begin(), p.jobs.end(),
+                    [&p](const RenderJob& job)
+                    {
+                        return job.status != RenderJob::Status::Queued &&
+                               p.processes.find(job.id) == p.processes.end();
+                    }),
+                p.jobs.end());
+        }
+        _changed();
+    }
+
+    std::vector<RenderJob> RenderQueue::jobs() const
+    {
+        std::unique_lock<std::mutex> lock(_p->mutex);
+        return _p->jobs;
+    }
+
+    void RenderQueue::setMaxJobs(unsigned value)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_p->mutex);
+            _p->maxJobs = std::max(1U, value);
+        }
+        _startJobs();
+    }
+
+    unsigned RenderQueue::maxJobs() const
+    {
+        std::unique_lock<std::mutex> lock(_p->mutex);
+        return _p->maxJobs;
+    }
+
+    void RenderQueue::setCallback(const std::function<void()>& value)
+    {
+        std::unique_lock<std::mutex> lock(_p->mutex);
+        _p->callback = value;
+    }
+
+    void RenderQueue::_startJobs()
+    {
+        TLRENDER_P();
+
+        _joinFinished();
+
+        std::unique_lock<std::mutex> lock(p.mutex);
+        if (p.stopped)
+            return;
+
+        for (auto& job : p.jobs)
+        {
+            if (p.processes.size() >= p.maxJobs)
+                break;
+            if (job.status != RenderJob::Status::Queued)
+                continue;
+
+            const auto args = getArguments(job);
+            try
+            {
+                p.processes[job.id] = std::make_shared<Process>(args);
+                job.status = RenderJob::Status::Running;
+                if (time::isValid(job.inOutRange))
+                    job.frame = job.inOutRange.start_time().to_frames();
+                p.threads[job.id] = std::thread(
+                    [this, id = job.id, args] { _run(id, args); });
+            }
+            catch (const std::exception& e)
+            {
+                job.status = RenderJob::Status::Failed;
+                job.message = e.what();
+                LOG_ERROR(e.what());
+            }
+        }
+    }
+
+    void RenderQueue::_run(int id, const std::vector<std::string>& args)
+    {
+        TLRENDER_P();
+
+        std::shared_ptr<Process> process;
+        {
+            std::unique_lock<std::mutex> lock(p.mutex);
+            process = p.processes[id];
+        }
+
+        const std::string progress = kRenderProgress;
+        std::string line;
+        while (process->readLine(line))
+        {
+            if (line.empty())
+                continue;
+            {
+                std::unique_lock<std::mutex> lock(p.mutex);
+                auto i = std::find_if(
+                    p.jobs.begin(), p.jobs.end(),
+                    [id](const RenderJob& job) { return job.id == id; });
+                if (i == p.jobs.end())
+                    continue;
+                if (line.compare(0, progress.size(), progress) == 0)
+                    i->frame = std::atoll(line.c_str() + progress.size());
+                else
+                    i->message = line;
+            }
+            _changed();
+        }
+
+        // Stop killing the process once it is exiting, as its pid may be
+        // reused.
+        {
+            std::unique_lock<std::mutex> lock(p.mutex);
+            p.processes.erase(id);
+        }
+        const int exitCode = process->wait();
+
+        {
+            std::unique_lock<std::mutex> lock(p.mutex);
+            for (auto& job : p.jobs)
+            {
+                if (job.id != id)
+                    continue;
+                if (job.status == RenderJob::Status::Running)
+                {
+                    job.status = exitCode == 0 ? RenderJob::Status::Done
+                                               : RenderJob::Status::Failed;
+                }
+                const std::string msg =
+                    string::Format(_("Render job {0} {1}: {2}"))
+                        .arg(id)
+                        .arg(exitCode == 0 ? _("finished") : _("failed"))
+                        .arg(job.output);
+                if (exitCode == 0)
+                    LOG_INFO(msg);
+                else
+                    LOG_ERROR(msg << " " << job.message);
+                break;
+            }
+        }
+        _changed();
+
+        bool stopped;
+        {
+            std::unique_lock<std::mutex> lock(p.mutex);
+            stopped = p.stopped;
+        }
+        if (!stopped)
+            _startJobs();
+
+        // Last thing the thread does, so it can be joined by the next call
+        // to _startJobs() or clearFinished().
+        std::unique_lock<std::mutex> lock(p.mutex);
+        p.finished.push_back(id);
+    }
+
+    void RenderQueue::_joinFinished()
+    {
+        TLRENDER_P();
+
+        std::vector<std::thread> threads;
+        {
+            std::unique_lock<std::mutex> lock(p.mutex);
+            for (int id : p.finished)
+            {
+                auto i = p.threads.find(id);
+                if (i == p.threads.end())
+                    continue;
+                threads.push_back(std::move(i->second));
+                p.threads.erase(i);
+            }
+            p.finished.clear();
+        }
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+    void RenderQueue::_changed()
+    {
+        std::function<void()> callback;
+        {
+            std::unique_lock<std::mutex> lock(_p->mutex);
+            callback = _p->callback;
+        }
+        if (callback)
+            callback();
+    }
+
+} // namespace mrv
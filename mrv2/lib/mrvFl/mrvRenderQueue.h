@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// mrv2
+// Copyright Contributors to the mrv2 Project. All rights reserved.
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <tlCore/Time.h>
+#include <tlCore/Util.h>
+
+#include <tlTimeline/LUTOptions.h>
+#include <tlTimeline/OCIOOptions.h>
+
+#include "mrvFl/mrvSaveOptions.h"
+
+namespace mrv
+{
+    using namespace tl;
+
+    //! Prefix of the lines that saves run with -output print with the
+    //! frame they just saved.
+    extern const char* kRenderProgress;
+
+    //! A job of the render queue.
+    struct RenderJob
+    {
+        enum class Status { Queued, Running, Done, Failed, Cancelled };
+
+        int id = 0;
+
+        //! Media to save, its separate audio if any and the file to save
+        //! it to.
+        std::string input;
+        std::string audioInput;
+        std::string output;
+
+        otime::TimeRange inOutRange = time::invalidTimeRange;
+        double speed = 0.0;
+        int videoLayer = 0;
+        timeline::OCIOOptions ocioOptions;
+        timeline::LUTOptions lutOptions;
+        SaveOptions options;
+
+        Status status = Status::Queued;
+
+        //! Last frame saved.
+        int64_t frame = 0;
+
+        //! Last message printed by the job, like an error.
+        std::string message;
+    };
+
+    //! Queue of jobs that save movies, sequences or images in the
+    //! background.  Each job runs in a separate mrv2 -output process, with
+    //! its own timeline and OpenGL context, so the viewer stays responsive
+    //! and several jobs run at once.
+    class RenderQueue
+    {
+    public:
+        RenderQueue();
+
+        //! Cancels the running jobs.
+        ~RenderQueue();
+
+        //! Add a job and return its id.
+        int add(RenderJob job);
+
+        //! Cancel a queued or running job.
+        void cancel(int id);
+
+        //! Remove the jobs that are no longer queued or running.
+        void clearFinished();
+
+        std::vector<RenderJob> jobs() const;
+
+        //! Set the maximum number of jobs that run at once.
+        void setMaxJobs(unsigned value);
+        unsigned maxJobs() const;
+
+        //! Set a function called when a job changes.  It is called from
+        //! the threads that run the jobs.
+        void setCallback(const std::function<void()>& value);
+
+    private:
+        void _startJobs();
+        void _joinFinished();
+        void _run(int id, const std::vector<std::string>& args);
+        void _changed();
+
+        TLRENDER_PRIVATE();
+    };
+
+} // namespace mrv
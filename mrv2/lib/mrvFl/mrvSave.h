@@ -4,20 +4,50 @@
 
 #include <tlIO/IO.h>
 
+#include <tlTimeline/BackgroundOptions.h>
+#include <tlTimeline/LUTOptions.h>
+#include <tlTimeline/OCIOOptions.h>
+#include <tlTimeline/Player.h>
+
 #include "mrvSaveOptions.h"
 
 class ViewerUI;
 
 namespace mrv
 {
+    using namespace tl;
+
+    //! What gets saved.  The viewer fills it in, but saving from the
+    //! command-line (-output) fills it in without creating the interface.
+    struct SaveSource
+    {
+        std::shared_ptr<timeline::Player> player;
+        int videoLayer = 0;
+        timeline::OCIOOptions ocioOptions;
+        timeline::LUTOptions lutOptions;
+        timeline::BackgroundOptions backgroundOptions;
+    };
 
     //! Save single frame.  Returns 0 if successful, -1 if not.
     int save_single_frame(
         const std::string& file, const ViewerUI* ui,
         SaveOptions options = SaveOptions());
 
-    void save_movie(
+    //! Save single frame without the interface.  Returns 0 if successful,
+    //! -1 if not.
+    int save_single_frame(
+        const std::string& file, const SaveSource& source,
+        SaveOptions options = SaveOptions());
+
+    //! Save movie, sequence or audio.  Returns 0 if successful, -1 if not.
+    int save_movie(
         const std::string& file, const ViewerUI* ui,
         SaveOptions options = SaveOptions());
 
+    //! Save movie, sequence or audio without the interface.  Returns 0 if
+    //! successful, -1 if not.
+    int save_movie(
+        const std::string& file, const SaveSource& source,
+        SaveOptions options = SaveOptions());
+
 } // namespace mrv
@@ -2,6 +2,7 @@
 // mrv2
 // Copyright Contributors to the mrv2 Project. All rights reserved.
 
+#include <memory>
 #include <string>
 #include <sstream>
 #include <filesystem>
@@ -24,9 +25,11 @@ namespace fs = std::filesystem;
 #include "mrvWidgets/mrvProgressReport.h"
 
 #include "mrvGL/mrvGLErrors.h"
+#include "mrvGL/mrvGLOffscreenContext.h"
 
 #include "mrvNetwork/mrvTCP.h"
 
+#include "mrvFl/mrvSave.h"
 #include "mrvFl/mrvSaveOptions.h"
 #include "mrvFl/mrvIO.h"
 
@@ -42,18 +45,20 @@ namespace
 
 namespace mrv
 {
-
-    int save_single_frame(
-        const std::string& file, const ViewerUI* ui, SaveOptions options)
+    //! Save a single frame.  The ui is null when saving from the
+    //! command-line.
+    static int saveSingleFrame(
+        const std::string& file, const ViewerUI* ui, const SaveSource& source,
+        SaveOptions options)
     {
         std::string msg;
 
         int ret = 0;
-        Viewport* view = ui->uiView;
-        bool presentation = view->getPresentationMode();
-        bool hud = view->getHudActive();
+        Viewport* view = ui ? ui->uiView : nullptr;
+        const bool presentation = view && view->getPresentationMode();
+        const bool hud = view && view->getHudActive();
 
-        auto player = view->getTimelinePlayer();
+        const auto& player = source.player;
         if (!player)
             return -1; // should never happen
 
@@ -66,10 +71,10 @@ namespace mrv
         }
 
         // Stop the playback
-        player->stop();
+        player->setPlayback(timeline::Playback::Stop);
 
         // Time range.
-        auto currentTime = player->currentTime();
+        auto currentTime = player->observeCurrentTime()->get();
 
         const std::string& extension = path.getExtension();
 
@@ -100,11 +105,11 @@ namespace mrv
             otime::TimeRange oneFrameTimeRange(
                 currentTime, otime::RationalTime(1, currentTime.rate()));
 
-            auto context = ui->app->getContext();
-            auto timeline = player->timeline();
+            auto context = player->getContext();
+            auto timeline = player->getTimeline();
 
             // Render information.
-            const auto& info = player->ioInfo();
+            const auto& info = player->getIOInfo();
             if (info.video.empty())
             {
                 throw std::runtime_error("No video information");
@@ -114,15 +119,26 @@ namespace mrv
             std::shared_ptr<timeline_gl::Render> render;
             image::Size renderSize;
 
-            int layerId = ui->uiColorChannel->value();
-            if (layerId < 0)
+            int layerId = source.videoLayer;
+            if (layerId < 0 || layerId >= info.video.size())
                 layerId = 0;
 
+            // Without the viewer window shown (ie. when saving from the
+            // command-line), there is no viewport to capture annotations
+            // from.
+            const bool interactive = view && view->visible_r();
+            if (!interactive && options.annotations)
+            {
+                LOG_WARNING(_("Annotations can only be saved with the "
+                              "viewer window shown.  Saving without them."));
+                options.annotations = false;
+            }
+
             const SaveResolution resolution = options.resolution;
             {
                 renderSize = info.video[layerId].size;
-                auto rotation = ui->uiView->getRotation();
-                if (options.annotations && rotationSign(rotation) != 0)
+                if (options.annotations &&
+                    rotationSign(view->getRotation()) != 0)
                 {
                     size_t tmp = renderSize.w;
                     renderSize.w = renderSize.h;
@@ -150,6 +166,19 @@ namespace mrv
                 }
             }
 
+            std::unique_ptr<opengl::OffscreenContext> offscreenContext;
+            if (interactive)
+            {
+                view->make_current();
+                gl::initGLAD();
+            }
+            else
+            {
+                // Create an invisible context, which works without a
+                // display too.
+                offscreenContext = std::make_unique<opengl::OffscreenContext>();
+            }
+
             // Create the renderer.
             render = timeline_gl::Render::create(context);
             offscreenBufferOptions.colorType = image::PixelType::RGBA_F32;
@@ -312,12 +341,16 @@ namespace mrv
             }
 
             // Turn off hud so it does not get captured by glReadPixels.
-            view->setHudActive(false);
+            if (view)
+                view->setHudActive(false);
 
             math::Size2i offscreenBufferSize(renderSize.w, renderSize.h);
 
-            view->make_current();
-            gl::initGLAD();
+            if (interactive)
+            {
+                view->make_current();
+                gl::initGLAD();
+            }
 
             auto buffer = gl::OffscreenBuffer::create(
                 offscreenBufferSize, offscreenBufferOptions);
@@ -355,8 +388,11 @@ namespace mrv
                 const auto& videoData =
                     timeline->getVideo(currentTime).future.get();
 
-                view->make_current();
-                gl::initGLAD();
+                if (interactive)
+                {
+                    view->make_current();
+                    gl::initGLAD();
+                }
 
                 // Render the video.
                 gl::OffscreenBufferBinding binding(buffer);
@@ -364,16 +400,15 @@ namespace mrv
                 {
                     locale::SetAndRestore saved;
                     render->begin(offscreenBufferSize);
-                    render->setOCIOOptions(view->getOCIOOptions());
-                    render->setLUTOptions(view->lutOptions());
+                    render->setOCIOOptions(source.ocioOptions);
+                    render->setLUTOptions(source.lutOptions);
                     CHECK_GL;
                     render->drawVideo(
                         {videoData},
                         {math::Box2i(0, 0, renderSize.w, renderSize.h)},
                         {timeline::ImageOptions()},
                         {timeline::DisplayOptions()},
-                        timeline::CompareOptions(),
-                        ui->uiView->getBackgroundOptions());
+                        timeline::CompareOptions(), source.backgroundOptions);
                     CHECK_GL;
                     render->end();
                 }
@@ -418,10 +453,39 @@ namespace mrv
             ret = -1;
         }
 
-        view->setFrameView(ui->uiPrefs->uiPrefsAutoFitImage->value());
-        view->setHudActive(hud);
-        view->setPresentationMode(presentation);
+        if (view)
+        {
+            view->setFrameView(ui->uiPrefs->uiPrefsAutoFitImage->value());
+            view->setHudActive(hud);
+            view->setPresentationMode(presentation);
+        }
         return ret;
     }
 
+    int save_single_frame(
+        const std::string& file, const ViewerUI* ui, SaveOptions options)
+    {
+        Viewport* view = ui->uiView;
+        auto player = view->getTimelinePlayer();
+        if (!player)
+            return -1; // should never happen
+
+        // Stop the playback, letting the network know.
+        player->stop();
+
+        SaveSource source;
+        source.player = player->player();
+        source.videoLayer = ui->uiColorChannel->value();
+        source.ocioOptions = view->getOCIOOptions();
+        source.lutOptions = view->lutOptions();
+        source.backgroundOptions = view->getBackgroundOptions();
+        return saveSingleFrame(file, ui, source, options);
+    }
+
+    int save_single_frame(
+        const std::string& file, const SaveSource& source, SaveOptions options)
+    {
+        return saveSingleFrame(file, nullptr, source, options);
+    }
+
 } // namespace mrv
@@ -2,8 +2,14 @@
 // mrv2
 // Copyright Contributors to the mrv2 Project. All rights reserved.
 
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
 #include <string>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 #include <tlIO/System.h>
 
@@ -13,7 +19,6 @@
 
 #include <tlGL/Init.h>
 #include <tlGL/Util.h>
-#include <tlGL/GLFWWindow.h>
 
 #include <tlTimelineGL/Render.h>
 
@@ -24,14 +29,18 @@
 #include "mrvWidgets/mrvProgressReport.h"
 
 #include "mrvGL/mrvGLErrors.h"
+#include "mrvGL/mrvGLOffscreenContext.h"
 
 #include "mrvNetwork/mrvTCP.h"
 
+#include "mrvFl/mrvSave.h"
 #include "mrvFl/mrvSaveOptions.h"
 #include "mrvFl/mrvIO.h"
+#include "mrvFl/mrvRenderQueue.h"
 
 #include "mrvUI/mrvDesktop.h"
 
+#include "mrvApp/mrvApp.h"
 #include "mrvApp/mrvSettingsObject.h"
 
 #include "mrViewer.h"
@@ -43,41 +52,224 @@ namespace
 
 namespace mrv
 {
+    namespace
+    {
+        //! Number of pixel buffers the rendered frames are read back into,
+        //! so that the read back of a frame overlaps with the rendering of
+        //! the following ones.
+        const size_t kReadbackBuffers = 3;
 
-    void
-    save_movie(const std::string& file, const ViewerUI* ui, SaveOptions options)
+        //! Maximum number of frames waiting for the writer thread.
+        const size_t kMaxQueuedFrames = 4;
+
+        //! A frame's worth of data to write.
+        struct WriteFrame
+        {
+            otime::RationalTime time = time::invalidTime;
+            std::shared_ptr<image::Image> image;
+            otime::TimeRange audioRange = time::invalidTimeRange;
+            std::shared_ptr<audio::Audio> audio;
+        };
+
+        //! Pixel buffer objects to read back frames asynchronously.
+        struct PixelBuffers
+        {
+            PixelBuffers(size_t count, size_t byteCount) :
+                ids(count, 0)
+            {
+                glGenBuffers(static_cast<GLsizei>(count), ids.data());
+                for (auto id : ids)
+                {
+                    glBindBuffer(GL_PIXEL_PACK_BUFFER, id);
+                    glBufferData(
+                        GL_PIXEL_PACK_BUFFER, byteCount, nullptr,
+                        GL_STREAM_READ);
+                }
+                glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            }
+
+            ~PixelBuffers()
+            {
+                glDeleteBuffers(static_cast<GLsizei>(ids.size()), ids.data());
+            }
+
+            std::vector<GLuint> ids;
+        };
+
+        //! Thread that writes the frames in order, so that encoding
+        //! overlaps with decoding and rendering.  The queue is bounded to
+        //! limit the memory used when the writer is the bottleneck.
+        class WriterThread
+        {
+        public:
+            WriterThread(const std::shared_ptr<io::IWrite>& writer) :
+                _writer(writer)
+            {
+                _thread = std::thread([this] { _run(); });
+            }
+
+            ~WriterThread()
+            {
+                try
+                {
+                    finish();
+                }
+                catch (const std::exception&)
+                {
+                }
+            }
+
+            //! Queue a frame, waiting while the queue is full.  Throws if
+            //! writing a previous frame failed.
+            void push(WriteFrame&& frame)
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _cv.wait(
+                    lock,
+                    [this]
+                    {
+                        return _queue.size() < kMaxQueuedFrames ||
+                               !_error.empty();
+                    });
+                if (!_error.empty())
+                    throw std::runtime_error(_error);
+                _queue.push_back(std::move(frame));
+                _cv.notify_all();
+            }
+
+            //! Return an image no longer used by the writer or a new one.
+            std::shared_ptr<image::Image> getImage(const image::Info& info)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    if (!_images.empty())
+                    {
+                        auto out = _images.back();
+                        _images.pop_back();
+                        return out;
+                    }
+                }
+                return image::Image::create(info);
+            }
+
+            //! Write the queued frames and stop the thread.  Throws if
+            //! writing a frame failed.
+            void finish()
+            {
+                if (_thread.joinable())
+                {
+                    {
+                        std::unique_lock<std::mutex> lock(_mutex);
+                        _done = true;
+                    }
+                    _cv.notify_all();
+                    _thread.join();
+                }
+                if (!_error.empty())
+                    throw std::runtime_error(_error);
+            }
+
+        private:
+            void _run()
+            {
+                while (true)
+                {
+                    WriteFrame frame;
+                    {
+                        std::unique_lock<std::mutex> lock(_mutex);
+                        _cv.wait(
+                            lock, [this] { return !_queue.empty() || _done; });
+                        if (_queue.empty())
+                            return;
+                        frame = std::move(_queue.front());
+                        _queue.pop_front();
+                    }
+                    _cv.notify_all();
+
+                    try
+                    {
+                        if (frame.audio)
+                            _writer->writeAudio(frame.audioRange, frame.audio);
+                        if (frame.image)
+                            _writer->writeVideo(frame.time, frame.image);
+                    }
+                    catch (const std::exception& e)
+                    {
+                        std::unique_lock<std::mutex> lock(_mutex);
+                        _error = e.what();
+                        _queue.clear();
+                        _cv.notify_all();
+                        return;
+                    }
+
+                    // Recycle the image if the writer did not keep it.
+                    if (frame.image && frame.image.use_count() == 1)
+                    {
+                        std::unique_lock<std::mutex> lock(_mutex);
+                        _images.push_back(frame.image);
+                    }
+                }
+            }
+
+            std::shared_ptr<io::IWrite> _writer;
+            std::thread _thread;
+            std::mutex _mutex;
+            std::condition_variable _cv;
+            std::deque<WriteFrame> _queue;
+            std::vector<std::shared_ptr<image::Image> > _images;
+            std::string _error;
+            bool _done = false;
+        };
+
+        //! A frame waiting for its pixels to be read back.
+        struct PendingFrame
+        {
+            WriteFrame frame;
+
+            //! Index of the pixel buffer holding its pixels, or -1.
+            int buffer = -1;
+        };
+    } // namespace
+
+    //! Save a movie, sequence or audio.  The ui is null when saving from
+    //! the command-line.
+    static int saveMovie(
+        const std::string& file, const ViewerUI* ui, const SaveSource& source,
+        SaveOptions options)
     {
         std::string msg;
-        Viewport* view = ui->uiView;
-        bool presentation = view->getPresentationMode();
-        bool hud = view->getHudActive();
 
-        auto player = view->getTimelinePlayer();
+        int ret = 0;
+        Viewport* view = ui ? ui->uiView : nullptr;
+        const bool presentation = view && view->getPresentationMode();
+        const bool hud = view && view->getHudActive();
+
+        const auto& player = source.player;
         if (!player)
-            return; // should never happen
+            return -1; // should never happen
 
         file::Path path(file);
 
         if (file::isTemporaryEDL(path))
         {
             LOG_ERROR(_("Cannot save an NDI stream"));
-            return;
+            return -1;
         }
 
         // Stop the playback
-        player->stop();
+        player->setPlayback(timeline::Playback::Stop);
 
         // Time range.
-        auto timeRange = player->inOutRange();
-        auto speed = player->speed();
+        auto timeRange = player->observeInOutRange()->get();
+        auto speed = player->observeSpeed()->get();
         auto startTime = timeRange.start_time();
         auto endTime = timeRange.end_time_inclusive();
         auto currentTime = startTime;
 
-        auto mute = player->isMuted();
+        auto mute = player->observeMute()->get();
         player->setMute(true);
-        
-        auto context = ui->app->getContext();
+
+        auto context = player->getContext();
 
         // Get I/O cache and store its size.
         auto ioSystem = context->getSystem<io::System>();
@@ -106,9 +298,7 @@ namespace mrv
             // If we are not saving a movie, take speed from the player's
             // current speed.
             {
-                const auto& model = ui->app->filesModel();
-                const auto& Aitem = model->observeA()->get();
-                const auto& extension = Aitem->path.getExtension();
+                const auto& extension = player->getPath().getExtension();
                 if (!file::isMovie(extension))
                 {
                     ioOptions["FFmpeg/Speed"] =
@@ -157,16 +347,11 @@ namespace mrv
             }
 #endif
 
-            auto model = ui->app->filesModel();
-            auto Aitem = model->observeA()->get();
-            std::string inputFile = Aitem->path.get();
-
             // Make I/O cache be 1Gb to deal with long movies fine.
             size_t bytes = memory::gigabyte;
             cache->setMax(bytes);
 
-            auto context = ui->app->getContext();
-            auto timeline = player->timeline();
+            auto timeline = player->getTimeline();
 
             auto startTimeOpt = timeline->getTimeline()->global_start_time();
             if (startTime.value() > 0.0 || startTimeOpt.has_value())
@@ -201,13 +386,13 @@ namespace mrv
             LOG_INFO(msg);
 
             // Render information.
-            const auto& info = player->ioInfo();
+            const auto& info = player->getIOInfo();
 
             auto videoTime = info.videoTime;
 
             const bool hasVideo = !info.video.empty();
 
-            if (player->timeRange() != timeRange ||
+            if (player->getTimeRange() != timeRange ||
                 info.videoTime.start_time() != timeRange.start_time())
             {
                 double videoRate = info.videoTime.duration().rate();
@@ -222,7 +407,7 @@ namespace mrv
             if (hasAudio)
             {
                 audioTime = info.audioTime;
-                if (player->timeRange() != timeRange ||
+                if (player->getTimeRange() != timeRange ||
                     audioTime.start_time() !=
                         timeRange.start_time().rescaled_to(sampleRate))
                 {
@@ -313,7 +498,7 @@ namespace mrv
             const size_t maxAudioSampleCount =
                 timeRange.duration().rescaled_to(sampleRate).value();
 
-            const std::string& originalFile = player->path().get();
+            const std::string& originalFile = player->getPath().get();
             if (originalFile == file)
             {
                 throw std::runtime_error(
@@ -324,15 +509,27 @@ namespace mrv
             gl::OffscreenBufferOptions offscreenBufferOptions;
             std::shared_ptr<timeline_gl::Render> render;
             image::Size renderSize;
-            int layerId = ui->uiColorChannel->value();
-
+            int layerId = source.videoLayer;
+            if (layerId < 0 || layerId >= info.video.size())
+                layerId = 0;
+
+            // Without the viewer window shown (ie. when saving from the
+            // command-line), there is no viewport to capture annotations
+            // from.
+            const bool interactive = view && view->visible_r();
+            if (!interactive && options.annotations)
+            {
+                LOG_WARNING(_("Annotations can only be saved with the "
+                              "viewer window shown.  Saving without them."));
+                options.annotations = false;
+            }
 
             const SaveResolution resolution = options.resolution;
             if (hasVideo)
             {
                 renderSize = info.video[layerId].size;
-                auto rotation = ui->uiView->getRotation();
-                if (options.annotations && rotationSign(rotation) != 0)
+                if (options.annotations &&
+                    rotationSign(view->getRotation()) != 0)
                 {
                     size_t tmp = renderSize.w;
                     renderSize.w = renderSize.h;
@@ -361,16 +558,12 @@ namespace mrv
             }
 
 
-            bool interactive = ui->uiView->visible_r();
-            std::shared_ptr<gl::GLFWWindow> window;
+            std::unique_ptr<opengl::OffscreenContext> offscreenContext;
             if (!interactive)
             {
-                // Create the window.
-                window = gl::GLFWWindow::create(
-                    "bake",
-                    math::Size2i(1, 1),
-                    context,
-                    static_cast<int>(gl::GLFWWindowOptions::MakeCurrent));
+                // Create an invisible context, which works without a
+                // display too.
+                offscreenContext = std::make_unique<opengl::OffscreenContext>();
             }
             
             // Create the renderer.
@@ -395,7 +588,6 @@ namespace mrv
             image::Info outputInfo;
 
             outputInfo.size = renderSize;
-            std::shared_ptr<image::Image> outputImage;
 
             outputInfo.pixelType = info.video[layerId].pixelType;
 
@@ -515,7 +707,6 @@ namespace mrv
                           .arg(outputInfo.pixelType);
                 LOG_INFO(msg);
 
-                outputImage = image::Image::create(outputInfo);
                 ioInfo.videoTime = videoTime;
                 ioInfo.video.push_back(outputInfo);
 
@@ -591,12 +782,16 @@ namespace mrv
             {
                 LOG_ERROR(
                     _("Audio only in timeline, but not trying to save audio."));
-                return;
+                return -1;
             }
 
-            ProgressReport progress(ui->uiMain, startFrame, endFrame, title);
+            std::unique_ptr<ProgressReport> progress;
             if (interactive)
-                progress.show();
+            {
+                progress = std::make_unique<ProgressReport>(
+                    ui->uiMain, startFrame, endFrame, title);
+                progress->show();
+            }
 
             bool running = true;
 
@@ -619,10 +814,22 @@ namespace mrv
                       .arg(offscreenBufferOptions.colorType);
             LOG_INFO(msg);
 
+            // Keep several frames decoding ahead of the one being rendered.
+            auto settings = App::app->settings();
+            const size_t prefetchFrames = std::max(
+                1, settings->getValue<int>("Performance/VideoRequestCount"));
+            std::deque<
+                std::pair<otime::RationalTime, std::future<timeline::VideoData> > >
+                videoRequests;
+            auto requestTime = startTime;
+
+            WriterThread writerThread(writer);
+
             player->start();
 
             // Turn off hud so it does not get captured by glReadPixels.
-            view->setHudActive(false);
+            if (view)
+                view->setHudActive(false);
 
             math::Size2i offscreenBufferSize(renderSize.w, renderSize.h);
             std::shared_ptr<gl::OffscreenBuffer> buffer;
@@ -639,6 +846,49 @@ namespace mrv
                     offscreenBufferSize, offscreenBufferOptions);
             }
 
+            std::unique_ptr<PixelBuffers> pixelBuffers;
+            if (hasVideo && !options.annotations)
+            {
+                pixelBuffers = std::make_unique<PixelBuffers>(
+                    kReadbackBuffers, image::getDataByteCount(outputInfo));
+            }
+            int bufferIndex = 0;
+
+            // Frames are handed to the writer thread in order once their
+            // pixels have been read back.
+            std::deque<PendingFrame> pending;
+            auto writePending = [&]()
+            {
+                PendingFrame& pendingFrame = pending.front();
+                if (pendingFrame.buffer >= 0)
+                {
+                    glBindBuffer(
+                        GL_PIXEL_PACK_BUFFER,
+                        pixelBuffers->ids[pendingFrame.buffer]);
+                    const void* data =
+                        glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+                    if (data)
+                    {
+                        auto outputImage = writerThread.getImage(outputInfo);
+                        memcpy(
+                            outputImage->getData(), data,
+                            outputImage->getDataByteCount());
+                        pendingFrame.frame.image = outputImage;
+                        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+                    }
+                    else
+                    {
+                        std::string err =
+                            string::Format(_("Could not read back frame {0}."))
+                                .arg(pendingFrame.frame.time);
+                        LOG_ERROR(err);
+                    }
+                    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+                }
+                writerThread.push(std::move(pendingFrame.frame));
+                pending.pop_front();
+            };
+
             size_t totalSamples = 0;
             size_t currentSampleCount =
                 startTime.rescaled_to(sampleRate).value();
@@ -647,16 +897,29 @@ namespace mrv
             {
                 context->tick();
 
+                WriteFrame frame;
+                int frameBuffer = -1;
+
                 // If progress window is closed, exit loop.
                 if (interactive)
                 {
-                    if(!progress.tick())
+                    if (!progress->tick())
                         break;
                 }
                 else
                 {
                     msg = string::Format(_("Saving... {0}")).arg(currentTime);
                     LOG_INFO(msg);
+
+                    // Report the progress to the render queue that runs
+                    // this save.
+                    if (App::app->isBatch())
+                    {
+                        trace::print(
+                            string::Format("{0}{1}\n")
+                                .arg(kRenderProgress)
+                                .arg(currentTime.to_frames()));
+                    }
                 }
 
                 if (hasAudio)
@@ -722,7 +985,8 @@ namespace mrv
                         {
                             if (!skip)
                             {
-                                writer->writeAudio(range, audio);
+                                frame.audioRange = range;
+                                frame.audio = audio;
 
                                 const size_t sampleCount =
                                     audio->getSampleCount();
@@ -753,15 +1017,31 @@ namespace mrv
                         glReadBuffer(imageBuffer);
 
                         glReadBuffer(GL_FRONT);
-                        glReadPixels(
-                            X, Y, outputInfo.size.w, outputInfo.size.h, format,
-                            type, outputImage->getData());
+                        if (videoTime.contains(currentTime))
+                        {
+                            frame.time = currentTime;
+                            frame.image = writerThread.getImage(outputInfo);
+                            glReadPixels(
+                                X, Y, outputInfo.size.w, outputInfo.size.h,
+                                format, type, frame.image->getData());
+                        }
                     }
                     else
                     {
+                        while (videoRequests.size() < prefetchFrames &&
+                               requestTime <= endTime)
+                        {
+                            videoRequests.push_back(std::make_pair(
+                                requestTime,
+                                timeline->getVideo(requestTime).future));
+                            requestTime +=
+                                otime::RationalTime(1, requestTime.rate());
+                        }
+
                         // Get the videoData
                         const auto videoData =
-                            timeline->getVideo(currentTime).future.get();
+                            videoRequests.front().second.get();
+                        videoRequests.pop_front();
                         if (videoData.layers.empty() ||
                             !videoData.layers[0].image)
                         {
@@ -793,15 +1073,15 @@ namespace mrv
                         {
                             locale::SetAndRestore saved;
                             render->begin(offscreenBufferSize);
-                            render->setOCIOOptions(view->getOCIOOptions());
-                            render->setLUTOptions(view->lutOptions());
+                            render->setOCIOOptions(source.ocioOptions);
+                            render->setLUTOptions(source.lutOptions);
                             render->drawVideo(
                                 {videoData},
                                 {math::Box2i(0, 0, renderSize.w, renderSize.h)},
                                 {timeline::ImageOptions()},
                                 {timeline::DisplayOptions()},
                                 timeline::CompareOptions(),
-                                ui->uiView->getBackgroundOptions());
+                                source.backgroundOptions);
                             render->end();
                         }
 
@@ -813,15 +1093,29 @@ namespace mrv
                             outputInfo.layout.endian != memory::getEndian());
 #endif // TLRENDER_API_GL_4_1
 
-                        glReadPixels(
-                            0, 0, outputInfo.size.w, outputInfo.size.h, format,
-                            type, outputImage->getData());
+                        // Start an asynchronous read back, which is
+                        // mapped once the following frames are rendered.
+                        if (videoTime.contains(currentTime))
+                        {
+                            frame.time = currentTime;
+                            frameBuffer = bufferIndex;
+                            bufferIndex = (bufferIndex + 1) % kReadbackBuffers;
+
+                            glBindBuffer(
+                                GL_PIXEL_PACK_BUFFER,
+                                pixelBuffers->ids[frameBuffer]);
+                            glReadPixels(
+                                0, 0, outputInfo.size.w, outputInfo.size.h,
+                                format, type, nullptr);
+                            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+                        }
                     }
-
-                    if (videoTime.contains(currentTime))
-                        writer->writeVideo(currentTime, outputImage);
                 }
 
+                pending.push_back({std::move(frame), frameBuffer});
+                while (pending.size() >= kReadbackBuffers)
+                    writePending();
+
                 if (hasVideo)
                     currentTime += otime::RationalTime(1, currentTime.rate());
                 else
@@ -844,29 +1138,79 @@ namespace mrv
                         player->seek(currentTime);
                 }
             }
+
+            if (!videoRequests.empty())
+            {
+                timeline->cancelRequests();
+                videoRequests.clear();
+            }
+
+            if (interactive && pixelBuffers)
+                view->make_current();
+            while (!pending.empty())
+                writePending();
+            pixelBuffers.reset();
+
+            writerThread.finish();
         }
         catch (const std::exception& e)
         {
             LOG_ERROR(e.what());
+            ret = -1;
         }
 
-        view->setFrameView(ui->uiPrefs->uiPrefsAutoFitImage->value());
-        view->setHudActive(hud);
-        view->setPresentationMode(presentation);
         player->seek(currentTime);
         player->setMute(mute);
-        ui->uiTimeline->valid(0); // needed
-        ui->uiTimeline->redraw();
         tcp->unlock();
 
-        auto settings = ui->app->settings();
-        if (file::isReadable(newFile))
+        if (ui)
         {
-            settings->addRecentFile(path.get());
-            ui->uiMain->fill_menu(ui->uiMenuBar);
+            view->setFrameView(ui->uiPrefs->uiPrefsAutoFitImage->value());
+            view->setHudActive(hud);
+            view->setPresentationMode(presentation);
+            ui->uiTimeline->valid(0); // needed
+            ui->uiTimeline->redraw();
+
+            auto settings = ui->app->settings();
+            if (file::isReadable(newFile))
+            {
+                settings->addRecentFile(path.get());
+                ui->uiMain->fill_menu(ui->uiMenuBar);
+            }
         }
 
         cache->setMax(oldCacheSize);
+        return ret;
+    }
+
+    int
+    save_movie(const std::string& file, const ViewerUI* ui, SaveOptions options)
+    {
+        Viewport* view = ui->uiView;
+        auto player = view->getTimelinePlayer();
+        if (!player)
+            return -1; // should never happen
+
+        // Stop the playback, letting the network know.
+        player->stop();
+
+        SaveSource source;
+        source.player = player->player();
+        source.videoLayer = ui->uiColorChannel->value();
+        source.ocioOptions = view->getOCIOOptions();
+        source.lutOptions = view->lutOptions();
+        source.backgroundOptions = view->getBackgroundOptions();
+        const int ret = saveMovie(file, ui, source, options);
+
+        // Let the network know where we ended.
+        player->seek(player->currentTime());
+        return ret;
+    }
+
+    int save_movie(
+        const std::string& file, const SaveSource& source, SaveOptions options)
+    {
+        return saveMovie(file, nullptr, source, options);
     }
 
 } // namespace mrv
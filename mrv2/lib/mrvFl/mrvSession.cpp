@@ -165,6 +165,8 @@ namespace mrv
 #endif
                 {"Histogram", (histogramPanel != nullptr)},
                 {"Vectorscope", (vectorscopePanel != nullptr)},
+                {"Waveform", (waveformPanel != nullptr)},
+                {"Render Queue", (renderQueuePanel != nullptr)},
                 {"Stereo 3D", (stereo3DPanel != nullptr)},
 #ifdef TLRENDER_USD
                 {"USD", (usdPanel != nullptr)},
@@ -206,6 +208,10 @@ namespace mrv
                 histogramPanel->save();
             if (vectorscopePanel)
                 vectorscopePanel->save();
+            if (waveformPanel)
+                waveformPanel->save();
+            if (renderQueuePanel)
+                renderQueuePanel->save();
             if (logsPanel)
                 logsPanel->save();
 
@@ -434,11 +440,24 @@ namespace mrv
                 bool autoPlayback = ui->uiPrefs->uiPrefsAutoPlayback->value();
                 ui->uiPrefs->uiPrefsAutoPlayback->value(false);
 
+                // Probe all the media files at once.
+                std::vector<FilesModelItem> items;
+                std::vector<std::string> fileNames;
                 for (const auto& j : session["files"])
                 {
                     FilesModelItem item;
                     j.get_to(item);
 
+                    std::string path = item.path.get();
+                    replace_path(path);
+                    if (item.audioPath.isEmpty())
+                        fileNames.push_back(path);
+                    items.push_back(item);
+                }
+                app->prefetch(fileNames);
+
+                for (const auto& item : items)
+                {
                     std::string path = item.path.get();
                     std::string audioPath;
                     if (!item.audioPath.isEmpty())
@@ -4,6 +4,8 @@
 
 #include "mrvFl/mrvTimelinePlayer.h"
 
+#include <map>
+
 #include <tlCore/Math.h>
 #include <tlCore/Time.h>
 
@@ -81,8 +83,17 @@ namespace mrv
         std::chrono::time_point<std::chrono::high_resolution_clock> start_time;
 #endif
 
-        //! List of annotations ( drawings/text per time )
-        std::vector<std::shared_ptr<draw::Annotation> > annotations;
+        //! Annotations ( drawings/text per time ), ordered by time.
+        std::multimap<
+            otime::RationalTime, std::shared_ptr<draw::Annotation> >
+            annotations;
+
+        //! Annotations that are shown on all frames.  They are also in
+        //! annotations.
+        std::vector<std::shared_ptr<draw::Annotation> > allFramesAnnotations;
+
+        //! Incremented when annotations are added or removed.
+        uint64_t annotationsVersion = 0;
 
         //! Last annotation undone
         std::shared_ptr<draw::Annotation > undoAnnotation = nullptr;
@@ -616,15 +627,21 @@ namespace mrv
         return !_p->annotations.empty();
     }
 
+    uint64_t TimelinePlayer::annotationsVersion() const
+    {
+        return _p->annotationsVersion;
+    }
+
     const std::vector< otime::RationalTime >
     TimelinePlayer::getAnnotationTimes() const
     {
         TLRENDER_P();
 
         std::vector< otime::RationalTime > times;
-        for (auto annotation : p.annotations)
+        times.reserve(p.annotations.size());
+        for (const auto& i : p.annotations)
         {
-            times.push_back(annotation->time);
+            times.push_back(i.first);
         }
         return times;
     }
@@ -640,28 +657,22 @@ namespace mrv
             static_cast<double>(previous), time.rate());
         otime::RationalTime nextTime(static_cast<double>(next), time.rate());
 
+        // Annotations whose time is in (time - next, time + previous).
+        const otime::RationalTime start = time - nextTime;
+        const otime::RationalTime end = time + previousTime;
+
         std::vector< std::shared_ptr< draw::Annotation > > annotations;
 
-        auto found = p.annotations.begin();
+        for (const auto& annotation : p.allFramesAnnotations)
+        {
+            if (annotation->time <= start || annotation->time >= end)
+                annotations.push_back(annotation);
+        }
 
-        while (found != p.annotations.end())
+        for (auto i = p.annotations.upper_bound(start);
+             i != p.annotations.end() && i->first < end; ++i)
         {
-            found = std::find_if(
-                found, p.annotations.end(),
-                [time, previousTime, nextTime](const auto& a)
-                {
-                    if (a->allFrames)
-                        return true;
-                    const otime::RationalTime start = a->time - previousTime;
-                    const otime::RationalTime end = a->time + nextTime;
-                    return (time > start && time < end);
-                });
-
-            if (found != p.annotations.end())
-            {
-                annotations.push_back(*found);
-                ++found;
-            }
+            annotations.push_back(i->second);
         }
         return annotations;
     }
@@ -674,19 +685,14 @@ namespace mrv
         if (playback() != timeline::Playback::Stop)
             return nullptr;
 
-        const auto& time = currentTime();
-
-        const auto found = std::find_if(
-            p.annotations.begin(), p.annotations.end(),
-            [time](const auto& a) { return a->time == time; });
-
+        const auto found = p.annotations.find(currentTime());
         if (found == p.annotations.end())
         {
             return nullptr;
         }
         else
         {
-            return *found;
+            return found->second;
         }
     }
 
@@ -703,15 +709,12 @@ namespace mrv
 
         auto time = currentTime();
 
-        auto found = std::find_if(
-            p.annotations.begin(), p.annotations.end(),
-            [time](const auto& a) { return a->time == time; });
-
+        auto found = p.annotations.find(time);
         if (found == p.annotations.end())
         {
             auto annotation =
                 std::make_shared< draw::Annotation >(time, all_frames);
-            p.annotations.push_back(annotation);
+            _addAnnotation(annotation);
             bool send = App::ui->uiPrefs->SendAnnotations->value();
             if (send)
                 tcp->pushMessage("Create Annotation", all_frames);
@@ -719,7 +722,7 @@ namespace mrv
         }
         else
         {
-            auto annotation = *found;
+            auto annotation = found->second;
             if (!annotation->allFrames && !all_frames)
             {
                 throw std::runtime_error(
@@ -733,34 +736,51 @@ namespace mrv
     std::vector< std::shared_ptr< draw::Annotation >>
     TimelinePlayer::getAllAnnotations() const
     {
-        return _p->annotations;
+        TLRENDER_P();
+
+        std::vector< std::shared_ptr< draw::Annotation >> out;
+        out.reserve(p.annotations.size());
+        for (const auto& i : p.annotations)
+        {
+            out.push_back(i.second);
+        }
+        return out;
     }
 
     void TimelinePlayer::setAllAnnotations(
         const std::vector< std::shared_ptr< draw::Annotation >>& value)
     {
-        _p->annotations = value;
+        TLRENDER_P();
+
+        p.annotations.clear();
+        p.allFramesAnnotations.clear();
+        for (const auto& annotation : value)
+        {
+            _addAnnotation(annotation);
+        }
+        ++p.annotationsVersion;
     }
 
     void TimelinePlayer::clearFrameAnnotation()
     {
         TLRENDER_P();
 
-        const auto& time = currentTime();
-
-        auto found = std::find_if(
-            p.annotations.begin(), p.annotations.end(),
-            [time](const auto& a) { return a->time == time; });
-
+        const auto found = p.annotations.find(currentTime());
         if (found != p.annotations.end())
         {
-            p.annotations.erase(found);
+            // Copy it, as removing it erases found.
+            const auto annotation = found->second;
+            removeAnnotation(annotation);
         }
     }
 
     void TimelinePlayer::clearAllAnnotations()
     {
-        _p->annotations.clear();
+        TLRENDER_P();
+
+        p.annotations.clear();
+        p.allFramesAnnotations.clear();
+        ++p.annotationsVersion;
     }
 
     void TimelinePlayer::removeAnnotation(
@@ -768,9 +788,36 @@ namespace mrv
     {
         TLRENDER_P();
 
-        p.annotations.erase(
-            std::remove(p.annotations.begin(), p.annotations.end(), annotation),
-            p.annotations.end());
+        if (!annotation)
+            return;
+
+        const auto range = p.annotations.equal_range(annotation->time);
+        for (auto i = range.first; i != range.second; ++i)
+        {
+            if (i->second == annotation)
+            {
+                p.annotations.erase(i);
+                break;
+            }
+        }
+
+        p.allFramesAnnotations.erase(
+            std::remove(
+                p.allFramesAnnotations.begin(), p.allFramesAnnotations.end(),
+                annotation),
+            p.allFramesAnnotations.end());
+        ++p.annotationsVersion;
+    }
+
+    void TimelinePlayer::_addAnnotation(
+        const std::shared_ptr< draw::Annotation >& annotation)
+    {
+        TLRENDER_P();
+
+        p.annotations.insert(std::make_pair(annotation->time, annotation));
+        if (annotation->allFrames)
+            p.allFramesAnnotations.push_back(annotation);
+        ++p.annotationsVersion;
     }
 
     void TimelinePlayer::undoAnnotation()
@@ -800,7 +847,7 @@ namespace mrv
             if (p.undoAnnotation)
             {
                 annotation = p.undoAnnotation;
-                p.annotations.push_back(annotation);
+                _addAnnotation(annotation);
                 p.undoAnnotation.reset();
             }
         }
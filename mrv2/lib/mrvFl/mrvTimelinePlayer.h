@@ -334,7 +334,11 @@ namespace mrv
         //! Returns whether there's annotations in the player
         bool hasAnnotations() const;
 
-        //! Return a list of annotation times
+        //! Returns a counter that changes when annotations are added or
+        //! removed.
+        uint64_t annotationsVersion() const;
+
+        //! Return a list of annotation times, in order.
         const std::vector< otime::RationalTime > getAnnotationTimes() const;
 
         //! Get annotation for current time
@@ -389,6 +393,8 @@ namespace mrv
 
         static void timerEvent_cb(void* d);
 
+        void _addAnnotation(const std::shared_ptr< draw::Annotation >&);
+
     private:
         TimelineViewport* timelineViewport = nullptr;
 
@@ -0,0 +1,278 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// mrv2
+// Copyright Contributors to the mrv2 Project. All rights reserved.
+
+#include <cstring>
+
+#include <tlGL/Mesh.h>
+#include <tlGL/Util.h>
+#include <tlGL/Shader.h>
+
+#include "mrvGL/mrvGLErrors.h"
+#include "mrvGL/mrvGLShaders.h"
+#include "mrvGL/mrvGLColorArea.h"
+
+namespace tl
+{
+    namespace timeline_gl
+    {
+        extern std::string vertexSource();
+    } // namespace timeline_gl
+} // namespace tl
+
+namespace
+{
+    //! Each pass reduces a block of kBlock x kBlock pixels into one.
+    const int kBlock = 8;
+
+    //! Outputs of each pass: rgba min, max, sum and hsv min, max, sum.
+    const int kOutputs = 6;
+
+    const char* kSamplers[kOutputs] = {
+        "rgbaMinSampler", "rgbaMaxSampler", "rgbaSumSampler",
+        "hsvMinSampler",  "hsvMaxSampler",  "hsvSumSampler"};
+} // namespace
+
+namespace mrv
+{
+    namespace opengl
+    {
+        using namespace tl::gl;
+
+        namespace
+        {
+            //! A level of the reduction.
+            struct Level
+            {
+                math::Size2i size;
+                GLuint fbo = 0;
+                GLuint textures[kOutputs] = {0, 0, 0, 0, 0, 0};
+            };
+
+            int reducedSize(int value)
+            {
+                return (value + kBlock - 1) / kBlock;
+            }
+        } // namespace
+
+        struct ColorArea::Private
+        {
+            std::shared_ptr<gl::Shader> areaShader;
+            std::shared_ptr<gl::Shader> reduceShader;
+            std::shared_ptr<gl::VBO> vbo;
+            std::shared_ptr<gl::VAO> vao;
+
+            //! Size of the area the levels were created for.
+            math::Size2i areaSize;
+            std::vector<Level> levels;
+
+            void deleteLevels();
+            void createLevels(const math::Size2i& size);
+        };
+
+        void ColorArea::Private::deleteLevels()
+        {
+            for (auto& level : levels)
+            {
+                glDeleteTextures(kOutputs, level.textures);
+                glDeleteFramebuffers(1, &level.fbo);
+            }
+            levels.clear();
+        }
+
+        void ColorArea::Private::createLevels(const math::Size2i& size)
+        {
+            deleteLevels();
+            areaSize = size;
+
+            const GLenum drawBuffers[kOutputs] = {
+                GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1,
+                GL_COLOR_ATTACHMENT2, GL_COLOR_ATTACHMENT3,
+                GL_COLOR_ATTACHMENT4, GL_COLOR_ATTACHMENT5};
+
+            math::Size2i levelSize = size;
+            do
+            {
+                levelSize.w = reducedSize(levelSize.w);
+                levelSize.h = reducedSize(levelSize.h);
+
+                Level level;
+                level.size = levelSize;
+                glGenFramebuffers(1, &level.fbo);
+                glBindFramebuffer(GL_FRAMEBUFFER, level.fbo);
+                glGenTextures(kOutputs, level.textures);
+                for (int i = 0; i < kOutputs; ++i)
+                {
+                    glBindTexture(GL_TEXTURE_2D, level.textures[i]);
+                    glTexParameteri(
+                        GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+                    glTexParameteri(
+                        GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+                    glTexImage2D(
+                        GL_TEXTURE_2D, 0, GL_RGBA32F, levelSize.w,
+                        levelSize.h, 0, GL_RGBA, GL_FLOAT, nullptr);
+                    glFramebufferTexture2D(
+                        GL_FRAMEBUFFER, drawBuffers[i], GL_TEXTURE_2D,
+                        level.textures[i], 0);
+                    CHECK_GL;
+                }
+                glDrawBuffers(kOutputs, drawBuffers);
+                CHECK_GL;
+                levels.push_back(level);
+            } while (levelSize.w > 1 || levelSize.h > 1);
+
+            glBindTexture(GL_TEXTURE_2D, 0);
+        }
+
+        ColorArea::ColorArea() :
+            _p(new Private)
+        {
+        }
+
+        ColorArea::~ColorArea()
+        {
+            _p->deleteLevels();
+        }
+
+        void ColorArea::calculate(
+            unsigned textureID, const math::Size2i& renderSize,
+            const int hsvColorSpace, const BrightnessType brightness,
+            area::Info& info)
+        {
+            TLRENDER_P();
+
+            const math::Box2i box =
+                info.box.intersect(math::Box2i(0, 0, renderSize.w, renderSize.h));
+            if (box.min.x > box.max.x || box.min.y > box.max.y)
+                return;
+
+            if (!p.areaShader)
+            {
+                const std::string& vertexSource = timeline_gl::vertexSource();
+                p.areaShader =
+                    Shader::create(vertexSource, colorAreaFragmentSource());
+                p.reduceShader =
+                    Shader::create(vertexSource, reduceFragmentSource());
+                CHECK_GL;
+            }
+
+            if (!p.vbo)
+            {
+                // Two triangles covering the whole viewport.
+                p.vbo = VBO::create(6, VBOType::Pos2_F32);
+                const float quad[] = {-1.F, -1.F, 1.F, -1.F, 1.F, 1.F,
+                                      1.F,  1.F,  -1.F, 1.F, -1.F, -1.F};
+                std::vector<uint8_t> vertexData(sizeof(quad));
+                memcpy(vertexData.data(), quad, sizeof(quad));
+                p.vbo->copy(vertexData);
+                p.vao = VAO::create(p.vbo->getType(), p.vbo->getID());
+                CHECK_GL;
+            }
+
+            const math::Size2i areaSize(box.w(), box.h());
+            if (areaSize != p.areaSize || p.levels.empty())
+                p.createLevels(areaSize);
+
+            const GLboolean blend = glIsEnabled(GL_BLEND);
+            glDisable(GL_BLEND);
+            const GLboolean scissor = glIsEnabled(GL_SCISSOR_TEST);
+            glDisable(GL_SCISSOR_TEST);
+
+            const math::Matrix4x4f mvp;
+            p.vao->bind();
+
+            // First pass, convert and reduce the area of the texture.
+            const Level& first = p.levels[0];
+            glBindFramebuffer(GL_FRAMEBUFFER, first.fbo);
+            glViewport(0, 0, first.size.w, first.size.h);
+
+            p.areaShader->bind();
+            p.areaShader->setUniform("transform.mvp", mvp);
+            p.areaShader->setUniform("textureSampler", 0);
+            p.areaShader->setUniform("originX", box.min.x);
+            p.areaShader->setUniform("originY", box.min.y);
+            p.areaShader->setUniform("width", areaSize.w);
+            p.areaShader->setUniform("height", areaSize.h);
+            p.areaShader->setUniform("block", kBlock);
+            p.areaShader->setUniform("colorSpace", hsvColorSpace);
+            p.areaShader->setUniform("brightness", (int)brightness);
+
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, textureID);
+            p.vao->draw(GL_TRIANGLES, 0, p.vbo->getSize());
+            CHECK_GL;
+
+            // Following passes reduce the previous level.
+            p.reduceShader->bind();
+            p.reduceShader->setUniform("transform.mvp", mvp);
+            p.reduceShader->setUniform("block", kBlock);
+            for (int i = 0; i < kOutputs; ++i)
+                p.reduceShader->setUniform(kSamplers[i], i);
+
+            for (size_t l = 1; l < p.levels.size(); ++l)
+            {
+                const Level& previous = p.levels[l - 1];
+                const Level& level = p.levels[l];
+                glBindFramebuffer(GL_FRAMEBUFFER, level.fbo);
+                glViewport(0, 0, level.size.w, level.size.h);
+                p.reduceShader->setUniform("width", previous.size.w);
+                p.reduceShader->setUniform("height", previous.size.h);
+                for (int i = 0; i < kOutputs; ++i)
+                {
+                    glActiveTexture(GL_TEXTURE0 + i);
+                    glBindTexture(GL_TEXTURE_2D, previous.textures[i]);
+                }
+                p.vao->draw(GL_TRIANGLES, 0, p.vbo->getSize());
+                CHECK_GL;
+            }
+
+            // Read back the 1x1 results.
+            image::Color4f values[kOutputs];
+            const Level& last = p.levels.back();
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, last.fbo);
+
+            // The viewport may have a PBO mapped for the panels.
+            GLint pbo = 0;
+            glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &pbo);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            glPixelStorei(GL_PACK_ALIGNMENT, 1);
+            for (int i = 0; i < kOutputs; ++i)
+            {
+                glReadBuffer(GL_COLOR_ATTACHMENT0 + i);
+                glReadPixels(0, 0, 1, 1, GL_RGBA, GL_FLOAT, &values[i]);
+            }
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+            CHECK_GL;
+
+            for (int i = kOutputs - 1; i >= 0; --i)
+            {
+                glActiveTexture(GL_TEXTURE0 + i);
+                glBindTexture(GL_TEXTURE_2D, 0);
+            }
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+            if (blend)
+                glEnable(GL_BLEND);
+            if (scissor)
+                glEnable(GL_SCISSOR_TEST);
+
+            const float num = static_cast<float>(areaSize.w) * areaSize.h;
+            auto fill = [num](
+                            area::Channels& channels, const image::Color4f& min,
+                            const image::Color4f& max,
+                            const image::Color4f& sum)
+            {
+                channels.min = min;
+                channels.max = max;
+                channels.mean = image::Color4f(
+                    sum.r / num, sum.g / num, sum.b / num, sum.a / num);
+                channels.diff = image::Color4f(
+                    max.r - min.r, max.g - min.g, max.b - min.b,
+                    max.a - min.a);
+            };
+            fill(info.rgba, values[0], values[1], values[2]);
+            fill(info.hsv, values[3], values[4], values[5]);
+        }
+
+    } // namespace opengl
+} // namespace mrv
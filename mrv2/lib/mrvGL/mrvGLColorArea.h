@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// mrv2
+// Copyright Contributors to the mrv2 Project. All rights reserved.
+
+#pragma once
+
+#include <tlCore/Util.h>
+#include <tlCore/Box.h>
+
+#include "mrvCore/mrvColorSpaces.h"
+
+#include "mrvFl/mrvColorAreaInfo.h"
+
+namespace mrv
+{
+    namespace opengl
+    {
+        using namespace tl;
+
+        //! OpenGL color area statistics.  Reduces the selected area of a
+        //! texture to its min, max and mean values on the GPU, so only a
+        //! few floats need to be read back.
+        class ColorArea
+        {
+        public:
+            ColorArea();
+            ~ColorArea();
+
+            //! Calculate the statistics of the info.box area of a texture
+            //! of renderSize.  The hsv channels are calculated in
+            //! hsvColorSpace with the brightness in the alpha channel.
+            //! Changes the bound framebuffer and the viewport.
+            void calculate(
+                unsigned textureID, const math::Size2i& renderSize,
+                const int hsvColorSpace, const BrightnessType brightness,
+                area::Info& info);
+
+        private:
+            TLRENDER_PRIVATE();
+        };
+
+    } // namespace opengl
+} // namespace mrv
@@ -52,27 +52,50 @@ namespace mrv
             const draw::Polyline2D::EndCapStyle endStyle,
             const bool catmullRomSpline, const bool allowOverlap)
         {
-            TLRENDER_P();
+            PolylineMesh mesh;
+            _tessellate(
+                mesh, pts, width, soft, jointStyle, endStyle, catmullRomSpline,
+                allowOverlap);
+            _drawMesh(render, mesh, color);
+        }
 
-            if (!p.softShader)
+        void Lines::drawLines(
+            const std::shared_ptr<timeline::IRender>& render,
+            PolylineMesh& mesh, const draw::PointList& pts,
+            const image::Color4f& color, const float width, const bool soft,
+            const draw::Polyline2D::JointStyle jointStyle,
+            const draw::Polyline2D::EndCapStyle endStyle,
+            const bool catmullRomSpline, const bool allowOverlap)
+        {
+            if (mesh.data.empty() || mesh.width != width ||
+                mesh.soft != soft || mesh.jointStyle != jointStyle ||
+                mesh.endStyle != endStyle ||
+                mesh.catmullRomSpline != catmullRomSpline ||
+                mesh.allowOverlap != allowOverlap || mesh.pts != pts)
             {
-                try
-                {
-                    const std::string& vertexSource =
-                        tl::timeline_gl::vertexSource();
-                    p.softShader = gl::Shader::create(
-                        vertexSource, mrv::softFragmentSource());
-                    p.hardShader = gl::Shader::create(
-                        vertexSource, mrv::hardFragmentSource());
-                }
-                catch (const std::exception& e)
-                {
-                    throw e;
-                }
+                _tessellate(
+                    mesh, pts, width, soft, jointStyle, endStyle,
+                    catmullRomSpline, allowOverlap);
+                mesh.pts = pts;
             }
+            _drawMesh(render, mesh, color);
+        }
 
+        void Lines::_tessellate(
+            PolylineMesh& out, const draw::PointList& pts, const float width,
+            const bool soft, const draw::Polyline2D::JointStyle jointStyle,
+            const draw::Polyline2D::EndCapStyle endStyle,
+            const bool catmullRomSpline, const bool allowOverlap)
+        {
             using namespace mrv::draw;
 
+            out.width = width;
+            out.soft = soft;
+            out.jointStyle = jointStyle;
+            out.endStyle = endStyle;
+            out.catmullRomSpline = catmullRomSpline;
+            out.allowOverlap = allowOverlap;
+
             Polyline2D path;
             path.setWidth(width);
             path.setSoftEdges(soft);
@@ -134,9 +157,40 @@ namespace mrv
             for (size_t i = 0; i < numVertices; ++i)
                 mesh.v.push_back(math::Vector2f(draw[i].x, draw[i].y));
 
+            out.data = convert(mesh, vboType);
+            out.vertexCount = numTriangles * 3;
+            out.hasUVs = numUVs > 0;
+        }
+
+        void Lines::_drawMesh(
+            const std::shared_ptr<timeline::IRender>& render,
+            const PolylineMesh& mesh, const image::Color4f& color)
+        {
+            TLRENDER_P();
+
+            if (mesh.vertexCount == 0)
+                return;
+
+            if (!p.softShader)
+            {
+                try
+                {
+                    const std::string& vertexSource =
+                        tl::timeline_gl::vertexSource();
+                    p.softShader = gl::Shader::create(
+                        vertexSource, mrv::softFragmentSource());
+                    p.hardShader = gl::Shader::create(
+                        vertexSource, mrv::hardFragmentSource());
+                }
+                catch (const std::exception& e)
+                {
+                    throw e;
+                }
+            }
+
             const math::Matrix4x4f& mvp = render->getTransform();
             CHECK_GL;
-            if (soft)
+            if (mesh.soft)
             {
                 p.softShader->bind();
                 CHECK_GL;
@@ -155,10 +209,13 @@ namespace mrv
                 CHECK_GL;
             }
 
-            if (!p.vbo || (p.vbo && (p.vbo->getSize() != numTriangles * 3 ||
+            const tl::gl::VBOType vboType = mesh.hasUVs
+                                                ? gl::VBOType::Pos2_F32_UV_U16
+                                                : gl::VBOType::Pos2_F32;
+            if (!p.vbo || (p.vbo && (p.vbo->getSize() != mesh.vertexCount ||
                                      p.vbo->getType() != vboType)))
             {
-                p.vbo = gl::VBO::create(numTriangles * 3, vboType);
+                p.vbo = gl::VBO::create(mesh.vertexCount, vboType);
                 CHECK_GL;
                 p.vao.reset();
                 CHECK_GL;
@@ -166,7 +223,7 @@ namespace mrv
 
             if (p.vbo)
             {
-                p.vbo->copy(convert(mesh, vboType));
+                p.vbo->copy(mesh.data);
                 CHECK_GL;
             }
 
@@ -182,26 +239,6 @@ namespace mrv
                 CHECK_GL;
                 p.vao->draw(GL_TRIANGLES, 0, p.vbo->getSize());
                 CHECK_GL;
-
-                // #ifndef NDEBUG
-                //             if (!soft)
-                //             {
-                //                 p.wireShader->bind();
-                //                 CHECK_GL;
-                //                 p.wireShader->setUniform("transform.mvp",
-                //                 mvp); CHECK_GL;
-                //                 p.wireShader->setUniform("color",
-                //                 image::Color4f(1, 0, 0, 1)); CHECK_GL;
-                //                 glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-                //                 CHECK_GL;
-                //                 p.vao->bind();
-                //                 CHECK_GL;
-                //                 p.vao->draw(GL_TRIANGLES, 0,
-                //                 p.vbo->getSize()); CHECK_GL;
-                //                 glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-                //                 CHECK_GL;
-                //             }
-                // #endif
             }
         }
 
@@ -261,6 +298,16 @@ namespace mrv
             const std::shared_ptr<timeline::IRender>& render,
             const math::Vector2f& center, const float radius, const float width,
             const image::Color4f& color, const bool soft)
+        {
+            PolylineMesh mesh;
+            drawCircle(render, mesh, center, radius, width, color, soft);
+        }
+
+        void Lines::drawCircle(
+            const std::shared_ptr<timeline::IRender>& render,
+            PolylineMesh& mesh, const math::Vector2f& center,
+            const float radius, const float width,
+            const image::Color4f& color, const bool soft)
         {
             const int triangleAmount = 30;
             const double twoPi = math::pi * 2.0;
@@ -276,7 +323,7 @@ namespace mrv
             }
 
             drawLines(
-                render, verts, color, width, soft,
+                render, mesh, verts, color, width, soft,
                 draw::Polyline2D::JointStyle::ROUND,
                 draw::Polyline2D::EndCapStyle::JOINT);
         }
@@ -18,6 +18,29 @@ namespace mrv
     {
         using namespace tl;
 
+        //! Tessellated set of connected line segments.  Shapes keep one per
+        //! stroke, so strokes are only tessellated again when they change.
+        struct PolylineMesh
+        {
+            //! \name Tessellated stroke.
+            ///@{
+            draw::PointList pts;
+            float width = 0.F;
+            bool soft = false;
+            draw::Polyline2D::JointStyle jointStyle =
+                draw::Polyline2D::JointStyle::MITER;
+            draw::Polyline2D::EndCapStyle endStyle =
+                draw::Polyline2D::EndCapStyle::BUTT;
+            bool catmullRomSpline = false;
+            bool allowOverlap = false;
+            ///@}
+
+            //! Vertex buffer data, with UVs for soft strokes.
+            std::vector<uint8_t> data;
+            size_t vertexCount = 0;
+            bool hasUVs = false;
+        };
+
         //! OpenGL Lines renderer.
         class Lines
         {
@@ -48,6 +71,20 @@ namespace mrv
                 const bool catmullRomSpline = false,
                 const bool allowOverlap = false);
 
+            //! Draw a set of connected line segments, tessellating them into
+            //! the mesh only if they differ from the last ones drawn with it.
+            void drawLines(
+                const std::shared_ptr<timeline::IRender>& render,
+                PolylineMesh& mesh, const draw::PointList& pts,
+                const image::Color4f& color, const float width,
+                const bool soft = false,
+                const draw::Polyline2D::JointStyle jointStyle =
+                    draw::Polyline2D::JointStyle::MITER,
+                const draw::Polyline2D::EndCapStyle endStyle =
+                    draw::Polyline2D::EndCapStyle::BUTT,
+                const bool catmullRomSpline = false,
+                const bool allowOverlap = false);
+
             //! Draw a circle.
             void drawCircle(
                 const std::shared_ptr<timeline::IRender>& render,
@@ -55,6 +92,14 @@ namespace mrv
                 const float width, const image::Color4f& color,
                 const bool soft = false);
 
+            //! Draw a circle, tessellating it into the mesh only if it
+            //! changed.
+            void drawCircle(
+                const std::shared_ptr<timeline::IRender>& render,
+                PolylineMesh& mesh, const math::Vector2f& center,
+                const float radius, const float width,
+                const image::Color4f& color, const bool soft = false);
+
             //! Draw drawing cursor (two circles, one white, one black).
             void drawCursor(
                 const std::shared_ptr<timeline::IRender>& render,
@@ -62,6 +107,16 @@ namespace mrv
                 const image::Color4f& color);
 
         private:
+            void _tessellate(
+                PolylineMesh&, const draw::PointList&, const float width,
+                const bool soft, const draw::Polyline2D::JointStyle,
+                const draw::Polyline2D::EndCapStyle,
+                const bool catmullRomSpline, const bool allowOverlap);
+
+            void _drawMesh(
+                const std::shared_ptr<timeline::IRender>&, const PolylineMesh&,
+                const image::Color4f& color);
+
             TLRENDER_PRIVATE();
         };
     } // namespace opengl
@@ -0,0 +1,153 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// mrv2
+// Copyright Contributors to the mrv2 Project. All rights reserved.
+
+#include <cstdlib>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+#include <tlGL/Init.h>
+
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+
+#include "mrvCore/mrvI8N.h"
+
+#include "mrvGL/mrvGLOffscreenContext.h"
+
+#include "mrvFl/mrvIO.h"
+
+namespace
+{
+    const char* kModule = "gl";
+}
+
+namespace mrv
+{
+    namespace opengl
+    {
+        namespace
+        {
+            void errorCallback(int, const char* description)
+            {
+                LOG_ERROR("GLFW: " << description);
+            }
+
+            // GLFW is global, so it is initialized with the first context
+            // and terminated with the last one.  Its init hints are only
+            // read by the first glfwInit().
+            std::mutex glfwMutex;
+            int glfwCount = 0;
+
+            void initGLFW(const bool headless)
+            {
+                std::lock_guard lk(glfwMutex);
+                if (glfwCount == 0)
+                {
+                    glfwSetErrorCallback(errorCallback);
+#ifdef GLFW_PLATFORM_NULL
+                    glfwInitHint(
+                        GLFW_PLATFORM,
+                        headless ? GLFW_PLATFORM_NULL : GLFW_ANY_PLATFORM);
+#endif
+                    if (!glfwInit())
+                        throw std::runtime_error(
+                            _("Cannot initialize GLFW."));
+                }
+                ++glfwCount;
+            }
+
+            void terminateGLFW()
+            {
+                std::lock_guard lk(glfwMutex);
+                if (--glfwCount == 0)
+                    glfwTerminate();
+            }
+        } // namespace
+
+        struct OffscreenContext::Private
+        {
+            GLFWwindow* window = nullptr;
+        };
+
+        bool OffscreenContext::hasDisplay()
+        {
+#ifdef __linux__
+            const char* x11 = std::getenv("DISPLAY");
+            const char* wayland = std::getenv("WAYLAND_DISPLAY");
+            return (x11 && x11[0]) || (wayland && wayland[0]);
+#else
+            return true;
+#endif
+        }
+
+        OffscreenContext::OffscreenContext() :
+            _p(new Private)
+        {
+            TLRENDER_P();
+
+            const bool headless = !hasDisplay();
+
+            initGLFW(headless);
+
+            glfwDefaultWindowHints();
+            glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+            glfwWindowHint(GLFW_DOUBLEBUFFER, GLFW_FALSE);
+#if defined(TLRENDER_API_GL_4_1)
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
+            glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+            glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GLFW_TRUE);
+#elif defined(TLRENDER_API_GLES_2)
+            glfwWindowHint(GLFW_CLIENT_API, GLFW_OPENGL_ES_API);
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 2);
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
+#endif
+
+            if (headless)
+            {
+                // Prefer a GPU through EGL and fall back to software
+                // rendering.
+                for (int api : {GLFW_EGL_CONTEXT_API, GLFW_OSMESA_CONTEXT_API})
+                {
+                    glfwWindowHint(GLFW_CONTEXT_CREATION_API, api);
+                    p.window = glfwCreateWindow(1, 1, "mrv2", nullptr, nullptr);
+                    if (p.window)
+                        break;
+                }
+            }
+            else
+            {
+                p.window = glfwCreateWindow(1, 1, "mrv2", nullptr, nullptr);
+            }
+
+            if (!p.window)
+            {
+                terminateGLFW();
+                throw std::runtime_error(
+                    _("Cannot create an offscreen OpenGL context."));
+            }
+
+            glfwMakeContextCurrent(p.window);
+            gl::initGLAD();
+        }
+
+        OffscreenContext::~OffscreenContext()
+        {
+            TLRENDER_P();
+            if (p.window)
+            {
+                glfwMakeContextCurrent(nullptr);
+                glfwDestroyWindow(p.window);
+                terminateGLFW();
+            }
+        }
+
+        void OffscreenContext::makeCurrent()
+        {
+            glfwMakeContextCurrent(_p->window);
+        }
+
+    } // namespace opengl
+} // namespace mrv
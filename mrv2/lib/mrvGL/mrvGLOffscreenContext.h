@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// mrv2
+// Copyright Contributors to the mrv2 Project. All rights reserved.
+
+#pragma once
+
+#include <tlCore/Util.h>
+
+namespace mrv
+{
+    namespace opengl
+    {
+        //! Invisible OpenGL context, used to render when the main window
+        //! is not shown, like when saving from the command-line.  On Linux
+        //! without an X11 or Wayland display, it creates a surfaceless EGL
+        //! context or, failing that, an OSMesa software one.
+        class OffscreenContext
+        {
+        public:
+            //! Create the context and make it current.  Throws on error.
+            OffscreenContext();
+            ~OffscreenContext();
+
+            void makeCurrent();
+
+            //! Whether there is a display to open windows on.
+            static bool hasDisplay();
+
+        private:
+            TLRENDER_PRIVATE();
+        };
+    } // namespace opengl
+} // namespace mrv
@@ -85,8 +85,216 @@ namespace mrv
             "    }\n"
             " return c;\n"
             "}\n";
+
+        //! Color space conversions for the color area reduction.  Must
+        //! match TimelineViewport::rgba_to_hsv and calculate_brightness.
+        const std::string colorSpaceSource =
+            "// enum mrv::color::Space\n"
+            "const int Space_HSV    = 1;\n"
+            "const int Space_HSL    = 2;\n"
+            "const int Space_YUV    = 7;\n"
+            "const int Space_YDbDr  = 8;\n"
+            "const int Space_YIQ    = 9;\n"
+            "const int Space_ITU601 = 10;\n"
+            "const int Space_ITU709 = 11;\n"
+            "\n"
+            "// enum mrv::BrightnessType\n"
+            "const int Brightness_Luminance = 0;\n"
+            "const int Brightness_Lumma     = 1;\n"
+            "const int Brightness_Lightness = 2;\n"
+            "\n"
+            "uniform int   colorSpace;\n"
+            "uniform int   brightness;\n"
+            "\n"
+            "float hueFunc(vec3 c, float maxV, float spanV)\n"
+            "{\n"
+            "    float h;\n"
+            "    if (c.r == maxV)\n"
+            "        h = (c.g - c.b) / spanV;\n"
+            "    else if (c.g == maxV)\n"
+            "        h = 2.0 + (c.b - c.r) / spanV;\n"
+            "    else\n"
+            "        h = 4.0 + (c.r - c.g) / spanV;\n"
+            "    if (h < 0.0)\n"
+            "        h += 6.0;\n"
+            "    return h / 6.0;\n"
+            "}\n"
+            "\n"
+            "vec4 colorSpaceFunc(vec4 rgba)\n"
+            "{\n"
+            "    vec3 c = clamp(rgba.rgb, 0.0, 1.0);\n"
+            "    vec4 r = vec4(c, 0.0);\n"
+            "    float minV = min(c.r, min(c.g, c.b));\n"
+            "    float maxV = max(c.r, max(c.g, c.b));\n"
+            "    float spanV = maxV - minV;\n"
+            "    if (colorSpace == Space_HSV)\n"
+            "    {\n"
+            "        float s = (maxV != 0.0) ? (spanV / maxV) : 0.0;\n"
+            "        float h = (s == 0.0) ? 0.0 : hueFunc(c, maxV, spanV);\n"
+            "        r.xyz = vec3(h, s, maxV);\n"
+            "    }\n"
+            "    else if (colorSpace == Space_HSL)\n"
+            "    {\n"
+            "        float sumV = maxV + minV;\n"
+            "        float l = sumV * 0.5;\n"
+            "        float s = 0.0;\n"
+            "        if (maxV != minV)\n"
+            "            s = (l <= 0.5) ? spanV / sumV : spanV / (2.0 - sumV);\n"
+            "        r.xyz = vec3(hueFunc(c, maxV, spanV), s, l);\n"
+            "    }\n"
+            "    else if (colorSpace == Space_YUV)\n"
+            "    {\n"
+            "        r.xyz = vec3(dot(c, vec3(0.299, 0.587, 0.114)),\n"
+            "                     dot(c, vec3(-0.14713, -0.28886, 0.436)),\n"
+            "                     dot(c, vec3(0.615, -0.51499, -0.10001)));\n"
+            "    }\n"
+            "    else if (colorSpace == Space_YDbDr)\n"
+            "    {\n"
+            "        r.xyz = vec3(dot(c, vec3(0.299, 0.587, 0.114)),\n"
+            "                     dot(c, vec3(-0.450, -0.883, 1.333)),\n"
+            "                     dot(c, vec3(-1.333, 1.116, 0.217)));\n"
+            "    }\n"
+            "    else if (colorSpace == Space_YIQ)\n"
+            "    {\n"
+            "        r.xyz = vec3(dot(c, vec3(0.299, 0.587, 0.114)),\n"
+            "                     dot(c, vec3(-0.595716, -0.274453, "
+            "-0.321263)),\n"
+            "                     dot(c, vec3(0.211456, -0.522591, 0.31135)));\n"
+            "    }\n"
+            "    else if (colorSpace == Space_ITU601)\n"
+            "    {\n"
+            "        r.xyz = vec3(16.0 + dot(c, vec3(65.481, 128.553, "
+            "24.966)),\n"
+            "                     128.0 + dot(c, vec3(-37.797, -74.203, "
+            "112.0)),\n"
+            "                     128.0 + dot(c, vec3(112.0, -93.786, "
+            "-18.214)));\n"
+            "    }\n"
+            "    else if (colorSpace == Space_ITU709)\n"
+            "    {\n"
+            "        r.xyz = vec3(dot(c, vec3(0.299, 0.587, 0.114)),\n"
+            "                     dot(c, vec3(-0.299, -0.587, 0.886)),\n"
+            "                     dot(c, vec3(0.701, -0.587, -0.114)));\n"
+            "    }\n"
+            "\n"
+            "    // Alpha holds the brightness.\n"
+            "    if (brightness == Brightness_Luminance)\n"
+            "    {\n"
+            "        r.w = dot(c, vec3(0.2126, 0.7152, 0.0722));\n"
+            "    }\n"
+            "    else if (brightness == Brightness_Lightness)\n"
+            "    {\n"
+            "        float L = dot(c, vec3(0.2126, 0.7152, 0.0722));\n"
+            "        if (L >= 0.008856)\n"
+            "            L = 116.0 * pow(L, 1.0 / 3.0) - 16.0;\n"
+            "        r.w = L / 100.0;\n"
+            "    }\n"
+            "    else\n"
+            "    {\n"
+            "        r.w = (c.r + c.g + c.b) / 3.0;\n"
+            "    }\n"
+            "    return r;\n"
+            "}\n";
     } // namespace
 
+    std::string colorAreaFragmentSource()
+    {
+        return tl::string::Format(
+                   "#version 410\n"
+                   "\n"
+                   "layout(location = 0) out vec4 rgbaMin;\n"
+                   "layout(location = 1) out vec4 rgbaMax;\n"
+                   "layout(location = 2) out vec4 rgbaSum;\n"
+                   "layout(location = 3) out vec4 hsvMin;\n"
+                   "layout(location = 4) out vec4 hsvMax;\n"
+                   "layout(location = 5) out vec4 hsvSum;\n"
+                   "\n"
+                   "{0}\n"
+                   "\n"
+                   "uniform sampler2D textureSampler;\n"
+                   "uniform int   originX;\n"
+                   "uniform int   originY;\n"
+                   "uniform int   width;\n"
+                   "uniform int   height;\n"
+                   "uniform int   block;\n"
+                   "\n"
+                   "void main()\n"
+                   "{\n"
+                   "    ivec2 origin = ivec2(originX, originY);\n"
+                   "    ivec2 start = ivec2(gl_FragCoord.xy) * block;\n"
+                   "    ivec2 end = min(start + ivec2(block), "
+                   "ivec2(width, height));\n"
+                   "    rgbaMin = hsvMin = vec4(3.402823e38);\n"
+                   "    rgbaMax = hsvMax = vec4(-3.402823e38);\n"
+                   "    rgbaSum = hsvSum = vec4(0.0);\n"
+                   "    for (int y = start.y; y < end.y; ++y)\n"
+                   "    {\n"
+                   "        for (int x = start.x; x < end.x; ++x)\n"
+                   "        {\n"
+                   "            vec4 c = texelFetch(textureSampler, "
+                   "origin + ivec2(x, y), 0);\n"
+                   "            rgbaMin = min(rgbaMin, c);\n"
+                   "            rgbaMax = max(rgbaMax, c);\n"
+                   "            rgbaSum += c;\n"
+                   "            vec4 h = colorSpaceFunc(c);\n"
+                   "            hsvMin = min(hsvMin, h);\n"
+                   "            hsvMax = max(hsvMax, h);\n"
+                   "            hsvSum += h;\n"
+                   "        }\n"
+                   "    }\n"
+                   "}\n")
+            .arg(colorSpaceSource);
+    }
+
+    std::string reduceFragmentSource()
+    {
+        return "#version 410\n"
+               "\n"
+               "layout(location = 0) out vec4 rgbaMin;\n"
+               "layout(location = 1) out vec4 rgbaMax;\n"
+               "layout(location = 2) out vec4 rgbaSum;\n"
+               "layout(location = 3) out vec4 hsvMin;\n"
+               "layout(location = 4) out vec4 hsvMax;\n"
+               "layout(location = 5) out vec4 hsvSum;\n"
+               "\n"
+               "uniform sampler2D rgbaMinSampler;\n"
+               "uniform sampler2D rgbaMaxSampler;\n"
+               "uniform sampler2D rgbaSumSampler;\n"
+               "uniform sampler2D hsvMinSampler;\n"
+               "uniform sampler2D hsvMaxSampler;\n"
+               "uniform sampler2D hsvSumSampler;\n"
+               "uniform int   width;\n"
+               "uniform int   height;\n"
+               "uniform int   block;\n"
+               "\n"
+               "void main()\n"
+               "{\n"
+               "    ivec2 start = ivec2(gl_FragCoord.xy) * block;\n"
+               "    ivec2 end = min(start + ivec2(block), "
+               "ivec2(width, height));\n"
+               "    rgbaMin = hsvMin = vec4(3.402823e38);\n"
+               "    rgbaMax = hsvMax = vec4(-3.402823e38);\n"
+               "    rgbaSum = hsvSum = vec4(0.0);\n"
+               "    for (int y = start.y; y < end.y; ++y)\n"
+               "    {\n"
+               "        for (int x = start.x; x < end.x; ++x)\n"
+               "        {\n"
+               "            ivec2 st = ivec2(x, y);\n"
+               "            rgbaMin = min(rgbaMin, "
+               "texelFetch(rgbaMinSampler, st, 0));\n"
+               "            rgbaMax = max(rgbaMax, "
+               "texelFetch(rgbaMaxSampler, st, 0));\n"
+               "            rgbaSum += texelFetch(rgbaSumSampler, st, 0);\n"
+               "            hsvMin = min(hsvMin, "
+               "texelFetch(hsvMinSampler, st, 0));\n"
+               "            hsvMax = max(hsvMax, "
+               "texelFetch(hsvMaxSampler, st, 0));\n"
+               "            hsvSum += texelFetch(hsvSumSampler, st, 0);\n"
+               "        }\n"
+               "    }\n"
+               "}\n";
+    }
+
     std::string textureFragmentSource()
     {
         return "#version 410\n"
@@ -13,4 +13,6 @@ namespace mrv
     std::string textureFragmentSource();
     std::string stereoFragmentSource();
     std::string annotationFragmentSource();
+    std::string colorAreaFragmentSource();
+    std::string reduceFragmentSource();
 } // namespace mrv
@@ -32,8 +32,9 @@ namespace mrv
         const bool catmullRomSpline = true;
         CHECK_GL;
         lines->drawLines(
-            render, pts, color, pen_size, soft, Polyline2D::JointStyle::ROUND,
-            Polyline2D::EndCapStyle::ROUND, catmullRomSpline);
+            render, mesh, pts, color, pen_size, soft,
+            Polyline2D::JointStyle::ROUND, Polyline2D::EndCapStyle::ROUND,
+            catmullRomSpline);
         CHECK_GL;
     }
 
@@ -52,8 +53,9 @@ namespace mrv
 
         const bool catmullRomSpline = false;
         lines->drawLines(
-            render, pts, color, pen_size, soft, Polyline2D::JointStyle::ROUND,
-            Polyline2D::EndCapStyle::ROUND, catmullRomSpline);
+            render, mesh, pts, color, pen_size, soft,
+            Polyline2D::JointStyle::ROUND, Polyline2D::EndCapStyle::ROUND,
+            catmullRomSpline);
     }
 
     void GLCircleShape::draw(
@@ -66,7 +68,8 @@ namespace mrv
             GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE,
             GL_ONE_MINUS_SRC_ALPHA);
 
-        lines->drawCircle(render, center, radius, pen_size, color, soft);
+        lines->drawCircle(
+            render, mesh, center, radius, pen_size, color, soft);
     }
 
     void GLRectangleShape::draw(
@@ -83,8 +86,9 @@ namespace mrv
 
         const bool catmullRomSpline = false;
         lines->drawLines(
-            render, pts, color, pen_size, soft, Polyline2D::JointStyle::ROUND,
-            Polyline2D::EndCapStyle::JOINT, catmullRomSpline);
+            render, mesh, pts, color, pen_size, soft,
+            Polyline2D::JointStyle::ROUND, Polyline2D::EndCapStyle::JOINT,
+            catmullRomSpline);
     }
 
     void GLArrowShape::draw(
@@ -118,23 +122,26 @@ namespace mrv
         line.push_back(pts[1]);
         line.push_back(pts[2]);
         lines->drawLines(
-            render, line, color, pen_size, soft, Polyline2D::JointStyle::ROUND,
-            Polyline2D::EndCapStyle::ROUND, catmullRomSpline);
+            render, headMeshes[0], line, color, pen_size, soft,
+            Polyline2D::JointStyle::ROUND, Polyline2D::EndCapStyle::ROUND,
+            catmullRomSpline);
 
         line.clear();
         line.push_back(pts[1]);
         line.push_back(pts[4]);
 
         lines->drawLines(
-            render, line, color, pen_size, soft, Polyline2D::JointStyle::ROUND,
-            Polyline2D::EndCapStyle::ROUND, catmullRomSpline);
+            render, headMeshes[1], line, color, pen_size, soft,
+            Polyline2D::JointStyle::ROUND, Polyline2D::EndCapStyle::ROUND,
+            catmullRomSpline);
 
         line.clear();
         line.push_back(pts[0]);
         line.push_back(pts[1]);
         lines->drawLines(
-            render, line, color, pen_size, soft, Polyline2D::JointStyle::ROUND,
-            Polyline2D::EndCapStyle::ROUND, catmullRomSpline);
+            render, mesh, line, color, pen_size, soft,
+            Polyline2D::JointStyle::ROUND, Polyline2D::EndCapStyle::ROUND,
+            catmullRomSpline);
 #endif
     }
 
@@ -53,6 +53,7 @@ namespace mrv
         math::Vector2f center;
         double radius;
         opengl::Lines lines;
+        opengl::PolylineMesh mesh;
     };
 
     void to_json(nlohmann::json& json, const GLCircleShape& value);
@@ -69,6 +70,7 @@ namespace mrv
             const std::shared_ptr<timeline::IRender>&,
             const std::shared_ptr<opengl::Lines>&) override;
         opengl::Lines lines;
+        opengl::PolylineMesh mesh;
     };
 
     void to_json(nlohmann::json& json, const GLPathShape& value);
@@ -84,6 +86,9 @@ namespace mrv
         void draw(
             const std::shared_ptr<timeline::IRender>&,
             const std::shared_ptr<opengl::Lines>&) override;
+
+        //! Meshes of the two sides of the head (the shaft uses mesh).
+        opengl::PolylineMesh headMeshes[2];
     };
 
     void to_json(nlohmann::json& json, const GLArrowShape& value);
@@ -82,14 +82,17 @@ namespace mrv
         MRV2_GL();
         if (gl.render)
             glDeleteBuffers(2, gl.pboIds);
+        gl.pboSizes[0] = gl.pboSizes[1] = 0;
         gl.render.reset();
         gl.outline.reset();
         gl.lines.reset();
+        gl.colorArea.reset();
 #ifdef USE_ONE_PIXEL_LINES
         gl.outline.reset();
 #endif
         gl.buffer.reset();
         gl.annotation.reset();
+        gl.annotationLayer.reset();
         gl.shader.reset();
         gl.stereoShader.reset();
         gl.annotationShader.reset();
@@ -120,6 +123,8 @@ namespace mrv
 
             gl.lines = std::make_shared<opengl::Lines>();
 
+            gl.colorArea = std::make_shared<opengl::ColorArea>();
+
             try
             {
                 const std::string& vertexSource = timeline_gl::vertexSource();
@@ -283,15 +288,10 @@ namespace mrv
                 {
                     gl.buffer = gl::OffscreenBuffer::create(
                         renderSize, offscreenBufferOptions);
-                    unsigned dataSize =
-                        renderSize.w * renderSize.h * 4 * sizeof(GLfloat);
-                    glBindBuffer(GL_PIXEL_PACK_BUFFER, gl.pboIds[0]);
-                    glBufferData(
-                        GL_PIXEL_PACK_BUFFER, dataSize, 0, GL_STREAM_READ);
-                    glBindBuffer(GL_PIXEL_PACK_BUFFER, gl.pboIds[1]);
-                    glBufferData(
-                        GL_PIXEL_PACK_BUFFER, dataSize, 0, GL_STREAM_READ);
-                    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+                    // PBOs get (re)allocated in _mapBuffer to the size of
+                    // the area being read back.
+                    gl.pboSizes[0] = gl.pboSizes[1] = 0;
                 }
 
                 if (can_do(FL_STEREO))
@@ -563,9 +563,19 @@ namespace mrv
                 p.colorAreaInfo.box = selection;
 
                 if (panel::colorAreaPanel || panel::histogramPanel ||
-                    panel::vectorscopePanel)
+                    panel::vectorscopePanel || panel::waveformPanel)
                 {
-                    _mapBuffer();
+                    // In full mode the color area statistics are
+                    // reduced on the GPU, so we only need to read back
+                    // pixels for the histogram, vectorscope and waveform.
+                    const bool fullValues =
+                        p.ui->uiPixelWindow->uiPixelValue->value() ==
+                        PixelValue::kFull;
+                    if (panel::histogramPanel || panel::vectorscopePanel ||
+                        panel::waveformPanel || !fullValues || !gl.colorArea)
+                    {
+                        _mapBuffer(selection);
+                    }
 
                     if (panel::colorAreaPanel)
                     {
@@ -580,6 +590,10 @@ namespace mrv
                     {
                         panel::vectorscopePanel->update(p.colorAreaInfo);
                     }
+                    if (panel::waveformPanel)
+                    {
+                        panel::waveformPanel->update(p.colorAreaInfo);
+                    }
                 }
                 else
                 {
@@ -642,6 +656,7 @@ namespace mrv
                 {
                     gl.annotation = gl::OffscreenBuffer::create(
                         viewportSize, offscreenBufferOptions);
+                    gl.annotationHash = 0;
                 }
                 _drawAnnotations(mvp, player->currentTime(), annotations);
             }
@@ -725,19 +740,28 @@ namespace mrv
         BrightnessType brightness_type = (BrightnessType)c->uiLType->value();
         int hsv_colorspace = c->uiBColorType->value() + 1;
 
-        const int maxX = info.box.max.x;
-        const int maxY = info.box.max.y;
-        const auto& renderSize = gl.buffer->getSize();
+        // p.image only holds the area read back from the render buffer.
+        const math::Box2i& imageBox = p.imageBox;
+        const math::Box2i box = info.box.intersect(imageBox);
+        if (box.min.x > box.max.x || box.min.y > box.max.y)
+            return;
+
+        const int maxX = box.max.x;
+        const int maxY = box.max.y;
+        const size_t stride = imageBox.w();
 
-        for (int Y = info.box.y(); Y <= maxY; ++Y)
+        for (int Y = box.y(); Y <= maxY; ++Y)
         {
-            for (int X = info.box.x(); X <= maxX; ++X)
+            const float* row =
+                p.image + (Y - imageBox.min.y) * stride * 4;
+            for (int X = box.x(); X <= maxX; ++X)
             {
+                const float* pixel = row + (X - imageBox.min.x) * 4;
                 image::Color4f rgba, hsv;
-                rgba.b = p.image[(X + Y * renderSize.w) * 4];
-                rgba.g = p.image[(X + Y * renderSize.w) * 4 + 1];
-                rgba.r = p.image[(X + Y * renderSize.w) * 4 + 2];
-                rgba.a = p.image[(X + Y * renderSize.w) * 4 + 3];
+                rgba.b = pixel[0];
+                rgba.g = pixel[1];
+                rgba.r = pixel[2];
+                rgba.a = pixel[3];
 
                 info.rgba.mean.r += rgba.r;
                 info.rgba.mean.g += rgba.g;
@@ -768,7 +792,7 @@ namespace mrv
             }
         }
 
-        int num = info.box.w() * info.box.h();
+        int num = box.w() * box.h();
         info.rgba.mean.r /= num;
         info.rgba.mean.g /= num;
         info.rgba.mean.b /= num;
@@ -795,7 +819,37 @@ namespace mrv
         TLRENDER_P();
         MRV2_GL();
 
-        if (!p.image || !gl.buffer)
+        if (!gl.buffer)
+            return;
+
+        const bool fullValues =
+            p.ui->uiPixelWindow->uiPixelValue->value() == PixelValue::kFull;
+        if (fullValues && gl.colorArea)
+        {
+            PixelToolBarClass* c = p.ui->uiPixelWindow;
+            BrightnessType brightness_type =
+                (BrightnessType)c->uiLType->value();
+            int hsv_colorspace = c->uiBColorType->value() + 1;
+
+            try
+            {
+                gl.colorArea->calculate(
+                    gl.buffer->getColorID(), gl.buffer->getSize(),
+                    hsv_colorspace, brightness_type, info);
+            }
+            catch (const std::exception& e)
+            {
+                // Fall back to calculating it on the CPU from next frame.
+                LOG_ERROR(e.what());
+                gl.colorArea.reset();
+            }
+
+            const auto& viewportSize = getViewportSize();
+            glViewport(0, 0, GLsizei(viewportSize.w), GLsizei(viewportSize.h));
+            return;
+        }
+
+        if (!p.image)
             return;
 
         info.rgba.max.r = std::numeric_limits<float>::min();
@@ -824,13 +878,13 @@ namespace mrv
         info.hsv.mean.r = info.hsv.mean.g = info.hsv.mean.b = info.hsv.mean.a =
             0.F;
 
-        if (p.ui->uiPixelWindow->uiPixelValue->value() == PixelValue::kFull)
+        if (fullValues)
             _calculateColorAreaFullValues(info);
         else
             _calculateColorAreaRawValues(info);
     }
 
-    void Viewport::_mapBuffer() const noexcept
+    void Viewport::_mapBuffer(const math::Box2i& box) const noexcept
     {
         MRV2_GL();
         TLRENDER_P();
@@ -848,6 +902,17 @@ namespace mrv
             gl::OffscreenBufferBinding binding(gl.buffer);
             const auto& renderSize = gl.buffer->getSize();
 
+            // Only read back the area requested, clamped to the render
+            // buffer.
+            const math::Box2i area = box.intersect(
+                math::Box2i(0, 0, renderSize.w, renderSize.h));
+            if (area.min.x > area.max.x || area.min.y > area.max.y)
+                return;
+
+            const GLsizei areaW = area.w();
+            const GLsizei areaH = area.h();
+            const size_t dataSize = areaW * areaH * 4 * sizeof(GLfloat);
+
             // bool update = _shouldUpdatePixelBar();
             bool stopped = _isPlaybackStopped();
             bool single_frame = _isSingleFrame();
@@ -864,13 +929,14 @@ namespace mrv
             if (single_frame)
             {
                 _unmapBuffer();
-                _mallocBuffer();
+                _mallocBuffer(area);
                 if (!p.image)
                     return;
                 glBindFramebuffer(GL_FRAMEBUFFER, 0);
                 glReadBuffer(GL_FRONT);
                 glReadPixels(
-                    0, 0, renderSize.w, renderSize.h, format, type, p.image);
+                    area.min.x, area.min.y, areaW, areaH, format, type,
+                    p.image);
                 return;
             }
             else
@@ -879,17 +945,30 @@ namespace mrv
                 // read pixels from framebuffer to PBO
                 // glReadPixels() should return immediately.
                 glBindBuffer(GL_PIXEL_PACK_BUFFER, gl.pboIds[gl.index]);
+                if (gl.pboSizes[gl.index] != dataSize)
+                {
+                    glBufferData(
+                        GL_PIXEL_PACK_BUFFER, dataSize, 0, GL_STREAM_READ);
+                    gl.pboSizes[gl.index] = dataSize;
+                }
 
-                glReadPixels(0, 0, renderSize.w, renderSize.h, format, type, 0);
-
-                // map the PBO to process its data by CPU
-                glBindBuffer(GL_PIXEL_PACK_BUFFER, gl.pboIds[gl.nextIndex]);
+                glReadPixels(
+                    area.min.x, area.min.y, areaW, areaH, format, type, 0);
+                gl.pboBoxes[gl.index] = area;
 
+                // map the PBO to process its data by CPU.
                 // We are stopped, read the first PBO.
-                if (stopped)
+                int mapIndex = stopped ? gl.index : gl.nextIndex;
+
+                // The other PBO has not been read into yet.
+                if (gl.pboSizes[mapIndex] == 0)
                 {
-                    glBindBuffer(GL_PIXEL_PACK_BUFFER, gl.pboIds[gl.index]);
+                    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+                    return;
                 }
+
+                glBindBuffer(GL_PIXEL_PACK_BUFFER, gl.pboIds[mapIndex]);
+                p.imageBox = gl.pboBoxes[mapIndex];
             }
 
             if (p.rawImage)
@@ -903,7 +982,7 @@ namespace mrv
         }
         else
         {
-            TimelineViewport::_mapBuffer();
+            TimelineViewport::_mapBuffer(box);
         }
     }
 
@@ -1018,16 +1097,32 @@ namespace mrv
                 }
             }
 
+            // If no panel requested an area, read back just the pixel
+            // under the cursor.
             if (!p.image)
-                _mapBuffer();
+                _mapBuffer(math::Box2i(pos.x, pos.y, 1, 1));
 
-            if (p.image)
+            if (p.image && p.imageBox.contains(pos))
+            {
+                const size_t offset =
+                    ((pos.x - p.imageBox.min.x) +
+                     (pos.y - p.imageBox.min.y) * p.imageBox.w()) *
+                    4;
+                rgba.b = p.image[offset];
+                rgba.g = p.image[offset + 1];
+                rgba.r = p.image[offset + 2];
+                rgba.a = p.image[offset + 3];
+            }
+            else
             {
-                const auto& renderSize = gl.buffer->getSize();
-                rgba.b = p.image[(pos.x + pos.y * renderSize.w) * 4];
-                rgba.g = p.image[(pos.x + pos.y * renderSize.w) * 4 + 1];
-                rgba.r = p.image[(pos.x + pos.y * renderSize.w) * 4 + 2];
-                rgba.a = p.image[(pos.x + pos.y * renderSize.w) * 4 + 3];
+                // The pixel is outside of the area read back for the
+                // panels.  Read it directly.
+                _unmapBuffer();
+                Viewport* self = const_cast<Viewport*>(this);
+                self->make_current();
+                gl::OffscreenBufferBinding binding(gl.buffer);
+                glReadPixels(pos.x, pos.y, 1, 1, GL_RGBA, type, &rgba);
+                return;
             }
         }
 
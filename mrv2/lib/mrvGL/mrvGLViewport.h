@@ -104,13 +104,30 @@ namespace mrv
             const float pixelAspectRatio, const image::Color4f& color,
             const math::Matrix4x4f& mvp, const char* label = "") const noexcept;
 
-        void _mapBuffer() const noexcept;
+        void _mapBuffer(const math::Box2i& box) const noexcept;
         void _unmapBuffer() const noexcept;
 
         void _drawShape(
             const std::shared_ptr< draw::Shape >& shape,
             const float alphamult = 1.F) noexcept;
 
+        //! Draw the shapes of an annotation in a buffer.
+        void _drawAnnotation(
+            const math::Matrix4x4f& mvp,
+            const std::pair<std::shared_ptr<draw::Annotation>, float>&,
+            const std::shared_ptr<gl::OffscreenBuffer>&);
+
+        //! Blend a buffer of annotations with the current blending.
+        void _drawAnnotationBuffer(
+            const std::shared_ptr<gl::OffscreenBuffer>&,
+            const timeline::Channels);
+
+        //! Show the notes of the annotations of the current frame.
+        void _updateAnnotationNotes(
+            const std::vector<
+                std::pair<std::shared_ptr<draw::Annotation>, float> >&)
+            const noexcept;
+
         void _calculateColorAreaFullValues(area::Info& info) noexcept;
 
         void _drawWindowArea(const std::string&) const noexcept;
@@ -2,6 +2,9 @@
 // mrv2
 // Copyright Contributors to the mrv2 Project. All rights reserved.
 
+#include <algorithm>
+#include <functional>
+
 #include <tlIO/System.h>
 
 #include <tlCore/String.h>
@@ -29,7 +32,15 @@
 namespace
 {
     const unsigned kFPSAverageFrames = 10;
-}
+
+    template <typename T>
+    inline void hashCombine(std::size_t& seed, const T& value)
+    {
+        seed ^= std::hash<T>{}(value) + 0x9e3779b9 + (seed << 6) +
+                (seed >> 2);
+    }
+
+} // namespace
 
 namespace mrv
 {
@@ -542,12 +553,13 @@ namespace mrv
         TLRENDER_P();
         MRV2_GL();
 
-        const auto& renderSize = getRenderSize();
         const auto& viewportSize = getViewportSize();
-        const math::Matrix4x4f m = math::ortho(
-            0.F, static_cast<float>(renderSize.w), 0.F,
-            static_cast<float>(renderSize.h), -1.F, 1.F);
 
+        // Ghosts are drawn first, so the annotations of this frame are
+        // drawn over them.
+        std::vector<
+            std::pair<std::shared_ptr<draw::Annotation>, float> > visible;
+        visible.reserve(annotations.size());
         for (const auto& annotation : annotations)
         {
             const auto& annotationTime = annotation->time;
@@ -588,43 +600,157 @@ namespace mrv
             if (alphamult == 0.F)
                 continue;
 
+            visible.push_back(std::make_pair(annotation, alphamult));
+        }
+        if (visible.empty())
+            return;
+
+        std::stable_sort(
+            visible.begin(), visible.end(),
+            [](const auto& a, const auto& b) { return a.second < b.second; });
+
+        // The annotation buffer keeps the last annotations drawn.  Only
+        // draw them again if they or the view changed.
+        std::size_t hash = 0;
+        hashCombine(hash, viewportSize.w);
+        hashCombine(hash, viewportSize.h);
+        hashCombine(hash, p.viewPos.x);
+        hashCombine(hash, p.viewPos.y);
+        hashCombine(hash, p.viewZoom);
+        for (int i = 0; i < 16; ++i)
+            hashCombine(hash, mvp.e[i]);
+        for (const auto& i : visible)
+        {
+            hashCombine(hash, i.first.get());
+            hashCombine(hash, i.second);
+            for (const auto& shape : i.first->shapes)
+            {
+                hashCombine(hash, shape.get());
+                hashCombine(hash, shape->version);
+            }
+        }
+        if (hash == gl.annotationHash)
+        {
+            _updateAnnotationNotes(visible);
+        }
+        else if (visible.size() == 1)
+        {
+            _drawAnnotation(mvp, visible[0], gl.annotation);
+            gl.annotationHash = hash;
+        }
+        else
+        {
+            // Each annotation is drawn in its own layer before being
+            // composited, so its erasers don't erase the other annotations.
+            gl::OffscreenBufferOptions offscreenBufferOptions;
+            offscreenBufferOptions.colorType = image::PixelType::RGBA_U8;
+            offscreenBufferOptions.depth = gl::OffscreenDepth::None;
+            offscreenBufferOptions.stencil = gl::OffscreenStencil::None;
+            if (gl::doCreate(
+                    gl.annotationLayer, viewportSize, offscreenBufferOptions))
+            {
+                gl.annotationLayer = gl::OffscreenBuffer::create(
+                    viewportSize, offscreenBufferOptions);
+            }
+
             {
                 gl::OffscreenBufferBinding binding(gl.annotation);
-                gl.render->begin(viewportSize);
-                gl.render->setOCIOOptions(timeline::OCIOOptions());
-                gl.render->setLUTOptions(timeline::LUTOptions());
-                gl.render->setTransform(mvp);
-                const auto& shapes = annotation->shapes;
-                for (const auto& shape : shapes)
-                {
-                    _drawShape(shape, alphamult);
-                }
-                gl.render->end();
+                glViewport(
+                    0, 0, GLsizei(viewportSize.w), GLsizei(viewportSize.h));
+                glClearColor(0.F, 0.F, 0.F, 0.F);
+                glClear(GL_COLOR_BUFFER_BIT);
             }
+            for (const auto& i : visible)
+            {
+                _drawAnnotation(mvp, i, gl.annotationLayer);
 
-            gl::SetAndRestore(GL_BLEND, GL_TRUE);
+                // The layers are premultiplied, so are their alphas.
+                gl::OffscreenBufferBinding binding(gl.annotation);
+                gl::SetAndRestore(GL_BLEND, GL_TRUE);
+                glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+                _drawAnnotationBuffer(
+                    gl.annotationLayer, timeline::Channels::Color);
+            }
+            gl.annotationHash = hash;
+        }
 
-            glBlendFuncSeparate(
-                GL_ONE, GL_ONE_MINUS_SRC_ALPHA, GL_SRC_ALPHA,
-                GL_ONE_MINUS_SRC_ALPHA);
+        gl::SetAndRestore(GL_BLEND, GL_TRUE);
 
-            glViewport(0, 0, GLsizei(viewportSize.w), GLsizei(viewportSize.h));
+        glBlendFuncSeparate(
+            GL_ONE, GL_ONE_MINUS_SRC_ALPHA, GL_SRC_ALPHA,
+            GL_ONE_MINUS_SRC_ALPHA);
 
-            gl.annotationShader->bind();
-            gl.annotationShader->setUniform("transform.mvp", m);
-            timeline::Channels channels = timeline::Channels::Color;
-            if (!p.displayOptions.empty())
-                channels = p.displayOptions[0].channels;
-            gl.annotationShader->setUniform(
-                "channels", static_cast<int>(channels));
+        timeline::Channels channels = timeline::Channels::Color;
+        if (!p.displayOptions.empty())
+            channels = p.displayOptions[0].channels;
+        _drawAnnotationBuffer(gl.annotation, channels);
+    }
 
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, gl.annotation->getColorID());
+    void Viewport::_drawAnnotation(
+        const math::Matrix4x4f& mvp,
+        const std::pair<std::shared_ptr<draw::Annotation>, float>& annotation,
+        const std::shared_ptr<gl::OffscreenBuffer>& buffer)
+    {
+        MRV2_GL();
+
+        const auto& viewportSize = getViewportSize();
+        gl::OffscreenBufferBinding binding(buffer);
+        gl.render->begin(viewportSize);
+        gl.render->setOCIOOptions(timeline::OCIOOptions());
+        gl.render->setLUTOptions(timeline::LUTOptions());
+        gl.render->setTransform(mvp);
+        for (const auto& shape : annotation.first->shapes)
+        {
+            _drawShape(shape, annotation.second);
+        }
+        gl.render->end();
+    }
+
+    void Viewport::_drawAnnotationBuffer(
+        const std::shared_ptr<gl::OffscreenBuffer>& buffer,
+        const timeline::Channels channels)
+    {
+        MRV2_GL();
+
+        const auto& renderSize = getRenderSize();
+        const auto& viewportSize = getViewportSize();
+        const math::Matrix4x4f m = math::ortho(
+            0.F, static_cast<float>(renderSize.w), 0.F,
+            static_cast<float>(renderSize.h), -1.F, 1.F);
+
+        glViewport(0, 0, GLsizei(viewportSize.w), GLsizei(viewportSize.h));
+
+        gl.annotationShader->bind();
+        gl.annotationShader->setUniform("transform.mvp", m);
+        gl.annotationShader->setUniform("channels", static_cast<int>(channels));
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, buffer->getColorID());
+
+        if (gl.vao && gl.vbo)
+        {
+            gl.vao->bind();
+            gl.vao->draw(GL_TRIANGLES, 0, gl.vbo->getSize());
+        }
+    }
+
+    void Viewport::_updateAnnotationNotes(
+        const std::vector<
+            std::pair<std::shared_ptr<draw::Annotation>, float> >& visible)
+        const noexcept
+    {
+        if (!panel::annotationsPanel)
+            return;
 
-            if (gl.vao && gl.vbo)
+        for (const auto& i : visible)
+        {
+            if (i.second != 1.F)
+                continue;
+            for (const auto& shape : i.first->shapes)
             {
-                gl.vao->bind();
-                gl.vao->draw(GL_TRIANGLES, 0, gl.vbo->getSize());
+                auto note = dynamic_cast< draw::NoteShape* >(shape.get());
+                if (note)
+                    panel::annotationsPanel->notes->value(note->text.c_str());
             }
         }
     }
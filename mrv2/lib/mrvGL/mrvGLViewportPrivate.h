@@ -11,6 +11,7 @@
 #include <tlTimelineGL/Render.h>
 #include <tlGL/Shader.h>
 
+#include "mrvGL/mrvGLColorArea.h"
 #include "mrvGL/mrvGLDefines.h"
 #include "mrvGL/mrvGLErrors.h"
 #include "mrvGL/mrvGLLines.h"
@@ -29,6 +30,13 @@ namespace mrv
         std::shared_ptr<tl::gl::OffscreenBuffer> buffer;
         std::shared_ptr<tl::gl::OffscreenBuffer> stereoBuffer;
         std::shared_ptr<tl::gl::OffscreenBuffer> annotation;
+
+        //! Buffer each annotation is drawn in when several are visible.
+        std::shared_ptr<tl::gl::OffscreenBuffer> annotationLayer;
+
+        //! Hash of the annotations and view drawn in the annotation buffer.
+        std::size_t annotationHash = 0;
+
         std::shared_ptr<timeline_gl::Render> render;
         std::shared_ptr<gl::Shader> shader;
         std::shared_ptr<gl::Shader> annotationShader;
@@ -36,6 +44,11 @@ namespace mrv
         int index = 0;
         int nextIndex = 1;
         GLuint pboIds[2];
+
+        //! Size in bytes of each PBO and the area of the render buffer that
+        //! was read into it.  PBOs are sized to the area being read back.
+        size_t pboSizes[2] = {0, 0};
+        math::Box2i pboBoxes[2];
         std::shared_ptr<gl::VBO> vbo;
         std::shared_ptr<gl::VAO> vao;
 
@@ -43,6 +56,7 @@ namespace mrv
         std::shared_ptr<opengl::Outline> outline;
 #endif
         std::shared_ptr<opengl::Lines> lines;
+        std::shared_ptr<opengl::ColorArea> colorArea;
 
 #ifdef TLRENDER_API_GL_4_1_Debug
         bool init_debug = false;
@@ -2496,297 +2496,6 @@ namespace mrv
         return hsv;
     }
 
-    void TimelineViewport::_getPixelValue(
-        image::Color4f& rgba, const std::shared_ptr<image::Image>& image,
-        const math::Vector2i& pos) const noexcept
-    {
-        TLRENDER_P();
-        image::PixelType type = image->getPixelType();
-        uint8_t channels = image::getChannelCount(type);
-        uint8_t depth = image::getBitDepth(type) / 8;
-        const auto& info = image->getInfo();
-        auto pixelAspectRatio = info.size.pixelAspectRatio;
-        image::VideoLevels videoLevels = info.videoLevels;
-        const math::Vector4f& yuvCoefficients =
-            getYUVCoefficients(info.yuvCoefficients);
-        auto size = image->getSize();
-        const uint8_t* data = image->getData();
-        int X = pos.x / pixelAspectRatio;
-        int Y = size.h - pos.y - 1;
-        if (p.displayOptions[0].mirror.x)
-            X = size.w - X - 1;
-        if (p.displayOptions[0].mirror.y)
-            Y = size.h - Y - 1;
-
-        // Do some sanity check just in case
-        if (X < 0 || Y < 0 || X >= size.w || Y >= size.h)
-            return;
-
-        size_t offset = (Y * size.w + X);
-
-        switch (type)
-        {
-        case image::PixelType::YUV_420P_U8:
-        case image::PixelType::YUV_422P_U8:
-        case image::PixelType::YUV_444P_U8:
-            break;
-        case image::PixelType::YUV_420P_U16:
-        case image::PixelType::YUV_422P_U16:
-        case image::PixelType::YUV_444P_U16:
-            break;
-        default:
-            offset *= channels * depth;
-            break;
-        }
-
-        rgba.a = 1.0f;
-        switch (type)
-        {
-        case image::PixelType::L_U8:
-            rgba.r = data[offset] / 255.0f;
-            rgba.g = data[offset] / 255.0f;
-            rgba.b = data[offset] / 255.0f;
-            break;
-        case image::PixelType::LA_U8:
-            rgba.r = data[offset] / 255.0f;
-            rgba.g = data[offset] / 255.0f;
-            rgba.b = data[offset] / 255.0f;
-            rgba.a = data[offset + 1] / 255.0f;
-            break;
-        case image::PixelType::L_U16:
-        {
-            uint16_t* f = (uint16_t*)(&data[offset]);
-            rgba.r = f[0] / 65535.0f;
-            rgba.g = f[0] / 65535.0f;
-            rgba.b = f[0] / 65535.0f;
-            break;
-        }
-        case image::PixelType::LA_U16:
-        {
-            uint16_t* f = (uint16_t*)(&data[offset]);
-            rgba.r = f[0] / 65535.0f;
-            rgba.g = f[0] / 65535.0f;
-            rgba.b = f[0] / 65535.0f;
-            rgba.a = f[1] / 65535.0f;
-            break;
-        }
-        case image::PixelType::L_U32:
-        {
-            uint32_t* f = (uint32_t*)(&data[offset]);
-            constexpr float max =
-                static_cast<float>(std::numeric_limits<uint32_t>::max());
-            rgba.r = f[0] / max;
-            rgba.g = f[0] / max;
-            rgba.b = f[0] / max;
-            break;
-        }
-        case image::PixelType::LA_U32:
-        {
-            uint32_t* f = (uint32_t*)(&data[offset]);
-            constexpr float max =
-                static_cast<float>(std::numeric_limits<uint32_t>::max());
-            rgba.r = f[0] / max;
-            rgba.g = f[0] / max;
-            rgba.b = f[0] / max;
-            rgba.a = f[1] / max;
-            break;
-        }
-        case image::PixelType::L_F16:
-        {
-            half* f = (half*)(&data[offset]);
-            rgba.r = f[0];
-            rgba.g = f[0];
-            rgba.b = f[0];
-            break;
-        }
-        case image::PixelType::LA_F16:
-        {
-            half* f = (half*)(&data[offset]);
-            rgba.r = f[0];
-            rgba.g = f[0];
-            rgba.b = f[0];
-            rgba.a = f[1];
-            break;
-        }
-        case image::PixelType::RGB_U8:
-            rgba.r = data[offset] / 255.0f;
-            rgba.g = data[offset + 1] / 255.0f;
-            rgba.b = data[offset + 2] / 255.0f;
-            break;
-        case image::PixelType::RGB_U10:
-        {
-            image::U10* f = (image::U10*)(&data[offset]);
-            constexpr float max =
-                static_cast<float>(std::numeric_limits<uint32_t>::max());
-            rgba.r = f->r / max;
-            rgba.g = f->g / max;
-            rgba.b = f->b / max;
-            break;
-        }
-        case image::PixelType::RGBA_U8:
-            rgba.r = data[offset] / 255.0f;
-            rgba.g = data[offset + 1] / 255.0f;
-            rgba.b = data[offset + 2] / 255.0f;
-            rgba.a = data[offset + 3] / 255.0f;
-            break;
-        case image::PixelType::RGB_U16:
-        {
-            uint16_t* f = (uint16_t*)(&data[offset]);
-            rgba.r = f[0] / 65535.0f;
-            rgba.g = f[1] / 65535.0f;
-            rgba.b = f[2] / 65535.0f;
-            break;
-        }
-        case image::PixelType::RGBA_U16:
-        {
-            uint16_t* f = (uint16_t*)(&data[offset]);
-            rgba.r = f[0] / 65535.0f;
-            rgba.g = f[1] / 65535.0f;
-            rgba.b = f[2] / 65535.0f;
-            rgba.a = f[3] / 65535.0f;
-            break;
-        }
-        case image::PixelType::RGB_U32:
-        {
-            uint32_t* f = (uint32_t*)(&data[offset]);
-            constexpr float max =
-                static_cast<float>(std::numeric_limits<uint32_t>::max());
-            rgba.r = f[0] / max;
-            rgba.g = f[1] / max;
-            rgba.b = f[2] / max;
-            break;
-        }
-        case image::PixelType::RGBA_U32:
-        {
-            uint32_t* f = (uint32_t*)(&data[offset]);
-            constexpr float max =
-                static_cast<float>(std::numeric_limits<uint32_t>::max());
-            rgba.r = f[0] / max;
-            rgba.g = f[1] / max;
-            rgba.b = f[2] / max;
-            rgba.a = f[3] / max;
-            break;
-        }
-        case image::PixelType::RGB_F16:
-        {
-            half* f = (half*)(&data[offset]);
-            rgba.r = f[0];
-            rgba.g = f[1];
-            rgba.b = f[2];
-            break;
-        }
-        case image::PixelType::RGBA_F16:
-        {
-            half* f = (half*)(&data[offset]);
-            rgba.r = f[0];
-            rgba.g = f[1];
-            rgba.b = f[2];
-            rgba.a = f[3];
-            break;
-        }
-        case image::PixelType::RGB_F32:
-        {
-            float* f = (float*)(&data[offset]);
-            rgba.r = f[0];
-            rgba.g = f[1];
-            rgba.b = f[2];
-            break;
-        }
-        case image::PixelType::RGBA_F32:
-        {
-            float* f = (float*)(&data[offset]);
-            rgba.r = f[0];
-            rgba.g = f[1];
-            rgba.b = f[2];
-            rgba.a = f[3];
-            break;
-        }
-        case image::PixelType::YUV_420P_U8:
-        {
-            size_t Ysize = size.w * size.h;
-            size_t w2 = (size.w + 1) / 2;
-            size_t h2 = (size.h + 1) / 2;
-            size_t Usize = w2 * h2;
-            size_t offset2 = (Y / 2) * w2 + X / 2;
-            rgba.r = data[offset] / 255.0f;
-            rgba.g = data[Ysize + offset2] / 255.0f;
-            rgba.b = data[Ysize + Usize + offset2] / 255.0f;
-            color::checkLevels(rgba, videoLevels);
-            rgba = color::YPbPr::to_rgb(rgba, yuvCoefficients);
-            break;
-        }
-        case image::PixelType::YUV_422P_U8:
-        {
-            size_t Ysize = size.w * size.h;
-            size_t w2 = (size.w + 1) / 2;
-            size_t Usize = w2 * size.h;
-            size_t offset2 = Y * w2 + X / 2;
-            rgba.r = data[offset] / 255.0f;
-            rgba.g = data[Ysize + offset2] / 255.0f;
-            rgba.b = data[Ysize + Usize + offset2] / 255.0f;
-            color::checkLevels(rgba, videoLevels);
-            rgba = color::YPbPr::to_rgb(rgba, yuvCoefficients);
-            break;
-        }
-        case image::PixelType::YUV_444P_U8:
-        {
-            size_t Ysize = size.w * size.h;
-            rgba.r = data[offset] / 255.0f;
-            rgba.g = data[Ysize + offset] / 255.0f;
-            rgba.b = data[Ysize * 2 + offset] / 255.0f;
-            color::checkLevels(rgba, videoLevels);
-            rgba = color::YPbPr::to_rgb(rgba, yuvCoefficients);
-            break;
-        }
-        case image::PixelType::YUV_420P_U16: // Works
-        {
-            uint16_t* f = (uint16_t*)data;
-
-            size_t Ysize = size.w * size.h;
-            size_t w2 = (size.w + 1) / 2;
-            size_t h2 = (size.h + 1) / 2;
-            size_t Usize = w2 * h2;
-            size_t offset2 = (Y / 2) * w2 + X / 2;
-
-            rgba.r = f[offset] / 65535.0f;
-            rgba.g = f[Ysize + offset2] / 65535.0f;
-            rgba.b = f[Ysize + Usize + offset2] / 65535.0f;
-            color::checkLevels(rgba, videoLevels);
-            rgba = color::YPbPr::to_rgb(rgba, yuvCoefficients);
-            break;
-        }
-        case image::PixelType::YUV_422P_U16:
-        {
-            uint16_t* f = (uint16_t*)data;
-
-            size_t Ysize = size.w * size.h;
-            size_t w2 = (size.w + 1) / 2;
-            size_t Usize = w2 * size.h;
-            size_t offset2 = Y * w2 + X / 2;
-
-            rgba.r = f[offset] / 65535.0f;
-            rgba.g = f[Ysize + offset2] / 65535.0f;
-            rgba.b = f[Ysize + Usize + offset2] / 65535.0f;
-            color::checkLevels(rgba, videoLevels);
-            rgba = color::YPbPr::to_rgb(rgba, yuvCoefficients);
-            break;
-        }
-        case image::PixelType::YUV_444P_U16: // Works
-        {
-            uint16_t* f = (uint16_t*)data;
-            size_t Ysize = size.w * size.h;
-            rgba.r = f[offset] / 65535.0f;
-            rgba.g = f[Ysize + offset] / 65535.0f;
-            rgba.b = f[Ysize * 2 + offset] / 65535.0f;
-            color::checkLevels(rgba, videoLevels);
-            rgba = color::YPbPr::to_rgb(rgba, yuvCoefficients);
-            break;
-        }
-        default:
-            break;
-        }
-    }
-
     void TimelineViewport::_calculateColorAreaRawValues(
         area::Info& info) const noexcept
     {
@@ -2893,13 +2602,13 @@ namespace mrv
         info.hsv.diff.a = info.hsv.max.a - info.hsv.min.a;
     }
 
-    void TimelineViewport::_mallocBuffer() const noexcept
+    void TimelineViewport::_mallocBuffer(const math::Box2i& box) const noexcept
     {
         TLRENDER_P();
 
         p.rawImage = true;
-        const math::Size2i& renderSize = getRenderSize();
-        unsigned dataSize = renderSize.w * renderSize.h * 4 * sizeof(float);
+        p.imageBox = box;
+        unsigned dataSize = box.w() * box.h() * 4 * sizeof(float);
 
         if (dataSize != p.rawImageSize || !p.image)
         {
@@ -2909,67 +2618,6 @@ namespace mrv
         }
     }
 
-    void TimelineViewport::_mapBuffer() const noexcept
-    {
-        TLRENDER_P();
-
-        _mallocBuffer();
-        if (!p.image)
-            return;
-
-        const math::Size2i& renderSize = getRenderSize();
-        unsigned maxY = renderSize.h;
-        unsigned maxX = renderSize.w;
-        for (int Y = 0; Y < maxY; ++Y)
-        {
-            for (int X = 0; X < maxX; ++X)
-            {
-                image::Color4f& rgba =
-                    (image::Color4f&)p.image[(X + maxX * Y) * 4];
-                rgba.r = rgba.g = rgba.b = rgba.a = 0.f;
-
-                math::Vector2i pos(X, Y);
-                for (const auto& video : p.videoData)
-                {
-                    for (const auto& layer : video.layers)
-                    {
-                        const auto& image = layer.image;
-                        if (!image->isValid())
-                            continue;
-
-                        image::Color4f pixel, pixelB;
-
-                        _getPixelValue(pixel, image, pos);
-
-                        const auto& imageB = layer.image;
-                        if (imageB->isValid())
-                        {
-                            _getPixelValue(pixelB, imageB, pos);
-
-                            if (layer.transition ==
-                                timeline::Transition::Dissolve)
-                            {
-                                float f2 = layer.transitionValue;
-                                float f = 1.0 - f2;
-                                pixel.r = pixel.r * f + pixelB.r * f2;
-                                pixel.g = pixel.g * f + pixelB.g * f2;
-                                pixel.b = pixel.b * f + pixelB.b * f2;
-                                pixel.a = pixel.a * f + pixelB.a * f2;
-                            }
-                        }
-                        rgba.r += pixel.r;
-                        rgba.g += pixel.g;
-                        rgba.b += pixel.b;
-                        rgba.a += pixel.a;
-                    }
-                    float tmp = rgba.r;
-                    rgba.r = rgba.b;
-                    rgba.b = tmp;
-                }
-            }
-        }
-    }
-
     void TimelineViewport::_unmapBuffer() const noexcept
     {
         TLRENDER_P();
@@ -2986,6 +2634,11 @@ namespace mrv
         return (image::Color4f*)(_p->image);
     }
 
+    const math::Box2i& TimelineViewport::imageBox() const
+    {
+        return _p->imageBox;
+    }
+
     void TimelineViewport::_addAnnotationShapePoint() const
     {
         // We should not update tcp client when not needed
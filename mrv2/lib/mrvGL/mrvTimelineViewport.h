@@ -71,8 +71,13 @@ namespace mrv
         const area::Info& getColorAreaInfo() noexcept;
 
         //! Return the current video image in BGRA order after drawing it.
+        //! Only the area returned by imageBox() is read back, so the
+        //! pixels must be indexed with imageBox().w() as the stride.
         const image::Color4f* image() const;
 
+        //! Return the area of the render buffer that image() holds.
+        const math::Box2i& imageBox() const;
+
         //! Get the compositing status.
         const timeline::BackgroundOptions&
         getBackgroundOptions() const noexcept;
@@ -407,8 +412,8 @@ namespace mrv
 
         void _pushColorMessage(const std::string& command, float value);
 
-        void _mallocBuffer() const noexcept;
-        void _mapBuffer() const noexcept;
+        void _mallocBuffer(const math::Box2i& box) const noexcept;
+        void _mapBuffer(const math::Box2i& box) const noexcept;
         void _unmapBuffer() const noexcept;
 
         void _setFullScreen(bool active) noexcept;
@@ -79,6 +79,7 @@ namespace mrv
     {
         auto s = data->shape;
         s->fade -= kLaserFade;
+        ++s->version;
         if (s->fade <= 0.F)
         {
             Fl::remove_timeout((Fl_Timeout_Handler)laserFade_cb, data);
@@ -239,6 +240,7 @@ namespace mrv
                     shape->pts[2].x = pnt.x;
                     shape->pts[2].y = pnt.y;
                     shape->pts[3].y = pnt.y;
+                    ++shape->version;
                     _updateAnnotationShape();
                     redrawWindows();
                     return;
@@ -250,6 +252,7 @@ namespace mrv
                         return;
 
                     shape->pts.push_back(pnt);
+                    ++shape->version;
                     _addAnnotationShapePoint();
                     redrawWindows();
                     return;
@@ -261,6 +264,7 @@ namespace mrv
                         return;
 
                     shape->pts.push_back(pnt);
+                    ++shape->version;
                     _addAnnotationShapePoint();
                     redrawWindows();
                     return;
@@ -293,6 +297,7 @@ namespace mrv
                     shape->pts[3] = pnt;
                     tmp = pointOnLine + -tNormal * normalVector;
                     shape->pts[4] = tmp;
+                    ++shape->version;
                     _updateAnnotationShape();
 
                     redrawWindows();
@@ -308,6 +313,7 @@ namespace mrv
                         2.0F * abs(shape->center.x - pnt.x) * pixels_per_unit();
                     if (shape->radius < shape->pen_size / 2)
                         shape->radius = shape->pen_size / 2;
+                    ++shape->version;
                     _updateAnnotationShape();
                     redrawWindows();
                     return;
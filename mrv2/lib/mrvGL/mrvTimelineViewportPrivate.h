@@ -133,6 +133,10 @@ namespace mrv
         //! floats.
         float* image = nullptr;
 
+        //! Area of the render buffer stored in image.  Rows are
+        //! imageBox.w() pixels long.
+        math::Box2i imageBox;
+
         //! Mark the buffer as raw, so we will delete with free().
         bool rawImage = true;
 
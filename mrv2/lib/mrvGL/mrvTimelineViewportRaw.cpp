@@ -0,0 +1,394 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// mrv2
+// Copyright Contributors to the mrv2 Project. All rights reserved.
+
+#include <cstring>
+#include <limits>
+
+#include <Imath/half.h>
+
+#include "mrViewer.h"
+
+#include "mrvCore/mrvColorSpaces.h"
+#include "mrvCore/mrvParallel.h"
+
+#include "mrvGL/mrvTimelineViewport.h"
+#include "mrvGL/mrvTimelineViewportPrivate.h"
+
+namespace mrv
+{
+    namespace
+    {
+        //! Image information needed to decode the raw pixels of an image.
+        //! It is calculated once per image, not once per pixel.
+        struct RawImage
+        {
+            const uint8_t* data = nullptr;
+            int width = 0;
+            int height = 0;
+            float pixelAspectRatio = 1.F;
+            bool mirrorX = false;
+            bool mirrorY = false;
+            image::VideoLevels videoLevels = image::VideoLevels::FullRange;
+            math::Vector4f yuvCoefficients;
+
+            //! Image row of a raster row or -1 if outside.
+            inline int row(const int Y) const noexcept
+            {
+                int out = height - Y - 1;
+                if (mirrorY)
+                    out = height - out - 1;
+                return (out < 0 || out >= height) ? -1 : out;
+            }
+
+            //! Image column of a raster column or -1 if outside.
+            inline int column(const int X) const noexcept
+            {
+                int out = X / pixelAspectRatio;
+                if (mirrorX)
+                    out = width - out - 1;
+                return (out < 0 || out >= width) ? -1 : out;
+            }
+
+            //! Whether raster columns map 1:1 to image columns.
+            inline bool isContiguous() const noexcept
+            {
+                return pixelAspectRatio == 1.F && !mirrorX;
+            }
+        };
+
+        //! Decode raster pixels [x0, x1] of raster row Y, adding them to
+        //! out.
+        using RowFunc = void (*)(
+            const RawImage&, const int Y, const int x0, const int x1,
+            image::Color4f* out);
+
+        template < typename T > inline float toFloat(const T v) noexcept;
+
+        template <> inline float toFloat(const uint8_t v) noexcept
+        {
+            return v * (1.F / 255.F);
+        }
+
+        template <> inline float toFloat(const uint16_t v) noexcept
+        {
+            return v * (1.F / 65535.F);
+        }
+
+        template <> inline float toFloat(const uint32_t v) noexcept
+        {
+            constexpr float max =
+                static_cast<float>(std::numeric_limits<uint32_t>::max());
+            return v / max;
+        }
+
+        template <> inline float toFloat(const half v) noexcept
+        {
+            return v;
+        }
+
+        template <> inline float toFloat(const float v) noexcept
+        {
+            return v;
+        }
+
+        //! Add an interleaved pixel of C channels to out.
+        template < typename T, int C >
+        inline void addPixel(const T* in, image::Color4f& out) noexcept
+        {
+            if constexpr (C == 1)
+            {
+                const float l = toFloat(in[0]);
+                out.r += l;
+                out.g += l;
+                out.b += l;
+                out.a += 1.F;
+            }
+            else if constexpr (C == 2)
+            {
+                const float l = toFloat(in[0]);
+                out.r += l;
+                out.g += l;
+                out.b += l;
+                out.a += toFloat(in[1]);
+            }
+            else if constexpr (C == 3)
+            {
+                out.r += toFloat(in[0]);
+                out.g += toFloat(in[1]);
+                out.b += toFloat(in[2]);
+                out.a += 1.F;
+            }
+            else
+            {
+                out.r += toFloat(in[0]);
+                out.g += toFloat(in[1]);
+                out.b += toFloat(in[2]);
+                out.a += toFloat(in[3]);
+            }
+        }
+
+        //! Row kernel for interleaved L, LA, RGB and RGBA images.
+        template < typename T, int C >
+        void interleavedRow(
+            const RawImage& img, const int Y, const int x0, const int x1,
+            image::Color4f* out)
+        {
+            const int y = img.row(Y);
+            if (y < 0)
+                return;
+
+            const T* row = reinterpret_cast<const T*>(img.data) +
+                           static_cast<size_t>(y) * img.width * C;
+
+            if (img.isContiguous())
+            {
+                // Straight conversion loop the compiler can vectorize.
+                const int start = std::max(x0, 0);
+                const int end = std::min(x1, img.width - 1);
+                const T* in = row + static_cast<size_t>(start) * C;
+                image::Color4f* o = out + (start - x0);
+                for (int X = start; X <= end; ++X, in += C, ++o)
+                    addPixel<T, C>(in, *o);
+                return;
+            }
+
+            for (int X = x0; X <= x1; ++X, ++out)
+            {
+                const int x = img.column(X);
+                if (x < 0)
+                    continue;
+                addPixel<T, C>(row + static_cast<size_t>(x) * C, *out);
+            }
+        }
+
+        //! Row kernel for RGB_U10 images.
+        void rgbU10Row(
+            const RawImage& img, const int Y, const int x0, const int x1,
+            image::Color4f* out)
+        {
+            const int y = img.row(Y);
+            if (y < 0)
+                return;
+
+            const image::U10* row = reinterpret_cast<const image::U10*>(
+                                        img.data) +
+                                    static_cast<size_t>(y) * img.width;
+            constexpr float max =
+                static_cast<float>(std::numeric_limits<uint32_t>::max());
+            for (int X = x0; X <= x1; ++X, ++out)
+            {
+                const int x = img.column(X);
+                if (x < 0)
+                    continue;
+                const image::U10& in = row[x];
+                out->r += in.r / max;
+                out->g += in.g / max;
+                out->b += in.b / max;
+                out->a += 1.F;
+            }
+        }
+
+        //! Row kernel for planar YUV images.  XShift and YShift are the
+        //! chroma subsampling (1, 1 for 420, 1, 0 for 422 and 0, 0 for 444).
+        template < typename T, int XShift, int YShift >
+        void yuvRow(
+            const RawImage& img, const int Y, const int x0, const int x1,
+            image::Color4f* out)
+        {
+            const int y = img.row(Y);
+            if (y < 0)
+                return;
+
+            const size_t w = img.width;
+            const size_t h = img.height;
+            const size_t w2 = XShift ? (w + 1) / 2 : w;
+            const size_t h2 = YShift ? (h + 1) / 2 : h;
+            const T* planeY = reinterpret_cast<const T*>(img.data);
+            const T* planeU = planeY + w * h;
+            const T* planeV = planeU + w2 * h2;
+
+            const T* rowY = planeY + y * w;
+            const T* rowU = planeU + (y >> YShift) * w2;
+            const T* rowV = planeV + (y >> YShift) * w2;
+
+            for (int X = x0; X <= x1; ++X, ++out)
+            {
+                const int x = img.column(X);
+                if (x < 0)
+                    continue;
+                image::Color4f c(
+                    toFloat(rowY[x]), toFloat(rowU[x >> XShift]),
+                    toFloat(rowV[x >> XShift]), 1.F);
+                color::checkLevels(c, img.videoLevels);
+                c = color::YPbPr::to_rgb(c, img.yuvCoefficients);
+                out->r += c.r;
+                out->g += c.g;
+                out->b += c.b;
+                out->a += c.a;
+            }
+        }
+
+        //! Pick the row kernel of a pixel type.
+        RowFunc getRowFunc(const image::PixelType type) noexcept
+        {
+            switch (type)
+            {
+            case image::PixelType::L_U8:
+                return interleavedRow<uint8_t, 1>;
+            case image::PixelType::L_U16:
+                return interleavedRow<uint16_t, 1>;
+            case image::PixelType::L_U32:
+                return interleavedRow<uint32_t, 1>;
+            case image::PixelType::L_F16:
+                return interleavedRow<half, 1>;
+            case image::PixelType::L_F32:
+                return interleavedRow<float, 1>;
+            case image::PixelType::LA_U8:
+                return interleavedRow<uint8_t, 2>;
+            case image::PixelType::LA_U16:
+                return interleavedRow<uint16_t, 2>;
+            case image::PixelType::LA_U32:
+                return interleavedRow<uint32_t, 2>;
+            case image::PixelType::LA_F16:
+                return interleavedRow<half, 2>;
+            case image::PixelType::LA_F32:
+                return interleavedRow<float, 2>;
+            case image::PixelType::RGB_U8:
+                return interleavedRow<uint8_t, 3>;
+            case image::PixelType::RGB_U10:
+                return rgbU10Row;
+            case image::PixelType::RGB_U16:
+                return interleavedRow<uint16_t, 3>;
+            case image::PixelType::RGB_U32:
+                return interleavedRow<uint32_t, 3>;
+            case image::PixelType::RGB_F16:
+                return interleavedRow<half, 3>;
+            case image::PixelType::RGB_F32:
+                return interleavedRow<float, 3>;
+            case image::PixelType::RGBA_U8:
+                return interleavedRow<uint8_t, 4>;
+            case image::PixelType::RGBA_U16:
+                return interleavedRow<uint16_t, 4>;
+            case image::PixelType::RGBA_U32:
+                return interleavedRow<uint32_t, 4>;
+            case image::PixelType::RGBA_F16:
+                return interleavedRow<half, 4>;
+            case image::PixelType::RGBA_F32:
+                return interleavedRow<float, 4>;
+            case image::PixelType::YUV_420P_U8:
+                return yuvRow<uint8_t, 1, 1>;
+            case image::PixelType::YUV_422P_U8:
+                return yuvRow<uint8_t, 1, 0>;
+            case image::PixelType::YUV_444P_U8:
+                return yuvRow<uint8_t, 0, 0>;
+            case image::PixelType::YUV_420P_U16:
+                return yuvRow<uint16_t, 1, 1>;
+            case image::PixelType::YUV_422P_U16:
+                return yuvRow<uint16_t, 1, 0>;
+            case image::PixelType::YUV_444P_U16:
+                return yuvRow<uint16_t, 0, 0>;
+            default:
+                return nullptr;
+            }
+        }
+
+        RawImage getRawImage(
+            const std::shared_ptr<image::Image>& image,
+            const timeline::DisplayOptions& displayOptions) noexcept
+        {
+            RawImage out;
+            const auto& info = image->getInfo();
+            const auto& size = image->getSize();
+            out.data = image->getData();
+            out.width = size.w;
+            out.height = size.h;
+            out.pixelAspectRatio = info.size.pixelAspectRatio;
+            out.mirrorX = displayOptions.mirror.x;
+            out.mirrorY = displayOptions.mirror.y;
+            out.videoLevels = info.videoLevels;
+            out.yuvCoefficients = getYUVCoefficients(info.yuvCoefficients);
+            return out;
+        }
+    } // namespace
+
+    void TimelineViewport::_getPixelValue(
+        image::Color4f& rgba, const std::shared_ptr<image::Image>& image,
+        const math::Vector2i& pos) const noexcept
+    {
+        TLRENDER_P();
+
+        const RowFunc func = getRowFunc(image->getPixelType());
+        if (!func)
+            return;
+
+        const RawImage raw = getRawImage(image, p.displayOptions[0]);
+        if (raw.row(pos.y) < 0 || raw.column(pos.x) < 0)
+            return;
+
+        rgba.r = rgba.g = rgba.b = rgba.a = 0.F;
+        func(raw, pos.y, pos.x, pos.x, &rgba);
+    }
+
+    void TimelineViewport::_mapBuffer(const math::Box2i& box) const noexcept
+    {
+        TLRENDER_P();
+
+        // Only decode the area requested, clamped to the render size.
+        const math::Size2i& renderSize = getRenderSize();
+        const math::Box2i area =
+            box.intersect(math::Box2i(0, 0, renderSize.w, renderSize.h));
+        if (area.min.x > area.max.x || area.min.y > area.max.y)
+            return;
+
+        _mallocBuffer(area);
+        if (!p.image)
+            return;
+
+        const int stride = area.w();
+        memset(p.image, 0, stride * area.h() * sizeof(image::Color4f));
+
+        // Pick the kernel of each image once, not once per pixel.
+        std::vector<std::pair<RawImage, RowFunc> > sources;
+        for (const auto& video : p.videoData)
+        {
+            for (const auto& layer : video.layers)
+            {
+                const auto& image = layer.image;
+                if (!image || !image->isValid())
+                    continue;
+
+                const RowFunc func = getRowFunc(image->getPixelType());
+                if (!func)
+                    continue;
+
+                sources.push_back(
+                    std::make_pair(getRawImage(image, p.displayOptions[0]), func));
+            }
+        }
+
+        image::Color4f* pixels = reinterpret_cast<image::Color4f*>(p.image);
+        parallel_for(
+            area.min.y, area.max.y + 1,
+            [&sources, &area, pixels, stride](int, int y0, int y1)
+            {
+                for (int Y = y0; Y < y1; ++Y)
+                {
+                    image::Color4f* row =
+                        pixels + static_cast<size_t>(Y - area.min.y) * stride;
+                    for (const auto& source : sources)
+                    {
+                        source.second(
+                            source.first, Y, area.min.x, area.max.x, row);
+                    }
+
+                    // We store the pixels in BGRA order, like the GPU
+                    // read back.
+                    for (int X = 0; X < stride; ++X)
+                        std::swap(row[X].r, row[X].b);
+                }
+            },
+            16);
+    }
+
+} // namespace mrv
@@ -2,6 +2,12 @@
 // Copyright (c) 2021-2023 Darby Johnston
 // All rights reserved.
 
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 #include <FL/Fl_Box.H>
 #include <FL/Fl_Double_Window.H>
 #include <FL/Fl.H>
@@ -21,6 +27,7 @@
 
 #include "mrvCore/mrvFile.h"
 #include "mrvCore/mrvHotkey.h"
+#include "mrvCore/mrvThumbnailCache.h"
 #include "mrvCore/mrvTimeObject.h"
 
 #include "mrvEdit/mrvEditCallbacks.h"
@@ -49,6 +56,15 @@ namespace mrv
         const int kWINDOW_BORDERS = 2;
         const int kBOX_BORDERS = 2;
 
+        //! Maximum number of thumbnails in the filmstrip.
+        const int kFILMSTRIP_SLOTS = 128;
+
+        //! Filmstrip requests in flight, so the hover request stays fast.
+        const size_t kFILMSTRIP_REQUESTS = 2;
+
+        //! Filmstrip thumbnails looked up in the disk cache at a time.
+        const int kFILMSTRIP_LOADS = 8;
+
         const double kTimeout = 0.008; // approx. 120 fps
         const char* kModule = "timeline";
     } // namespace
@@ -170,6 +186,113 @@ namespace mrv
                 Fl::copy(value.c_str(), value.size());
             }
         };
+
+        //! Looks up the filmstrip thumbnails in the persistent cache in a
+        //! background thread, so the timer tick does not stat or read files.
+        class FilmstripLoader
+        {
+        public:
+            struct Result
+            {
+                uint64_t generation = 0;
+                int slot = 0;
+                std::string cacheKey;
+
+                //! Owned by the receiver.  nullptr if not in the cache.
+                Fl_RGB_Image* image = nullptr;
+            };
+
+            ~FilmstripLoader()
+            {
+                {
+                    std::lock_guard lk(mutex);
+                    stopped = true;
+                    jobs.clear();
+                }
+                condition.notify_one();
+                if (thread.joinable())
+                    thread.join();
+                for (auto& result : results)
+                    delete result.image;
+            }
+
+            void load(
+                uint64_t generation, int slot, const file::Path& path,
+                const otime::RationalTime& time)
+            {
+                {
+                    std::lock_guard lk(mutex);
+                    jobs.push_back({generation, slot, path, time});
+                    if (!thread.joinable())
+                        thread = std::thread([this] { _run(); });
+                }
+                condition.notify_one();
+            }
+
+            //! Drop the jobs of older generations.
+            void cancel(uint64_t generation)
+            {
+                std::lock_guard lk(mutex);
+                for (auto i = jobs.begin(); i != jobs.end();)
+                {
+                    if (i->generation != generation)
+                        i = jobs.erase(i);
+                    else
+                        ++i;
+                }
+            }
+
+            std::vector<Result> takeResults()
+            {
+                std::lock_guard lk(mutex);
+                std::vector<Result> out;
+                out.swap(results);
+                return out;
+            }
+
+        private:
+            struct Job
+            {
+                uint64_t generation = 0;
+                int slot = 0;
+                file::Path path;
+                otime::RationalTime time;
+            };
+
+            void _run()
+            {
+                while (true)
+                {
+                    Job job;
+                    {
+                        std::unique_lock lk(mutex);
+                        condition.wait(
+                            lk, [this] { return stopped || !jobs.empty(); });
+                        if (stopped)
+                            return;
+                        job = std::move(jobs.front());
+                        jobs.pop_front();
+                    }
+
+                    Result result;
+                    result.generation = job.generation;
+                    result.slot = job.slot;
+                    result.cacheKey =
+                        thumbnail::cacheKey(job.path, kTHUMB_HEIGHT, job.time);
+                    result.image = thumbnail::cachedImage(result.cacheKey);
+
+                    std::lock_guard lk(mutex);
+                    results.push_back(std::move(result));
+                }
+            }
+
+            std::mutex mutex;
+            std::condition_variable condition;
+            std::deque<Job> jobs;
+            std::vector<Result> results;
+            bool stopped = false;
+            std::thread thread;
+        };
     } // namespace
 
     struct TimelineWidget::Private
@@ -188,8 +311,50 @@ namespace mrv
         {
             ui::ThumbnailRequest request;
             std::shared_ptr<image::Image> image;
+
+            //! Key of the persistent thumbnail cache.
+            std::string cacheKey;
         };
         ThumbnailData thumbnail;
+
+        //! Evenly spaced thumbnails of the active clip, decoded in the
+        //! background coarsest first, so the hover window can show the
+        //! nearest one while the exact thumbnail is decoded.
+        struct FilmstripData
+        {
+            file::Path path;
+            otime::TimeRange timeRange = time::invalidTimeRange;
+            int slots = 0;
+
+            //! Slots still to be looked up, in refinement order.
+            std::deque<int> pending;
+
+            //! Bumped on reset, so stale loader results are dropped.
+            uint64_t generation = 0;
+
+            //! Slots being looked up in the persistent cache.
+            int loading = 0;
+
+            //! Slots that were not in the persistent cache, with their keys.
+            std::deque<std::pair<int, std::string> > misses;
+
+            struct Request
+            {
+                int slot = 0;
+                std::string cacheKey;
+                ui::ThumbnailRequest request;
+            };
+            std::vector<Request> requests;
+
+            //! Atlas of pre-flipped RGBA_U8 tiles, one per slot.
+            int tileW = 0;
+            int tileH = 0;
+            std::vector<uint8_t> pixels;
+            std::vector<bool> filled;
+
+            FilmstripLoader loader;
+        };
+        FilmstripData filmstrip;
         
         Fl_Double_Window* thumbnailWindow = nullptr; // thumbnail window
         Fl_Box* box = nullptr;
@@ -222,6 +387,8 @@ namespace mrv
             cacheInfoObserver;
 
         std::vector<otime::RationalTime> annotationTimes;
+        TimelinePlayer* annotationsPlayer = nullptr;
+        uint64_t annotationsVersion = 0;
         otime::TimeRange timeRange = time::invalidTimeRange;
     };
 
@@ -325,6 +492,7 @@ namespace mrv
     TimelineWidget::~TimelineWidget()
     {
         _cancelThumbnailRequests();
+        _cancelFilmstripRequests();
         Fl::remove_timeout(timerEvent_cb, this);
     }
 
@@ -576,19 +744,29 @@ namespace mrv
 
         repositionThumbnail();
 
-        file::Path path;
-        auto model = p.ui->app->filesModel();
-        auto Aitem = model->observeA()->get();
-        if (Aitem)
-            path = Aitem->path;
-        else
-            path = player->getPath();
-
+        const file::Path& path = _thumbnailPath();
         const image::Size size(kTHUMB_WIDTH, kTHUMB_HEIGHT);
         const auto& time = _posToTime(_toUI(Fl::event_x()));
 
-        if (auto thumbnailSystem = p.thumbnailSystem.lock())
+        p.thumbnail.cacheKey = thumbnail::cacheKey(path, size.h, time);
+        if (auto rgbImage = thumbnail::cachedImage(p.thumbnail.cacheKey))
+        {
+            _cancelThumbnailRequests();
+            p.box->bind_image(rgbImage);
+            p.box->redraw();
+            repositionThumbnail();
+        }
+        else if (auto thumbnailSystem = p.thumbnailSystem.lock())
         {
+            // Show the nearest filmstrip thumbnail until the exact one is
+            // decoded.
+            if (auto rgbImage = _filmstripImage(time))
+            {
+                p.box->bind_image(rgbImage);
+                p.box->redraw();
+                repositionThumbnail();
+            }
+            _cancelThumbnailRequests();
             p.thumbnail.request = thumbnailSystem->getThumbnail(path, size.h, time);
         }
         
@@ -606,10 +784,277 @@ namespace mrv
             if (p.thumbnail.request.future.valid())
             {
                 thumbnailSystem->cancelRequests({ p.thumbnail.request.id });
+                p.thumbnail.request = ui::ThumbnailRequest();
             }
         }
     }
     
+    file::Path TimelineWidget::_thumbnailPath() const
+    {
+        TLRENDER_P();
+
+        auto model = p.ui->app->filesModel();
+        auto Aitem = model->observeA()->get();
+        if (Aitem)
+            return Aitem->path;
+        if (p.player)
+            return p.player->player()->getPath();
+        return file::Path();
+    }
+
+    namespace
+    {
+        otime::RationalTime filmstripTime(
+            const otime::TimeRange& timeRange, int slot, int slots)
+        {
+            const double frames = timeRange.duration().value();
+            const double rate = timeRange.duration().rate();
+            return timeRange.start_time() +
+                   otime::RationalTime(
+                       std::floor(frames * slot / slots), rate);
+        }
+    } // namespace
+
+    void TimelineWidget::_filmstripEvent()
+    {
+        TLRENDER_P();
+
+        if (!p.player || !p.ui->uiPrefs->uiPrefsTimelineThumbnails->value())
+        {
+            _cancelFilmstripRequests();
+            return;
+        }
+
+        const file::Path& path = _thumbnailPath();
+        const auto& timeRange = p.player->player()->getTimeRange();
+        auto& filmstrip = p.filmstrip;
+        if (path.get() != filmstrip.path.get() ||
+            timeRange != filmstrip.timeRange)
+        {
+            _resetFilmstrip(path, timeRange);
+        }
+
+        for (auto& result : filmstrip.loader.takeResults())
+        {
+            if (result.generation != filmstrip.generation)
+            {
+                delete result.image;
+                continue;
+            }
+            --filmstrip.loading;
+            if (result.image)
+            {
+                _setFilmstripTile(result.slot, result.image);
+                delete result.image;
+            }
+            else
+            {
+                filmstrip.misses.push_back(
+                    std::make_pair(result.slot, result.cacheKey));
+            }
+        }
+
+        auto thumbnailSystem = p.thumbnailSystem.lock();
+        if (!thumbnailSystem)
+            return;
+
+        auto i = filmstrip.requests.begin();
+        while (i != filmstrip.requests.end())
+        {
+            if (i->request.future.valid() &&
+                i->request.future.wait_for(std::chrono::seconds(0)) ==
+                    std::future_status::ready)
+            {
+                Fl_RGB_Image* rgbImage =
+                    thumbnail::storeImage(i->cacheKey, i->request.future.get());
+                _setFilmstripTile(i->slot, rgbImage);
+                delete rgbImage;
+                i = filmstrip.requests.erase(i);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+
+        // Do not compete with playback for the decoders or the disk.
+        if (p.player->playback() != timeline::Playback::Stop)
+        {
+            _cancelFilmstripRequests();
+            return;
+        }
+
+        // The hover thumbnail has priority over the filmstrip.
+        if (p.thumbnail.request.future.valid() &&
+            p.thumbnail.request.future.wait_for(std::chrono::seconds(0)) !=
+                std::future_status::ready)
+            return;
+
+        while (!filmstrip.misses.empty() &&
+               filmstrip.requests.size() < kFILMSTRIP_REQUESTS)
+        {
+            FilmstripData::Request request;
+            request.slot = filmstrip.misses.front().first;
+            request.cacheKey = filmstrip.misses.front().second;
+            filmstrip.misses.pop_front();
+
+            const auto& time = filmstripTime(
+                filmstrip.timeRange, request.slot, filmstrip.slots);
+            request.request =
+                thumbnailSystem->getThumbnail(path, kTHUMB_HEIGHT, time);
+            filmstrip.requests.push_back(std::move(request));
+        }
+
+        // Keep a few slots ahead in the persistent cache lookups, but not
+        // too many, as most of the misses have to be decoded anyway.
+        while (!filmstrip.pending.empty() &&
+               filmstrip.loading < kFILMSTRIP_LOADS &&
+               filmstrip.misses.size() < kFILMSTRIP_REQUESTS)
+        {
+            const int slot = filmstrip.pending.front();
+            filmstrip.pending.pop_front();
+
+            const auto& time =
+                filmstripTime(filmstrip.timeRange, slot, filmstrip.slots);
+            filmstrip.loader.load(filmstrip.generation, slot, path, time);
+            ++filmstrip.loading;
+        }
+    }
+
+    void TimelineWidget::_resetFilmstrip(
+        const file::Path& path, const otime::TimeRange& timeRange)
+    {
+        TLRENDER_P();
+
+        _cancelFilmstripRequests();
+
+        auto& filmstrip = p.filmstrip;
+        filmstrip.path = path;
+        filmstrip.timeRange = timeRange;
+        filmstrip.slots = 0;
+        filmstrip.pending.clear();
+        filmstrip.misses.clear();
+        filmstrip.loading = 0;
+        filmstrip.loader.cancel(++filmstrip.generation);
+        filmstrip.tileW = filmstrip.tileH = 0;
+        filmstrip.pixels.clear();
+        filmstrip.filled.clear();
+
+        if (path.isEmpty() || !time::isValid(timeRange))
+            return;
+
+        const int frames = static_cast<int>(timeRange.duration().value());
+        filmstrip.slots = std::min(kFILMSTRIP_SLOTS, std::max(frames, 1));
+        filmstrip.filled.resize(filmstrip.slots, false);
+
+        // Request the slots coarsest first (start, middle, quarters, ...),
+        // so the whole clip is covered early and refined progressively.
+        int step = 1;
+        while (step * 2 <= filmstrip.slots)
+            step *= 2;
+        std::vector<bool> queued(filmstrip.slots, false);
+        for (; step >= 1; step /= 2)
+        {
+            for (int slot = 0; slot < filmstrip.slots; slot += step)
+            {
+                if (queued[slot])
+                    continue;
+                queued[slot] = true;
+                filmstrip.pending.push_back(slot);
+            }
+        }
+    }
+
+    void TimelineWidget::_cancelFilmstripRequests()
+    {
+        TLRENDER_P();
+
+        auto& filmstrip = p.filmstrip;
+        if (auto thumbnailSystem = p.thumbnailSystem.lock())
+        {
+            std::vector<uint64_t> ids;
+            for (auto& request : filmstrip.requests)
+            {
+                ids.push_back(request.request.id);
+                // Put the slot back, so the filmstrip can resume later.
+                filmstrip.pending.push_front(request.slot);
+            }
+            if (!ids.empty())
+                thumbnailSystem->cancelRequests(ids);
+        }
+        filmstrip.requests.clear();
+    }
+
+    void TimelineWidget::_setFilmstripTile(int slot, const Fl_RGB_Image* image)
+    {
+        TLRENDER_P();
+
+        auto& filmstrip = p.filmstrip;
+        if (!image || image->d() != 4 || slot < 0 || slot >= filmstrip.slots)
+            return;
+
+        if (filmstrip.pixels.empty())
+        {
+            filmstrip.tileW = image->w();
+            filmstrip.tileH = image->h();
+            filmstrip.pixels.resize(
+                static_cast<size_t>(filmstrip.slots) * filmstrip.tileW *
+                filmstrip.tileH * 4);
+        }
+
+        // Clips of different sizes in an .otio do not fit in the atlas.
+        if (image->w() != filmstrip.tileW || image->h() != filmstrip.tileH)
+            return;
+
+        const size_t tileBytes =
+            static_cast<size_t>(filmstrip.tileW) * filmstrip.tileH * 4;
+        const uint8_t* data =
+            reinterpret_cast<const uint8_t*>(image->data()[0]);
+        memcpy(filmstrip.pixels.data() + slot * tileBytes, data, tileBytes);
+        filmstrip.filled[slot] = true;
+    }
+
+    Fl_RGB_Image*
+    TimelineWidget::_filmstripImage(const otime::RationalTime& time) const
+    {
+        TLRENDER_P();
+
+        const auto& filmstrip = p.filmstrip;
+        if (filmstrip.pixels.empty() || !time::isValid(filmstrip.timeRange))
+            return nullptr;
+
+        const double frames = filmstrip.timeRange.duration().value();
+        const double offset =
+            (time - filmstrip.timeRange.start_time())
+                .rescaled_to(filmstrip.timeRange.duration().rate())
+                .value();
+        const int slot = math::clamp(
+            static_cast<int>(std::floor(offset * filmstrip.slots / frames)), 0,
+            filmstrip.slots - 1);
+
+        // Nearest filled slot.
+        int found = -1;
+        for (int d = 0; d < filmstrip.slots && found < 0; ++d)
+        {
+            if (slot - d >= 0 && filmstrip.filled[slot - d])
+                found = slot - d;
+            else if (slot + d < filmstrip.slots && filmstrip.filled[slot + d])
+                found = slot + d;
+        }
+        if (found < 0)
+            return nullptr;
+
+        const int w = filmstrip.tileW;
+        const int h = filmstrip.tileH;
+        const size_t tileBytes = static_cast<size_t>(w) * h * 4;
+        uint8_t* pixelData = new uint8_t[tileBytes];
+        memcpy(pixelData, filmstrip.pixels.data() + found * tileBytes, tileBytes);
+
+        auto rgbImage = new Fl_RGB_Image(pixelData, w, h, 4);
+        rgbImage->alloc_array = true;
+        return rgbImage;
+    }
+
     timelineui::ItemOptions TimelineWidget::getItemOptions() const
     {
         return _p->timelineWidget->getItemOptions();
@@ -640,6 +1085,7 @@ namespace mrv
         else
         {
             _cancelThumbnailRequests();
+            _resetFilmstrip(file::Path(), time::invalidTimeRange);
             p.box->image(nullptr);
 
             p.timeRange = time::invalidTimeRange;
@@ -808,8 +1254,14 @@ namespace mrv
             valid(1);
         }
 
-        if (p.player && p.player->hasAnnotations())
+        // Only get the annotation times when annotations were added or
+        // removed.
+        if (p.player &&
+            (p.player != p.annotationsPlayer ||
+             p.player->annotationsVersion() != p.annotationsVersion))
         {
+            p.annotationsPlayer = p.player;
+            p.annotationsVersion = p.player->annotationsVersion();
             const auto& times = p.player->getAnnotationTimes();
             if (p.annotationTimes != times)
             {
@@ -1524,32 +1976,14 @@ namespace mrv
         if (p.thumbnail.request.future.valid() &&
             p.thumbnail.request.future.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
         {
-            if (auto image = p.thumbnail.request.future.get())
+            if (auto rgbImage = thumbnail::storeImage(
+                    p.thumbnail.cacheKey, p.thumbnail.request.future.get()))
             {
-                if (image::PixelType::RGBA_U8 == image->getPixelType())
-                {
-                    const int w = image->getWidth();
-                    const int h = image->getHeight();
-                    const int depth = 4;
-
-                    uint8_t* pixelData = new uint8_t[w * h * depth];
-
-                    auto rgbImage = new Fl_RGB_Image(pixelData, w, h, depth);
-                    rgbImage->alloc_array = true;
-
-                    uint8_t* d = pixelData;
-                    const uint8_t* s = image->getData();
-                    for (int y = 0; y < h; ++y)
-                    {
-                        memcpy(d + (h - 1 - y) * w * 4, s + y * w * 4, w * 4);
-                    }
-                    p.box->bind_image(rgbImage);
-                    p.box->redraw();
-                    repositionThumbnail();
-                }
+                p.box->bind_image(rgbImage);
+                p.box->redraw();
+                repositionThumbnail();
             }
         }
-        
     }
 
     void TimelineWidget::timerEvent()
@@ -1559,6 +1993,7 @@ namespace mrv
         _tickEvent();
 
         _thumbnailEvent();
+        _filmstripEvent();
 
         if (_getSizeUpdate(p.timelineWindow))
         {
@@ -28,6 +28,7 @@ namespace tl
 } // namespace tl
 
 class ViewerUI;
+class Fl_RGB_Image;
 
 namespace mrv
 {
@@ -164,6 +165,17 @@ namespace mrv
         void _setTimeUnits(tl::timeline::TimeUnits);
 
         void _cancelThumbnailRequests();
+
+        //! Path used for the timeline thumbnails.
+        file::Path _thumbnailPath() const;
+
+        //! @{ Filmstrip of the hover thumbnails.
+        void _filmstripEvent();
+        void _resetFilmstrip(const file::Path&, const otime::TimeRange&);
+        void _cancelFilmstripRequests();
+        void _setFilmstripTile(int slot, const Fl_RGB_Image*);
+        Fl_RGB_Image* _filmstripImage(const otime::RationalTime&) const;
+        //! @}
         
         void _tickEvent();
         void _tickEvent(
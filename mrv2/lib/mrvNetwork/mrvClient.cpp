@@ -22,6 +22,8 @@
 namespace
 {
     const char* kModule = "client";
+
+    const Poco::Timespan kPollTimeout(0, 250000);
 }
 
 namespace mrv
@@ -56,6 +58,13 @@ namespace mrv
             m_host = host;
             m_running = true;
 
+            // Ask the server for all of its state.
+            Message request;
+            request["command"] = "Sync Request";
+            pushMessage(request);
+
+            // The receive thread blocks until the socket is readable and
+            // the send thread until there are messages to send.
             std::thread* receive = new std::thread(
                 [this]
                 {
@@ -70,6 +79,7 @@ namespace mrv
                 {
                     while (m_running)
                     {
+                        waitForSend();
                         sendMessages();
                     }
                 });
@@ -87,17 +97,16 @@ namespace mrv
 
     void Client::sendMessages()
     {
-        Message message;
+        // Send without holding the lock, so pushMessage does not wait
+        // for the socket.
+        std::list< Message > messages = takeSend();
         try
         {
-            std::lock_guard lk(m_sendMutex);
             int size;
 
-            while (hasSend())
+            for (auto& message : messages)
             {
-                message = m_send.front();
-                m_send.pop_front();
-
+                packMessage(message);
                 std::vector< uint8_t > v_bson =
                     nlohmann::json::to_bson(message);
                 int messageLength = v_bson.size();
@@ -111,8 +120,7 @@ namespace mrv
                     &messageLengthHtoNL, sizeof(messageLength));
                 if (size <= 0)
                 {
-                    m_send.clear();
-                    m_running = false;
+                    setStopped();
                     close();
                     break;
                 }
@@ -124,25 +132,21 @@ namespace mrv
                         v_bson.data() + len, messageLength - len);
                     if (size <= 0)
                     {
-                        m_send.clear();
-                        m_running = false;
+                        setStopped();
                         close();
                         break;
                     }
                     len += size;
                 }
+                if (!m_running)
+                    break;
             }
         }
         catch (const Poco::Exception& ex)
         {
             // Handle the exception here, which indicates the client disconnect
             // event
-            LOG_INFO(_("Server connection lost."));
-            std::lock_guard lk(m_sendMutex);
-            m_send.clear();
-            m_running = false;
-            close();
-            Fl::add_timeout(0.005, (Fl_Timeout_Handler)clear_tcp_cb, nullptr);
+            _connectionLost();
         }
         catch (const std::exception& e)
         {
@@ -152,11 +156,60 @@ namespace mrv
 
     void Client::receiveMessages()
     {
-        if (m_socket.available() > 0)
+        try
+        {
+            // Wait for data, waking up from time to time to check whether
+            // the client was stopped.
+            if (!m_socket.poll(kPollTimeout, Poco::Net::Socket::SELECT_READ))
+                return;
+
+            // A readable socket with no data means the server closed it.
+            if (m_socket.available() <= 0)
+            {
+                _connectionLost();
+                return;
+            }
+        }
+        catch (const Poco::Exception& ex)
+        {
+            _connectionLost();
+            return;
+        }
+
+        Message message = receiveMessage();
+        if (message["command"] == "Sync State")
+        {
+            try
+            {
+                const auto& messages = uncompressMessages(message);
+                std::lock_guard lk(m_receiveMutex);
+                m_receive.insert(
+                    m_receive.end(), messages.begin(), messages.end());
+            }
+            catch (const std::exception& e)
+            {
+                LOG_ERROR(_("Exception caught: ") << e.what());
+            }
+            return;
+        }
+
+        std::lock_guard lk(m_receiveMutex);
+        m_receive.push_back(message);
+    }
+
+    void Client::_connectionLost()
+    {
+        // Both threads may notice it.
+        if (m_lost.exchange(true))
+            return;
+
+        LOG_INFO(_("Server connection lost."));
         {
-            std::lock_guard lk(m_receiveMutex);
-            Message message = receiveMessage();
-            m_receive.push_back(message);
+            std::lock_guard lk(m_sendMutex);
+            m_send.clear();
         }
+        setStopped();
+        close();
+        Fl::add_timeout(0.005, (Fl_Timeout_Handler)clear_tcp_cb, nullptr);
     }
 } // namespace mrv
@@ -20,6 +20,10 @@ namespace mrv
         std::string host() const { return m_host; }
 
     private:
+        //! Stop the client and replace it with a dummy one.
+        void _connectionLost();
+
         std::string m_host;
+        std::atomic<bool> m_lost = false;
     };
 } // namespace mrv
@@ -54,11 +54,13 @@ namespace mrv
             {
                 App::app->open(d->fileName);
             }
-            
-            refresh_file_cache_cb(nullptr, nullptr);
+            else if (!App::app->isWatched(d->fileName))
+            {
+                // Only re-read the file that was overwritten.  When the
+                // file watcher sees it, it re-reads it already.
+                App::app->invalidateFile(d->fileName, true);
+            }
             delete d;
-
-            panel::refreshThumbnails();
         }
     } // namespace
     
@@ -2,6 +2,8 @@
 // mrv2
 // Copyright Contributors to the mrv2 Project. All rights reserved.
 
+#include <vector>
+
 #include <tlCore/StringFormat.h>
 
 #include <FL/Fl_Multiline_Input.H>
@@ -83,6 +85,7 @@ namespace mrv
     CommandInterpreter::CommandInterpreter(ViewerUI* gui) :
         ui(gui)
     {
+        _registerHandlers();
         Fl::add_timeout(kTimeout, (Fl_Timeout_Handler)timerEvent_cb, this);
     }
 
@@ -91,1354 +94,1228 @@ namespace mrv
         Fl::remove_timeout((Fl_Timeout_Handler)timerEvent_cb, this);
     }
 
-    void CommandInterpreter::parse(const Message& message)
+    void CommandInterpreter::_registerHandlers()
     {
-        const std::string& c = message["command"];
-        auto app = ui->app;
-        auto prefs = ui->uiPrefs;
-        auto view = ui->uiView;
-        TimelinePlayer* player = nullptr;
-        if (view)
-            player = view->getTimelinePlayer();
+        using namespace panel;
 
-#ifndef NDEBUG
-        std::cerr << "Command: " << message << std::endl;
-#endif
+        handlers["setPlayback"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveTimeline->value();
+            if (!receive || !player)
+                return;
 
-        try
+            timeline::Playback value = message["value"];
+
+            switch (value)
+            {
+            case timeline::Playback::Forward:
+                play_forwards_cb(nullptr, ui);
+                break;
+            case timeline::Playback::Reverse:
+                play_backwards_cb(nullptr, ui);
+                break;
+            default:
+            case timeline::Playback::Stop:
+                stop_cb(nullptr, ui);
+                break;
+            }
+        };
+
+        handlers["setLoop"] = [this](const Message& message)
         {
-            using namespace panel;
+            bool receive = prefs->ReceiveTimeline->value();
+            if (!receive || !player)
+                return;
+            timeline::Loop value = message["value"];
+            player->setLoop(value);
+        };
 
-            tcp->lock();
+        handlers["Open File"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveMedia->value();
+            if (!receive)
+                return;
+            std::string fileName = message["fileName"];
+            std::string audioFileName = message["audioFileName"];
+            replace_path(fileName);
+            if (!audioFileName.empty())
+                replace_path(audioFileName);
+            app->open(fileName, audioFileName);
+        };
 
-            if (c == "setPlayback")
-            {
-                bool receive = prefs->ReceiveTimeline->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
+        handlers["closeAll"] = [this](const Message& message)
+        {
+            if (prefs->ReceiveMedia->value())
+                close_all_cb(nullptr, ui);
+        };
 
-                timeline::Playback value = message["value"];
+        handlers["closeCurrent"] = [this](const Message& message)
+        {
+            if (prefs->ReceiveMedia->value())
+                close_current_cb(nullptr, ui);
+        };
 
-                switch (value)
-                {
-                case timeline::Playback::Forward:
-                    play_forwards_cb(nullptr, ui);
-                    break;
-                case timeline::Playback::Reverse:
-                    play_backwards_cb(nullptr, ui);
-                    break;
-                default:
-                case timeline::Playback::Stop:
-                    stop_cb(nullptr, ui);
-                    break;
-                }
-            }
-            else if (c == "setLoop")
+        handlers["Media Items"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveMedia->value();
+            if (!receive)
+                return;
+            syncMedia(message);
+        };
+
+        handlers["seek"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveTimeline->value();
+            if (!receive || !player)
+                return;
+            otime::RationalTime value = message["value"];
+            player->seek(value);
+        };
+
+        handlers["Timeline Key Press"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveTimeline->value();
+            if (!receive || !player)
+                return;
+            const int key = message["value"];
+            const int modifiers = message["modifiers"];
+            ui->uiTimeline->keyPressEvent(key, modifiers);
+        };
+
+        handlers["Timeline Key Release"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveTimeline->value();
+            if (!receive || !player)
+                return;
+            const int key = message["value"];
+            const int modifiers = message["modifiers"];
+            ui->uiTimeline->keyReleaseEvent(key, modifiers);
+        };
+
+        handlers["Timeline Mouse Press"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveTimeline->value();
+            if (!receive || !player)
+                return;
+            const int button = message["button"];
+            const bool on = message["on"];
+            const int modifiers = message["modifiers"];
+            ui->uiTimeline->mousePressEvent(button, on, modifiers);
+        };
+
+        handlers["Timeline Mouse Move"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveTimeline->value();
+            if (!receive || !player)
+                return;
+            float X = message["X"];
+            X *= ui->uiTimeline->pixel_w();
+            float Y = message["Y"];
+            Y *= ui->uiTimeline->pixel_h();
+            ui->uiTimeline->mouseMoveEvent(X, Y);
+        };
+
+        handlers["Timeline Mouse Release"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveTimeline->value();
+            if (!receive || !player)
+                return;
+            float X = message["X"];
+            X *= ui->uiTimeline->pixel_w();
+            float Y = message["Y"];
+            Y *= ui->uiTimeline->pixel_h();
+            int button = message["button"];
+            bool on = message["on"];
+            int modifiers = message["modifiers"];
+            ui->uiTimeline->mouseReleaseEvent(X, Y, button, on, modifiers);
+        };
+
+        handlers["Timeline Widget Scroll"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveTimeline->value();
+            if (!receive || !player)
+                return;
+            float X = message["X"];
+            float Y = message["Y"];
+            int modifiers = message["modifiers"];
+            ui->uiTimeline->scrollEvent(X, Y, modifiers);
+        };
+
+        handlers["Timeline Fit"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveTimeline->value();
+            if (!receive || !player)
+                return;
+            ui->uiTimeline->frameView();
+        };
+
+        handlers["setInOutRange"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveTimeline->value();
+            if (!receive || !player)
+                return;
+            otime::TimeRange value = message["value"];
+            player->setInOutRange(value);
+        };
+
+        handlers["setSpeed"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveTimeline->value();
+            if (!receive || !player)
+                return;
+            double value = message["value"];
+            player->setSpeed(value);
+        };
+
+        handlers["setInPoint"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveTimeline->value();
+            if (!receive || !player)
+                return;
+            player->setInPoint();
+        };
+
+        handlers["resetInPoint"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveTimeline->value();
+            if (!receive || !player)
+                return;
+
+            player->resetInPoint();
+        };
+
+        handlers["setOutPoint"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveTimeline->value();
+            if (!receive || !player)
+                return;
+
+            player->setOutPoint();
+        };
+
+        handlers["resetOutPoint"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveTimeline->value();
+            if (!receive || !player)
+                return;
+
+            player->resetOutPoint();
+        };
+
+        handlers["setVideoLayer"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveColor->value();
+            if (!receive || !player)
+                return;
+            int value = message["value"];
             {
-                bool receive = prefs->ReceiveTimeline->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                timeline::Loop value = message["value"];
-                player->setLoop(value);
+                ui->uiColorChannel->value(value);
+                ui->uiColorChannel->do_callback();
             }
-            else if (c == "Open File")
+        };
+
+        handlers["Redraw Panel Thumbnails"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveTimeline->value();
+            if (!receive)
+                return;
+            panel::redrawThumbnails();
+        };
+
+        handlers["setVolume"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveAudio->value();
+            if (!receive || !player)
+                return;
+            float value = message["value"];
+
+            player->setVolume(value);
+            TimelineClass* c = ui->uiTimeWindow;
+            c->uiVolume->value(value);
+            c->uiVolume->redraw();
+        };
+
+        handlers["setMute"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveAudio->value();
+            if (!receive || !player)
+                return;
+            bool value = message["value"];
+
+            player->setMute(value);
+            TimelineClass* c = ui->uiTimeWindow;
+            c->uiAudioTracks->value(value);
+            c->uiAudioTracks->do_callback();
+        };
+
+        handlers["setAudioOffset"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveAudio->value();
+            if (!receive || !player)
+                return;
+            double value = message["value"];
+
+            player->setAudioOffset(value);
+        };
+
+        handlers["start"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveTimeline->value();
+            if (!receive || !player)
+                return;
+
+            player->start();
+        };
+
+        handlers["end"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveTimeline->value();
+            if (!receive || !player)
+                return;
+
+            player->end();
+        };
+
+        handlers["framePrev"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveTimeline->value();
+            if (!receive || !player)
+                return;
+
+            player->framePrev();
+        };
+
+        handlers["frameNext"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveTimeline->value();
+            if (!receive || !player)
+                return;
+
+            player->frameNext();
+        };
+
+        handlers["undo"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveAnnotations->value();
+            if (!receive || !view)
+                return;
+            ui->uiRedoDraw->activate();
+            view->undo();
+        };
+
+        handlers["redo"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveAnnotations->value();
+            if (!receive || !view)
+                return;
+            ui->uiUndoDraw->activate();
+            view->redo();
+        };
+
+        handlers["setEnvironmentMapOptions"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceivePanAndZoom->value();
+            if (!receive || !view)
+                return;
+            const EnvironmentMapOptions& o = message["value"];
+            view->setEnvironmentMapOptions(o);
+        };
+
+        handlers["setOCIOOptions"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveColor->value();
+            if (!receive || !view)
+                return;
+            const tl::timeline::OCIOOptions& local = view->getOCIOOptions();
+            tl::timeline::OCIOOptions o = message["value"];
+
+            // If we cannot read the config file, keep the local one
+            replace_path(o.fileName);
+            if (o.fileName.empty() || !file::isReadable(o.fileName))
             {
-                bool receive = prefs->ReceiveMedia->value();
-                if (!receive)
+                o.fileName = local.fileName;
+                if (o.fileName.empty() || !file::isReadable(o.fileName))
                 {
-                    tcp->unlock();
-                    return;
+                    o.fileName = prefs->uiPrefsOCIOConfig->value();
                 }
-                std::string fileName = message["fileName"];
-                std::string audioFileName = message["audioFileName"];
-                replace_path(fileName);
-                if (!audioFileName.empty())
-                    replace_path(audioFileName);
-                app->open(fileName, audioFileName);
             }
-            else if (c == "closeAll")
+
+            int index = mrv::ocio::ocioIcsIndex(o.input);
+            ui->uiICS->value(index);
+
+            std::string mergedView =
+                mrv::ocio::ocioDisplayViewShortened(o.display, o.view);
+            index = mrv::ocio::ocioViewIndex(mergedView);
+            ui->OCIOView->value(index);
+
+            index = mrv::ocio::ocioLookIndex(o.look);
+            ui->OCIOLook->value(index);
+
+            view->setOCIOOptions(o);
+        };
+
+        handlers["Display Options"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveColor->value();
+            if (!receive)
+                return;
+            const tl::timeline::DisplayOptions& o = message["value"];
+            app->setDisplayOptions(o);
+            ui->uiMain->fill_menu(ui->uiMenuBar);
+        };
+
+        handlers["setBackgroundOptions"] = [this](const Message& message)
+        {
+            const tl::timeline::BackgroundOptions& o = message["value"];
+            view->setBackgroundOptions(o);
+            ui->uiMain->fill_menu(ui->uiMenuBar);
+        };
+
+        handlers["setCompareOptions"] = [this](const Message& message)
+        {
+            const tl::timeline::CompareOptions& o = message["value"];
+            app->filesModel()->setCompareOptions(o);
+        };
+
+        handlers["setStereo3DOptions"] = [this](const Message& message)
+        {
+            const Stereo3DOptions& o = message["value"];
+            app->filesModel()->setStereo3DOptions(o);
+        };
+
+        handlers["Set A Index"] = [this](const Message& message)
+        {
+            int value = message["value"];
+            app->filesModel()->setA(value);
+        };
+
+        handlers["Set B Indexes"] = [this](const Message& message)
+        {
+            std::vector<int> values = message["value"];
+            app->filesModel()->clearB();
+            for (auto value : values)
             {
-                if (prefs->ReceiveMedia->value())
-                    close_all_cb(nullptr, ui);
+                app->filesModel()->setB(value, true);
             }
-            else if (c == "closeCurrent")
+        };
+
+        handlers["Set Stereo Index"] = [this](const Message& message)
+        {
+            int value = message["value"];
+            app->filesModel()->setStereo(value);
+        };
+
+        handlers["Image Options"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveColor->value();
+            if (!receive)
+                return;
+            const tl::timeline::ImageOptions& o = message["value"];
+            app->setImageOptions(o);
+        };
+
+        handlers["LUT Options"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveColor->value();
+            if (!receive)
+                return;
+            const tl::timeline::LUTOptions& o = message["value"];
+            app->setLUTOptions(o);
+        };
+
+        handlers["gain"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveColor->value();
+            if (!receive)
+                return;
+            float value = message["value"];
+            ui->uiGain->value(value);
+            ui->uiGain->do_callback();
+        };
+
+        handlers["gamma"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveColor->value();
+            if (!receive)
+                return;
+            float value = message["value"];
+            ui->uiGamma->value(value);
+            ui->uiGamma->do_callback();
+        };
+
+        handlers["Clear Note Annotation"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveAnnotations->value();
+            if (!receive || !player)
+                return;
+            clear_note_annotation_cb(ui);
+            if (annotationsPanel)
             {
-                if (prefs->ReceiveMedia->value())
-                    close_current_cb(nullptr, ui);
+                annotationsPanel->notes->value("");
             }
-            else if (c == "Media Items")
+        };
+
+        handlers["Create Note Annotation"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveAnnotations->value();
+            if (!receive || !player)
+                return;
+            const std::string& text = message["value"];
+            add_note_annotation_cb(ui, text);
+            if (annotationsPanel)
             {
-                bool receive = prefs->ReceiveMedia->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                syncMedia(message);
+                annotationsPanel->notes->value(text.c_str());
             }
-            else if (c == "seek")
+        };
+
+        handlers["Create Shape"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveAnnotations->value();
+            if (!receive || !player)
+                return;
+            auto annotation = player->getAnnotation();
+            if (!annotation)
+                return;
+            auto shape = draw::messageToShape(message["value"]);
+            annotation->shapes.push_back(shape);
+
+            // Create annotation menus if not there already
+            ui->uiMain->fill_menu(ui->uiMenuBar);
+            view->updateUndoRedoButtons();
+            redraw = true;
+        };
+
+        handlers["Remove Shape"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveAnnotations->value();
+            if (!receive || !player)
+                return;
+            auto annotation = player->getAnnotation();
+            if (!annotation)
+                return;
+
+            int index = message["value"];
+            if (index >= 0 && index < annotation->shapes.size())
             {
-                bool receive = prefs->ReceiveTimeline->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                otime::RationalTime value = message["value"];
-                player->seek(value);
+                auto shape = annotation->shapes[index];
+                annotation->remove(shape);
+                redraw = true;
+                ui->uiTimeline->redraw();
             }
-            else if (c == "Timeline Key Press")
-            {
-                bool receive = prefs->ReceiveTimeline->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                const int key = message["value"];
-                const int modifiers = message["modifiers"];
-                ui->uiTimeline->keyPressEvent(key, modifiers);
+        };
+
+        handlers["Laser Fade"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveAnnotations->value();
+            if (!receive || !player)
+                return;
+            auto annotation = player->getAnnotation();
+            if (!annotation)
+                return;
+            auto shape = annotation->lastShape();
+            if (!shape)
+                return;
+
+            // Start laser fading
+            LaserFadeData* laserData = new LaserFadeData;
+            laserData->view = view;
+            laserData->annotation = annotation;
+            laserData->shape = shape;
+
+            Fl::add_timeout(
+                0.0, (Fl_Timeout_Handler)TimelineViewport::laserFade_cb,
+                laserData);
+
+            // Create annotation menus if not there already
+            ui->uiMain->fill_menu(ui->uiMenuBar);
+            redraw = true;
+        };
+
+        handlers["Add Shape Point"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveAnnotations->value();
+            if (!receive || !player)
+                return;
+            auto annotation = player->getAnnotation();
+            if (!annotation)
+                return;
+            auto lastShape = annotation->lastShape();
+            if (!lastShape)
+                return;
+            auto shape = dynamic_cast< draw::PathShape* >(lastShape.get());
+            if (!shape)
+                return;
+            const draw::Point& value = message["value"];
+            shape->pts.push_back(value);
+            ++shape->version;
+            redraw = true;
+        };
+
+        handlers["Add Shape Points"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveAnnotations->value();
+            if (!receive || !player)
+                return;
+            auto annotation = player->getAnnotation();
+            if (!annotation)
+                return;
+            auto lastShape = annotation->lastShape();
+            auto shape = dynamic_cast< draw::PathShape* >(lastShape.get());
+            if (!shape)
+                return;
+            const auto& values = message["value"];
+            if (values.is_binary())
+            {
+                draw::PointList pts;
+                draw::unpackPoints(values.get_binary(), pts);
+                shape->pts.insert(shape->pts.end(), pts.begin(), pts.end());
             }
-            else if (c == "Timeline Key Release")
+            else
             {
-                bool receive = prefs->ReceiveTimeline->value();
-                if (!receive || !player)
+                for (const auto& j : values)
                 {
-                    tcp->unlock();
-                    return;
+                    const draw::Point& value = j;
+                    shape->pts.push_back(value);
                 }
-                const int key = message["value"];
-                const int modifiers = message["modifiers"];
-                ui->uiTimeline->keyReleaseEvent(key, modifiers);
             }
-            else if (c == "Timeline Mouse Press")
+            ++shape->version;
+            redraw = true;
+        };
+
+        handlers["Update Shape"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveAnnotations->value();
+            if (!receive || !player)
+                return;
+            auto annotation = player->getAnnotation();
+            if (!annotation)
+                return;
+            auto shape = draw::messageToShape(message["value"]);
+            annotation->shapes.pop_back();
+            annotation->shapes.push_back(shape);
+            view->updateUndoRedoButtons();
+            redraw = true;
+        };
+
+        handlers["End Shape"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveAnnotations->value();
+            if (!receive || !player)
+                return;
+            auto annotation = player->getAnnotation();
+            if (!annotation)
+                return;
+            auto shape = draw::messageToShape(message["value"]);
+            annotation->shapes.push_back(shape);
+            // Create annotation menus if not there already
+            ui->uiMain->fill_menu(ui->uiMenuBar);
+            view->updateUndoRedoButtons();
+            redraw = true;
+        };
+
+        handlers["updateVideoCache"] = [this](const Message& message)
+        {
+            if (!player)
+                return;
+            const otime::RationalTime& time = message["value"];
+            player->updateVideoCache(time);
+        };
+
+        handlers["clearCache"] = [this](const Message& message)
+        {
+            if (!player)
+                return;
+            player->clearCache();
+        };
+
+        handlers["Create Annotation"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveAnnotations->value();
+            if (!receive || !player)
+                return;
+            bool allFrames = message["value"];
+            player->createAnnotation(allFrames);
+        };
+
+        handlers["Annotations"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveAnnotations->value();
+            if (!receive || !player)
+                return;
+
+            const std::vector<draw::Annotation>& tmp = message["value"];
+            std::vector< std::shared_ptr<draw::Annotation> > annotations;
+            for (const auto& ann : tmp)
             {
-                bool receive = prefs->ReceiveTimeline->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                const int button = message["button"];
-                const bool on = message["on"];
-                const int modifiers = message["modifiers"];
-                ui->uiTimeline->mousePressEvent(button, on, modifiers);
+                std::shared_ptr< draw::Annotation > annotation =
+                    messageToAnnotation(ann);
+                annotations.push_back(annotation);
             }
-            else if (c == "Timeline Mouse Move")
+
+            player->setAllAnnotations(annotations);
+            ui->uiTimeline->redraw();
+            ui->uiMain->fill_menu(ui->uiMenuBar);
+        };
+
+        handlers["viewPosAndZoom"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceivePanAndZoom->value();
+            if (!receive || !view)
+                return;
+
+            float remoteZoom = message["zoom"];
+
+            // When all files are closed, we get an infinite zoom (null),
+            if (isinf(remoteZoom))
+                return;
+
+            const math::Vector2i& remoteViewPos = message["viewPos"];
+            const auto& remoteViewport = message["viewport"];
+            const auto viewport = view->getViewportSize();
+            const auto renderSize = view->getRenderSize();
+
+            // Output values
+            math::Vector2i localViewPos; // Local view position (panning)
+            float localZoom;             // Local zoom factor
+
+            // Call the function to match the remote image position
+            matchRemoteImagePosition(
+                remoteViewPos, remoteZoom, remoteViewport, renderSize,
+                viewport, localViewPos, localZoom);
+
+            view->setViewPosAndZoom(localViewPos, localZoom);
+        };
+
+        handlers["Show Annotations"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveAnnotations->value();
+            if (!receive)
+                return;
+            bool value = message["value"];
+            view->setShowAnnotations(value);
+        };
+
+        handlers["Menu Bar"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+            bool value = message["value"];
+            if (value)
             {
-                bool receive = prefs->ReceiveTimeline->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                float X = message["X"];
-                X *= ui->uiTimeline->pixel_w();
-                float Y = message["Y"];
-                Y *= ui->uiTimeline->pixel_h();
-                ui->uiTimeline->mouseMoveEvent(X, Y);
+                ui->uiMenuBar->show();
             }
-            else if (c == "Timeline Mouse Release")
+            else
             {
-                bool receive = prefs->ReceiveTimeline->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                float X = message["X"];
-                X *= ui->uiTimeline->pixel_w();
-                float Y = message["Y"];
-                Y *= ui->uiTimeline->pixel_h();
-                int button = message["button"];
-                bool on = message["on"];
-                int modifiers = message["modifiers"];
-                ui->uiTimeline->mouseReleaseEvent(X, Y, button, on, modifiers);
+                ui->uiMenuBar->hide();
             }
-            else if (c == "Timeline Widget Scroll")
+            ui->uiRegion->layout();
+            ui->uiMain->fill_menu(ui->uiMenuBar);
+        };
+
+        handlers["Top Bar"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+            bool value = message["value"];
+            if (value)
             {
-                bool receive = prefs->ReceiveTimeline->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                float X = message["X"];
-                float Y = message["Y"];
-                int modifiers = message["modifiers"];
-                ui->uiTimeline->scrollEvent(X, Y, modifiers);
+                ui->uiTopBar->show();
             }
-            else if (c == "Timeline Fit")
+            else
             {
-                bool receive = prefs->ReceiveTimeline->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                ui->uiTimeline->frameView();
+                ui->uiTopBar->hide();
             }
-            else if (c == "setInOutRange")
+            ui->uiRegion->layout();
+            ui->uiMain->fill_menu(ui->uiMenuBar);
+        };
+
+        handlers["Pixel Bar"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+            bool value = message["value"];
+            if (value)
             {
-                bool receive = prefs->ReceiveTimeline->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                otime::TimeRange value = message["value"];
-                player->setInOutRange(value);
+                ui->uiPixelBar->show();
             }
-            else if (c == "setSpeed")
+            else
             {
-                bool receive = prefs->ReceiveTimeline->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                double value = message["value"];
-                player->setSpeed(value);
+                ui->uiPixelBar->hide();
             }
-            else if (c == "setInPoint")
+            ui->uiRegion->layout();
+            ui->uiMain->fill_menu(ui->uiMenuBar);
+        };
+
+        handlers["Bottom Bar"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+            bool value = message["value"];
+            if (value)
             {
-                bool receive = prefs->ReceiveTimeline->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                player->setInPoint();
+                ui->uiBottomBar->show();
             }
-            else if (c == "resetInPoint")
+            else
             {
-                bool receive = prefs->ReceiveTimeline->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
-
-                player->resetInPoint();
+                ui->uiBottomBar->hide();
             }
-            else if (c == "setOutPoint")
-            {
-                bool receive = prefs->ReceiveTimeline->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
+            ui->uiRegion->layout();
+            ui->uiMain->fill_menu(ui->uiMenuBar);
+        };
 
-                player->setOutPoint();
-            }
-            else if (c == "resetInPoint")
+        handlers["Status Bar"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+            bool value = message["value"];
+            if (value)
             {
-                bool receive = prefs->ReceiveTimeline->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
-
-                player->resetOutPoint();
+                ui->uiStatusBar->show();
             }
-            else if (c == "setVideoLayer")
+            else
             {
-                bool receive = prefs->ReceiveColor->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                int value = message["value"];
-                {
-                    ui->uiColorChannel->value(value);
-                    ui->uiColorChannel->do_callback();
-                }
+                ui->uiStatusBar->hide();
             }
-            else if (c == "Redraw Panel Thumbnails")
+            ui->uiRegion->layout();
+        };
+
+        handlers["Action Bar"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+            bool value = message["value"];
+            if (value)
             {
-                bool receive = prefs->ReceiveTimeline->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                panel::redrawThumbnails();
+                ui->uiToolsGroup->show();
             }
-            else if (c == "setVolume")
+            else
             {
-                bool receive = prefs->ReceiveAudio->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                float value = message["value"];
-
-                player->setVolume(value);
-                TimelineClass* c = ui->uiTimeWindow;
-                c->uiVolume->value(value);
-                c->uiVolume->redraw();
+                ui->uiToolsGroup->hide();
             }
-            else if (c == "setMute")
-            {
-                bool receive = prefs->ReceiveAudio->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                bool value = message["value"];
+            ui->uiViewGroup->layout();
+            ui->uiMain->fill_menu(ui->uiMenuBar);
+        };
 
-                player->setMute(value);
-                TimelineClass* c = ui->uiTimeWindow;
-                c->uiAudioTracks->value(value);
-                c->uiAudioTracks->do_callback();
-            }
-            else if (c == "setAudioOffset")
-            {
-                bool receive = prefs->ReceiveAudio->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                double value = message["value"];
+        handlers["Fullscreen"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive || !view)
+                return;
+            bool value = message["value"];
+            view->setFullScreenMode(value);
+        };
 
-                player->setAudioOffset(value);
-            }
-            else if (c == "start")
-            {
-                bool receive = prefs->ReceiveTimeline->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
+        handlers["Presentation"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive || !view)
+                return;
+            bool value = message["value"];
+            view->setPresentationMode(value);
+        };
 
-                player->start();
-            }
-            else if (c == "end")
-            {
-                bool receive = prefs->ReceiveTimeline->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
+        handlers["Selection Area"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveColor->value();
+            if (!receive || !view)
+                return;
+            const math::Box2i& area = message["value"];
+            view->setSelectionArea(area);
+        };
 
-                player->end();
-            }
-            else if (c == "framePrev")
-            {
-                bool receive = prefs->ReceiveTimeline->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
+        handlers["One Panel Only"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+            bool value = message["value"];
+            if ((!value && panel::onlyOne()) ||
+                (value && !panel::onlyOne()))
+                toggle_one_panel_only_cb(nullptr, ui);
+        };
 
-                player->framePrev();
-            }
-            else if (c == "frameNext")
-            {
-                bool receive = prefs->ReceiveTimeline->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
+        handlers["Color Panel"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+            bool value = message["value"];
+            if ((!value && colorPanel) || (value && !colorPanel))
+                color_panel_cb(nullptr, ui);
+        };
 
-                player->frameNext();
-            }
-            else if (c == "undo")
-            {
-                bool receive = prefs->ReceiveAnnotations->value();
-                if (!receive || !view)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                ui->uiRedoDraw->activate();
-                view->undo();
-            }
-            else if (c == "redo")
-            {
-                bool receive = prefs->ReceiveAnnotations->value();
-                if (!receive || !view)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                ui->uiUndoDraw->activate();
-                view->redo();
-            }
-            else if (c == "setEnvironmentMapOptions")
-            {
-                bool receive = prefs->ReceivePanAndZoom->value();
-                if (!receive || !view)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                const EnvironmentMapOptions& o = message["value"];
-                view->setEnvironmentMapOptions(o);
-            }
-            else if (c == "setOCIOOptions")
-            {
-                bool receive = prefs->ReceiveColor->value();
-                if (!receive || !view)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                const tl::timeline::OCIOOptions& local = view->getOCIOOptions();
-                tl::timeline::OCIOOptions o = message["value"];
+        handlers["Annotations Panel"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+            bool value = message["value"];
+            if ((!value && annotationsPanel) ||
+                (value && !annotationsPanel))
+                annotations_panel_cb(nullptr, ui);
+        };
 
-                // If we cannot read the config file, keep the local one
-                replace_path(o.fileName);
-                if (o.fileName.empty() || !file::isReadable(o.fileName))
-                {
-                    o.fileName = local.fileName;
-                    if (o.fileName.empty() || !file::isReadable(o.fileName))
-                    {
-                        o.fileName = prefs->uiPrefsOCIOConfig->value();
-                    }
-                }
+        handlers["Background Panel"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+            bool value = message["value"];
+            if ((!value && backgroundPanel) || (value && !backgroundPanel))
+                background_panel_cb(nullptr, ui);
+        };
 
-                int index = mrv::ocio::ocioIcsIndex(o.input);
-                ui->uiICS->value(index);
+        handlers["Color Area Panel"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+            bool value = message["value"];
+            if ((!value && colorAreaPanel) || (value && !colorAreaPanel))
+                color_area_panel_cb(nullptr, ui);
+        };
 
-                std::string mergedView =
-                    mrv::ocio::ocioDisplayViewShortened(o.display, o.view);
-                index = mrv::ocio::ocioViewIndex(mergedView);
-                ui->OCIOView->value(index);
+        handlers["Compare Panel"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+            bool value = message["value"];
+            if ((!value && comparePanel) || (value && !comparePanel))
+                compare_panel_cb(nullptr, ui);
+        };
 
-                index = mrv::ocio::ocioLookIndex(o.look);
-                ui->OCIOLook->value(index);
+        handlers["Devices Panel"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+            bool value = message["value"];
+            if ((!value && devicesPanel) || (value && !devicesPanel))
+                devices_panel_cb(nullptr, ui);
+        };
 
-                view->setOCIOOptions(o);
-            }
-            else if (c == "Display Options")
-            {
-                bool receive = prefs->ReceiveColor->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                const tl::timeline::DisplayOptions& o = message["value"];
-                app->setDisplayOptions(o);
-                ui->uiMain->fill_menu(ui->uiMenuBar);
-            }
-            else if (c == "setBackgroundOptions")
-            {
-                const tl::timeline::BackgroundOptions& o = message["value"];
-                view->setBackgroundOptions(o);
-                ui->uiMain->fill_menu(ui->uiMenuBar);
-            }
-            else if (c == "setCompareOptions")
-            {
-                const tl::timeline::CompareOptions& o = message["value"];
-                app->filesModel()->setCompareOptions(o);
-            }
-            else if (c == "setStereo3DOptions")
-            {
-                const Stereo3DOptions& o = message["value"];
-                app->filesModel()->setStereo3DOptions(o);
-            }
-            else if (c == "Set A Index")
-            {
-                int value = message["value"];
-                app->filesModel()->setA(value);
-            }
-            else if (c == "Set B Indexes")
-            {
-                std::vector<int> values = message["value"];
-                app->filesModel()->clearB();
-                for (auto value : values)
-                {
-                    app->filesModel()->setB(value, true);
-                }
-            }
-            else if (c == "Set Stereo Index")
-            {
-                int value = message["value"];
-                app->filesModel()->setStereo(value);
-            }
-            else if (c == "Image Options")
-            {
-                bool receive = prefs->ReceiveColor->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                const tl::timeline::ImageOptions& o = message["value"];
-                app->setImageOptions(o);
-            }
-            else if (c == "LUT Options")
-            {
-                bool receive = prefs->ReceiveColor->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                const tl::timeline::LUTOptions& o = message["value"];
-                app->setLUTOptions(o);
-            }
-            else if (c == "gain")
-            {
-                bool receive = prefs->ReceiveColor->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                float value = message["value"];
-                ui->uiGain->value(value);
-                ui->uiGain->do_callback();
-            }
-            else if (c == "gamma")
-            {
-                bool receive = prefs->ReceiveColor->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                float value = message["value"];
-                ui->uiGamma->value(value);
-                ui->uiGamma->do_callback();
-            }
-            else if (c == "Clear Note Annotation")
-            {
-                bool receive = prefs->ReceiveAnnotations->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                clear_note_annotation_cb(ui);
-                if (annotationsPanel)
-                {
-                    annotationsPanel->notes->value("");
-                }
-            }
-            else if (c == "Create Note Annotation")
-            {
-                bool receive = prefs->ReceiveAnnotations->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                const std::string& text = message["value"];
-                add_note_annotation_cb(ui, text);
-                if (annotationsPanel)
-                {
-                    annotationsPanel->notes->value(text.c_str());
-                }
-            }
-            else if (c == "Create Shape")
-            {
-                bool receive = prefs->ReceiveAnnotations->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                auto annotation = player->getAnnotation();
-                if (!annotation)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                auto shape = draw::messageToShape(message["value"]);
-                annotation->shapes.push_back(shape);
+        handlers["Environment Map Panel"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+            bool value = message["value"];
+            if ((!value && environmentMapPanel) ||
+                (value && !environmentMapPanel))
+                environment_map_panel_cb(nullptr, ui);
+        };
 
-                // Create annotation menus if not there already
-                ui->uiMain->fill_menu(ui->uiMenuBar);
-                view->updateUndoRedoButtons();
-                view->redrawWindows();
-            }
-            else if (c == "Remove Shape")
-            {
-                bool receive = prefs->ReceiveAnnotations->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                auto annotation = player->getAnnotation();
-                if (!annotation)
-                {
-                    tcp->unlock();
-                    return;
-                }
+        handlers["Files Panel"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+            bool value = message["value"];
+            if ((!value && filesPanel) || (value && !filesPanel))
+                files_panel_cb(nullptr, ui);
+        };
 
-                int index = message["value"];
-                if (index >= 0 && index < annotation->shapes.size())
-                {
-                    auto shape = annotation->shapes[index];
-                    annotation->remove(shape);
-                    view->redrawWindows();
-                    ui->uiTimeline->redraw();
-                }
-            }
-            else if (c == "Laser Fade")
-            {
-                bool receive = prefs->ReceiveAnnotations->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                auto annotation = player->getAnnotation();
-                if (!annotation)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                auto shape = annotation->lastShape();
-                if (!shape)
-                {
-                    tcp->unlock();
-                    return;
-                }
+        handlers["Histogram Panel"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+            bool value = message["value"];
+            if ((!value && histogramPanel) || (value && !histogramPanel))
+                histogram_panel_cb(nullptr, ui);
+        };
 
-                // Start laser fading
-                LaserFadeData* laserData = new LaserFadeData;
-                laserData->view = view;
-                laserData->annotation = annotation;
-                laserData->shape = shape;
+        handlers["Media Info Panel"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+            bool value = message["value"];
+            if ((!value && imageInfoPanel) || (value && !imageInfoPanel))
+                image_info_panel_cb(nullptr, ui);
+        };
 
-                Fl::add_timeout(
-                    0.0, (Fl_Timeout_Handler)TimelineViewport::laserFade_cb,
-                    laserData);
+        handlers["setEditMode"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+            EditMode value = message["value"];
+            editMode = value;
+            editModeH = message["height"];
+            bool presentation = ui->uiView->getPresentationMode();
+            if (!presentation)
+                ui->uiView->resizeWindow();
 
-                // Create annotation menus if not there already
-                ui->uiMain->fill_menu(ui->uiMenuBar);
-                view->redrawWindows();
-            }
-            else if (c == "Add Shape Point")
-            {
-                bool receive = prefs->ReceiveAnnotations->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                auto annotation = player->getAnnotation();
-                if (!annotation)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                auto lastShape = annotation->lastShape();
-                if (!lastShape)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                auto shape = dynamic_cast< draw::PathShape* >(lastShape.get());
-                if (!shape)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                const draw::Point& value = message["value"];
-                shape->pts.push_back(value);
-                view->redrawWindows();
-            }
-            else if (c == "Update Shape")
-            {
-                bool receive = prefs->ReceiveAnnotations->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                auto annotation = player->getAnnotation();
-                if (!annotation)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                auto shape = draw::messageToShape(message["value"]);
-                annotation->shapes.pop_back();
-                annotation->shapes.push_back(shape);
-                view->updateUndoRedoButtons();
-                view->redrawWindows();
-            }
-            else if (c == "End Shape")
-            {
-                bool receive = prefs->ReceiveAnnotations->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                auto annotation = player->getAnnotation();
-                if (!annotation)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                auto shape = draw::messageToShape(message["value"]);
-                annotation->shapes.push_back(shape);
-                // Create annotation menus if not there already
-                ui->uiMain->fill_menu(ui->uiMenuBar);
-                view->updateUndoRedoButtons();
-                view->redrawWindows();
-            }
-            else if (c == "updateVideoCache")
-            {
-                if (!player)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                const otime::RationalTime& time = message["value"];
-                player->updateVideoCache(time);
-            }
-            else if (c == "clearCache")
-            {
-                if (!player)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                player->clearCache();
-            }
-            else if (c == "Create Annotation")
-            {
-                bool receive = prefs->ReceiveAnnotations->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                bool allFrames = message["value"];
-                player->createAnnotation(allFrames);
-            }
-            else if (c == "Annotations")
-            {
-                bool receive = prefs->ReceiveAnnotations->value();
-                if (!receive || !player)
-                {
-                    tcp->unlock();
-                    return;
-                }
+            set_edit_mode_cb(value, ui);
+        };
 
-                const std::vector<draw::Annotation>& tmp = message["value"];
-                std::vector< std::shared_ptr<draw::Annotation> > annotations;
-                for (const auto& ann : tmp)
-                {
-                    std::shared_ptr< draw::Annotation > annotation =
-                        messageToAnnotation(ann);
-                    annotations.push_back(annotation);
-                }
+        handlers["Network Panel"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+            bool value = message["value"];
+            if ((!value && networkPanel) || (value && !networkPanel))
+                network_panel_cb(nullptr, ui);
+        };
 
-                player->setAllAnnotations(annotations);
-                ui->uiTimeline->redraw();
-                ui->uiMain->fill_menu(ui->uiMenuBar);
-            }
-            else if (c == "viewPosAndZoom")
-            {
-                bool receive = prefs->ReceivePanAndZoom->value();
-                if (!receive || !view)
-                {
-                    tcp->unlock();
-                    return;
-                }
+        handlers["USD Panel"] = [this](const Message& message)
+        {
+#ifdef TLRENDER_USD
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+            bool value = message["value"];
+            if ((!value && usdPanel) || (value && !usdPanel))
+                usd_panel_cb(nullptr, ui);
+#endif
+        };
 
-                float remoteZoom = message["zoom"];
+        handlers["NDI Panel"] = [this](const Message& message)
+        {
+#ifdef TLRENDER_NDI
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+            bool value = message["value"];
+            if ((!value && ndiPanel) || (value && !ndiPanel))
+                ndi_panel_cb(nullptr, ui);
+#endif
+        };
 
-                // When all files are closed, we get an infinite zoom (null),
-                if (isinf(remoteZoom))
-                {
-                    tcp->unlock();
-                    return;
-                }
+        // Logs panel is not sent nor received.
+        handlers["Python Panel"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+#ifdef MRV2_PYBIND11
+            bool value = message["value"];
+            if ((!value && pythonPanel) || (value && !pythonPanel))
+                python_panel_cb(nullptr, ui);
+#endif
+        };
 
-                const math::Vector2i& remoteViewPos = message["viewPos"];
-                const auto& remoteViewport = message["viewport"];
-                const auto viewport = view->getViewportSize();
-                const auto renderSize = view->getRenderSize();
+        handlers["Playlist Panel"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+            bool value = message["value"];
+            if ((!value && playlistPanel) || (value && !playlistPanel))
+                playlist_panel_cb(nullptr, ui);
+        };
 
-                // Output values
-                math::Vector2i localViewPos; // Local view position (panning)
-                float localZoom;             // Local zoom factor
+        handlers["Settings Panel"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+            bool value = message["value"];
+            if ((!value && settingsPanel) || (value && !settingsPanel))
+                settings_panel_cb(nullptr, ui);
+        };
 
-                // Call the function to match the remote image position
-                matchRemoteImagePosition(
-                    remoteViewPos, remoteZoom, remoteViewport, renderSize,
-                    viewport, localViewPos, localZoom);
+        handlers["Vectorscope Panel"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+            bool value = message["value"];
+            if ((!value && vectorscopePanel) ||
+                (value && !vectorscopePanel))
+                vectorscope_panel_cb(nullptr, ui);
+        };
 
-                view->setViewPosAndZoom(localViewPos, localZoom);
-            }
-            else if (c == "Show Annotations")
-            {
-                bool receive = prefs->ReceiveAnnotations->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                bool value = message["value"];
-                view->setShowAnnotations(value);
-            }
-            else if (c == "Menu Bar")
-            {
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                bool value = message["value"];
-                if (value)
-                {
-                    ui->uiMenuBar->show();
-                }
-                else
-                {
-                    ui->uiMenuBar->hide();
-                }
-                ui->uiRegion->layout();
-                ui->uiMain->fill_menu(ui->uiMenuBar);
-            }
-            else if (c == "Top Bar")
-            {
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                bool value = message["value"];
-                if (value)
-                {
-                    ui->uiTopBar->show();
-                }
-                else
-                {
-                    ui->uiTopBar->hide();
-                }
-                ui->uiRegion->layout();
-                ui->uiMain->fill_menu(ui->uiMenuBar);
-            }
-            else if (c == "Pixel Bar")
-            {
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                bool value = message["value"];
-                if (value)
-                {
-                    ui->uiPixelBar->show();
-                }
-                else
-                {
-                    ui->uiPixelBar->hide();
-                }
-                ui->uiRegion->layout();
-                ui->uiMain->fill_menu(ui->uiMenuBar);
-            }
-            else if (c == "Bottom Bar")
-            {
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                bool value = message["value"];
-                if (value)
-                {
-                    ui->uiBottomBar->show();
-                }
-                else
-                {
-                    ui->uiBottomBar->hide();
-                }
-                ui->uiRegion->layout();
-                ui->uiMain->fill_menu(ui->uiMenuBar);
-            }
-            else if (c == "Status Bar")
-            {
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                bool value = message["value"];
-                if (value)
-                {
-                    ui->uiStatusBar->show();
-                }
-                else
-                {
-                    ui->uiStatusBar->hide();
-                }
-                ui->uiRegion->layout();
-            }
-            else if (c == "Action Bar")
-            {
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                bool value = message["value"];
-                if (value)
-                {
-                    ui->uiToolsGroup->show();
-                }
-                else
-                {
-                    ui->uiToolsGroup->hide();
-                }
-                ui->uiViewGroup->layout();
-                ui->uiMain->fill_menu(ui->uiMenuBar);
-            }
-            else if (c == "Fullscreen")
-            {
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive || !view)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                bool value = message["value"];
-                view->setFullScreenMode(value);
-            }
-            else if (c == "Presentation")
-            {
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive || !view)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                bool value = message["value"];
-                view->setPresentationMode(value);
-            }
-            else if (c == "Selection Area")
-            {
-                bool receive = prefs->ReceiveColor->value();
-                if (!receive || !view)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                const math::Box2i& area = message["value"];
-                view->setSelectionArea(area);
-            }
-            else if (c == "One Panel Only")
-            {
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                bool value = message["value"];
-                if ((!value && panel::onlyOne()) ||
-                    (value && !panel::onlyOne()))
-                    toggle_one_panel_only_cb(nullptr, ui);
-            }
-            else if (c == "Color Panel")
-            {
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                bool value = message["value"];
-                if ((!value && colorPanel) || (value && !colorPanel))
-                    color_panel_cb(nullptr, ui);
-            }
-            else if (c == "Annotations Panel")
-            {
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                bool value = message["value"];
-                if ((!value && annotationsPanel) ||
-                    (value && !annotationsPanel))
-                    annotations_panel_cb(nullptr, ui);
-            }
-            else if (c == "Background Panel")
-            {
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                bool value = message["value"];
-                if ((!value && backgroundPanel) || (value && !backgroundPanel))
-                    background_panel_cb(nullptr, ui);
-            }
-            else if (c == "Color Area Panel")
-            {
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                bool value = message["value"];
-                if ((!value && colorAreaPanel) || (value && !colorAreaPanel))
-                    color_area_panel_cb(nullptr, ui);
-            }
-            else if (c == "Compare Panel")
-            {
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                bool value = message["value"];
-                if ((!value && comparePanel) || (value && !comparePanel))
-                    compare_panel_cb(nullptr, ui);
-            }
-            else if (c == "Devices Panel")
-            {
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                bool value = message["value"];
-                if ((!value && devicesPanel) || (value && !devicesPanel))
-                    devices_panel_cb(nullptr, ui);
-            }
-            else if (c == "Environment Map Panel")
-            {
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                bool value = message["value"];
-                if ((!value && environmentMapPanel) ||
-                    (value && !environmentMapPanel))
-                    environment_map_panel_cb(nullptr, ui);
-            }
-            else if (c == "Files Panel")
-            {
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                bool value = message["value"];
-                if ((!value && filesPanel) || (value && !filesPanel))
-                    files_panel_cb(nullptr, ui);
-            }
-            else if (c == "Histogram Panel")
-            {
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                bool value = message["value"];
-                if ((!value && histogramPanel) || (value && !histogramPanel))
-                    histogram_panel_cb(nullptr, ui);
-            }
-            else if (c == "Media Info Panel")
-            {
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                bool value = message["value"];
-                if ((!value && imageInfoPanel) || (value && !imageInfoPanel))
-                    image_info_panel_cb(nullptr, ui);
-            }
-            else if (c == "setEditMode")
-            {
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                EditMode value = message["value"];
-                editMode = value;
-                editModeH = message["height"];
-                bool presentation = ui->uiView->getPresentationMode();
-                if (!presentation)
-                    ui->uiView->resizeWindow();
-
-                set_edit_mode_cb(value, ui);
-            }
-            else if (c == "Network Panel")
-            {
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                bool value = message["value"];
-                if ((!value && networkPanel) || (value && !networkPanel))
-                    network_panel_cb(nullptr, ui);
-            }
-            else if (c == "USD Panel")
-            {
-#ifdef TLRENDER_USD
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                bool value = message["value"];
-                if ((!value && usdPanel) || (value && !usdPanel))
-                    usd_panel_cb(nullptr, ui);
-#endif
-            }
-            else if (c == "NDI Panel")
-            {
-#ifdef TLRENDER_NDI
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                bool value = message["value"];
-                if ((!value && ndiPanel) || (value && !ndiPanel))
-                    ndi_panel_cb(nullptr, ui);
-#endif
-            }
-            // Logs panel is not sent nor received.
-            else if (c == "Python Panel")
-            {
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-#ifdef MRV2_PYBIND11
-                bool value = message["value"];
-                if ((!value && pythonPanel) || (value && !pythonPanel))
-                    python_panel_cb(nullptr, ui);
+        handlers["Waveform Panel"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+            bool value = message["value"];
+            if ((!value && waveformPanel) || (value && !waveformPanel))
+                waveform_panel_cb(nullptr, ui);
+        };
+
+        handlers["Stereo 3D Panel"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+            bool value = message["value"];
+            if ((!value && stereo3DPanel) || (value && !stereo3DPanel))
+                stereo3D_panel_cb(nullptr, ui);
+        };
+
+        handlers["setTimelineDisplayOptions"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+            timelineui::DisplayOptions value = message["value"];
+            ui->uiTimeline->setDisplayOptions(value);
+        };
+
+        handlers["Timeline/FrameView"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+            ui->uiTimeline->frameView();
+        };
+
+        handlers["Timeline/ScrollToCurrentFrame"] =
+            [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+            bool value = message["value"];
+            ui->uiTimeline->setScrollToCurrentFrame(value);
+        };
+
+        handlers["setTimelineEditable"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+            bool value = message["value"];
+            ui->uiTimeline->setEditable(value);
+        };
+
+        handlers["Clear Frame Annotations"] = [this](const Message& message)
+        {
+            annotation_clear_cb(nullptr, ui);
+        };
+
+        handlers["Clear All Annotations"] = [this](const Message& message)
+        {
+            annotation_clear_all_cb(nullptr, ui);
+        };
+
+        handlers["Create New Timeline"] = [this](const Message& message)
+        {
+            create_new_timeline_cb(ui);
+        };
+
+        handlers["Add Clip to Timeline"] = [this](const Message& message)
+        {
+            int Aindex = message["value"];
+            add_clip_to_timeline_cb(Aindex, ui);
+        };
+
+        handlers["Edit/Frame/Cut"] = [this](const Message& message)
+        {
+            edit_cut_frame_cb(nullptr, ui);
+        };
+
+        handlers["Edit/Frame/Copy"] = [this](const Message& message)
+        {
+            edit_copy_frame_cb(nullptr, ui);
+        };
+
+        handlers["Edit/Frame/Paste"] = [this](const Message& message)
+        {
+            edit_paste_frame_cb(nullptr, ui);
+        };
+
+        handlers["Edit/Frame/Insert"] = [this](const Message& message)
+        {
+            edit_insert_frame_cb(nullptr, ui);
+        };
+
+        handlers["Edit/Audio Gap/Insert"] = [this](const Message& message)
+        {
+            edit_insert_audio_gap_cb(nullptr, ui);
+        };
+
+        handlers["Edit/Audio Gap/Remove"] = [this](const Message& message)
+        {
+            edit_remove_audio_gap_cb(nullptr, ui);
+        };
+
+        handlers["Edit/Slice"] = [this](const Message& message)
+        {
+            edit_slice_clip_cb(nullptr, ui);
+        };
+
+        handlers["Edit/Remove"] = [this](const Message& message)
+        {
+            edit_remove_clip_cb(nullptr, ui);
+        };
+
+        handlers["Edit/Undo"] = [this](const Message& message)
+        {
+            edit_undo_cb(nullptr, ui);
+        };
+
+        handlers["Edit/Redo"] = [this](const Message& message)
+        {
+            edit_redo_cb(nullptr, ui);
+        };
+
+        handlers["setFilesPanelOptions"] = [this](const Message& message)
+        {
+            bool receive = prefs->ReceiveUI->value();
+            if (!receive)
+                return;
+
+            const FilesPanelOptions& o = message["value"];
+            app->filesModel()->setFilesPanelOptions(o);
+        };
+
+        handlers["Protocol Version"] = [this](const Message& message)
+        {
+            int value = message["value"];
+            if (value != kProtocolVersion)
+            {
+                std::string msg =
+                    tl::string::Format(
+                        _("Server protocol version is {0}.  Client "
+                          "protocol version is {1}"))
+                        .arg(value)
+                        .arg(kProtocolVersion);
+                LOG_ERROR(msg);
+            }
+        };
+    }
+
+    void CommandInterpreter::parse(const Message& message)
+    {
+        const std::string& c = message["command"];
+        app = ui->app;
+        prefs = ui->uiPrefs;
+        view = ui->uiView;
+        player = nullptr;
+        if (view)
+            player = view->getTimelinePlayer();
+
+#ifndef NDEBUG
+        std::cerr << "Command: " << message << std::endl;
 #endif
-            }
-            else if (c == "Playlist Panel")
-            {
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                bool value = message["value"];
-                if ((!value && playlistPanel) || (value && !playlistPanel))
-                    playlist_panel_cb(nullptr, ui);
-            }
-            else if (c == "Settings Panel")
-            {
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                bool value = message["value"];
-                if ((!value && settingsPanel) || (value && !settingsPanel))
-                    settings_panel_cb(nullptr, ui);
-            }
-            else if (c == "Vectorscope Panel")
-            {
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                bool value = message["value"];
-                if ((!value && vectorscopePanel) ||
-                    (value && !vectorscopePanel))
-                    vectorscope_panel_cb(nullptr, ui);
-            }
-            else if (c == "Stereo 3D Panel")
-            {
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                bool value = message["value"];
-                if ((!value && stereo3DPanel) || (value && !stereo3DPanel))
-                    stereo3D_panel_cb(nullptr, ui);
-            }
-            else if (c == "setTimelineDisplayOptions")
-            {
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                timelineui::DisplayOptions value = message["value"];
-                ui->uiTimeline->setDisplayOptions(value);
-            }
-            else if (c == "Timeline/FrameView")
-            {
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                ui->uiTimeline->frameView();
-            }
-            else if (c == "Timeline/ScrollToCurrentFrame")
-            {
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                bool value = message["value"];
-                ui->uiTimeline->setScrollToCurrentFrame(value);
-            }
-            else if (c == "setTimelineEditable")
-            {
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
-                bool value = message["value"];
-                ui->uiTimeline->setEditable(value);
-            }
-            else if (c == "Clear Frame Annotations")
-            {
-                annotation_clear_cb(nullptr, ui);
-            }
-            else if (c == "Clear All Annotations")
-            {
-                annotation_clear_all_cb(nullptr, ui);
-            }
-            else if (c == "Create New Timeline")
-            {
-                create_new_timeline_cb(ui);
-            }
-            else if (c == "Add Clip to Timeline")
-            {
-                int Aindex = message["value"];
-                add_clip_to_timeline_cb(Aindex, ui);
-            }
-            else if (c == "Edit/Frame/Cut")
-            {
-                edit_cut_frame_cb(nullptr, ui);
-            }
-            else if (c == "Edit/Frame/Copy")
-            {
-                edit_copy_frame_cb(nullptr, ui);
-            }
-            else if (c == "Edit/Frame/Paste")
-            {
-                edit_paste_frame_cb(nullptr, ui);
-            }
-            else if (c == "Edit/Frame/Insert")
-            {
-                edit_insert_frame_cb(nullptr, ui);
-            }
-            else if (c == "Edit/Audio Gap/Insert")
-            {
-                edit_insert_audio_gap_cb(nullptr, ui);
-            }
-            else if (c == "Edit/Audio Gap/Remove")
-            {
-                edit_remove_audio_gap_cb(nullptr, ui);
-            }
-            else if (c == "Edit/Slice")
-            {
-                edit_slice_clip_cb(nullptr, ui);
-            }
-            else if (c == "Edit/Remove")
-            {
-                edit_remove_clip_cb(nullptr, ui);
-            }
-            else if (c == "Edit/Undo")
-            {
-                edit_undo_cb(nullptr, ui);
-            }
-            else if (c == "Edit/Redo")
-            {
-                edit_redo_cb(nullptr, ui);
-            }
-            else if (c == "setFilesPanelOptions")
-            {
-                bool receive = prefs->ReceiveUI->value();
-                if (!receive)
-                {
-                    tcp->unlock();
-                    return;
-                }
 
-                const FilesPanelOptions& o = message["value"];
-                app->filesModel()->setFilesPanelOptions(o);
-            }
-            else if (c == "Protocol Version")
-            {
-                int value = message["value"];
-                if (value != kProtocolVersion)
-                {
-                    std::string msg =
-                        tl::string::Format(
-                            _("Server protocol version is {0}.  Client "
-                              "protocol version is {1}"))
-                            .arg(value)
-                            .arg(kProtocolVersion);
-                    LOG_ERROR(msg);
-                }
-            }
-            else
-            {
-                // @todo: Unknown command
-                std::string err =
-                    tl::string::Format("Ignored network command {0}.").arg(c);
-                LOG_ERROR(err);
-            }
+        const auto i = handlers.find(c);
+        if (i == handlers.end())
+        {
+            // @todo: Unknown command
+            std::string err =
+                tl::string::Format("Ignored network command {0}.").arg(c);
+            LOG_ERROR(err);
+            return;
+        }
+
+        try
+        {
+            tcp->lock();
+            i->second(message);
         }
         catch (const std::exception& e)
         {
@@ -1446,7 +1323,6 @@ namespace mrv
         }
         tcp->unlock();
     }
-
     void CommandInterpreter::timerEvent()
     {
 
@@ -1457,11 +1333,26 @@ namespace mrv
             return;
         }
 
+        // Apply all the pending messages at once, skipping the ones that
+        // are superseded by the message that follows them, and redraw the
+        // view only once.
+        std::vector<Message> messages;
         while (tcp->hasReceive())
+            messages.push_back(tcp->popMessage());
+
+        redraw = false;
+        for (size_t i = 0; i < messages.size(); ++i)
         {
-            const Message& message = tcp->popMessage();
-            parse(message);
+            if (i + 1 < messages.size() &&
+                isSuperseded(
+                    messages[i].value("command", std::string()),
+                    messages[i + 1].value("command", std::string())))
+                continue;
+            parse(messages[i]);
         }
+        if (redraw && ui->uiView)
+            ui->uiView->redrawWindows();
+
         Fl::repeat_timeout(kTimeout, (Fl_Timeout_Handler)timerEvent_cb, this);
     }
 
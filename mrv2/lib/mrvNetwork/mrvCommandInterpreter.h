@@ -4,13 +4,21 @@
 
 #pragma once
 
+#include <functional>
+#include <string>
+#include <unordered_map>
+
 #include "mrvNetwork/mrvTCP.h"
 
 class ViewerUI;
+class PreferencesUI;
 
 namespace mrv
 {
+    class App;
     class FilesModelItem;
+    class TimelinePlayer;
+    class Viewport;
 
     class CommandInterpreter
     {
@@ -33,7 +41,24 @@ namespace mrv
         static void timerEvent_cb(void* d);
 
     private:
+        //! Register the handlers of the network commands.
+        void _registerHandlers();
+
+        typedef std::function<void(const Message&)> Handler;
+
         ViewerUI* ui;
+
+        //! Handlers keyed by command.
+        std::unordered_map<std::string, Handler> handlers;
+
+        //! State of the message being parsed, used by the handlers.
+        App* app = nullptr;
+        PreferencesUI* prefs = nullptr;
+        Viewport* view = nullptr;
+        TimelinePlayer* player = nullptr;
+
+        //! Whether the view needs to be redrawn after the current batch.
+        bool redraw = false;
     };
 
 } // namespace mrv
@@ -19,6 +19,7 @@
 #include "mrvNetwork/mrvTCP.h"
 #include "mrvNetwork/mrvMessagePublisher.h"
 #include "mrvNetwork/mrvConnectionHandler.h"
+#include "mrvNetwork/mrvProtocolVersion.h"
 
 namespace
 {
@@ -44,6 +45,12 @@ namespace mrv
 
         messagePublisher.add(clientIP, socket);
 
+        // Send the protocol version right away, so clients that don't ask
+        // for the state still find out whether they match.
+        Message version = {
+            {"command", "Protocol Version"}, {"value", kProtocolVersion}};
+        messagePublisher.send(version, clientIP);
+
         handlers.push_back(this);
 
         _reactor.addEventHandler(
@@ -63,6 +70,7 @@ namespace mrv
             {
                 while (running())
                 {
+                    waitForSend();
                     sendMessages();
                 }
             });
@@ -73,8 +81,7 @@ namespace mrv
             tl::string::Format(_("A client connected from {0}")).arg(host);
         LOG_INFO(msg);
 
-        //! Sync this client to the server
-        syncClient();
+        // The client is synced when it sends its "Sync Request".
     }
 
     /**
@@ -136,12 +143,8 @@ namespace mrv
     {
         try
         {
-            std::lock_guard lk(m_sendMutex);
-            while (hasSend())
+            for (const auto& message : takeSend())
             {
-                auto message = m_send.front();
-                m_send.pop_front();
-
                 messagePublisher.publish(message);
             }
         }
@@ -159,9 +162,18 @@ namespace mrv
         {
             try
             {
-                std::lock_guard lk(m_receiveMutex);
                 Message message = receiveMessage();
-                m_receive.push_back(message);
+                if (message["command"] == "Sync Request")
+                {
+                    //! Sync this client to the server
+                    syncClient();
+                    return;
+                }
+
+                {
+                    std::lock_guard lk(m_receiveMutex);
+                    m_receive.push_back(message);
+                }
 
                 auto clientIP = getIP();
                 // Publish message to other subscribers
@@ -87,9 +87,13 @@ namespace mrv
         //! Gets the remote (client) IP.
         std::string getIP() const;
 
-        //! Sync client to server data.
+        //! Sync client to server data, in one compressed message sent only
+        //! to this client.
         void syncClient();
 
+        //! Push the messages that describe the server's state.
+        void syncState();
+
         //! Sync client to server's UI.
         void syncUI();
 
@@ -2,8 +2,112 @@
 // mrv2
 // Copyright Contributors to the mrv2 Project. All rights reserved.
 
+#include <set>
+#include <stdexcept>
+
+#include <zlib.h>
+
+#include "mrvDraw/Point.h"
+
 #include "mrvMessage.h"
 
+namespace
+{
+    //! Commands that only carry the latest state.
+    const std::set<std::string> kStateCommands = {
+        "seek", "viewPosAndZoom", "Timeline Mouse Move", "setVolume"};
+
+    void packPoints(nlohmann::json& value)
+    {
+        const mrv::draw::PointList pts = value;
+        value = nlohmann::json::binary(mrv::draw::packPoints(pts));
+    }
+
+    void packValues(nlohmann::json& json)
+    {
+        if (json.is_object())
+        {
+            for (auto& item : json.items())
+            {
+                if (item.key() == "pts" && item.value().is_array())
+                    packPoints(item.value());
+                else
+                    packValues(item.value());
+            }
+        }
+        else if (json.is_array())
+        {
+            for (auto& value : json)
+                packValues(value);
+        }
+    }
+} // namespace
+
 namespace mrv
 {
+    void packMessage(Message& message)
+    {
+        if (!message.is_object())
+            return;
+
+        const std::string command = message.value("command", std::string());
+        if (command == "Add Shape Points" && message["value"].is_array())
+        {
+            packPoints(message["value"]);
+            return;
+        }
+
+        packValues(message);
+    }
+
+    Message compressMessages(
+        const std::string& command, const std::vector<Message>& messages)
+    {
+        nlohmann::json values = nlohmann::json::array();
+        for (const auto& message : messages)
+        {
+            Message packed = message;
+            packMessage(packed);
+            values.push_back(packed);
+        }
+        const nlohmann::json bundle = {{"messages", values}};
+        const std::vector<uint8_t> bson = nlohmann::json::to_bson(bundle);
+
+        uLongf size = compressBound(bson.size());
+        std::vector<uint8_t> data(size);
+        if (compress2(
+                data.data(), &size, bson.data(), bson.size(),
+                Z_BEST_SPEED) != Z_OK)
+            throw std::runtime_error("Could not compress messages");
+        data.resize(size);
+
+        Message out;
+        out["command"] = command;
+        out["size"] = bson.size();
+        out["value"] = nlohmann::json::binary(std::move(data));
+        return out;
+    }
+
+    std::vector<Message> uncompressMessages(const Message& message)
+    {
+        const auto& data = message["value"].get_binary();
+        uLongf size = message["size"].get<uint64_t>();
+        std::vector<uint8_t> bson(size);
+        if (uncompress(bson.data(), &size, data.data(), data.size()) != Z_OK ||
+            size != bson.size())
+            throw std::runtime_error("Could not uncompress messages");
+
+        const Message values = nlohmann::json::from_bson(bson);
+        return values.at("messages").get<std::vector<Message> >();
+    }
+    bool isSuperseded(
+        const std::string& command, const std::string& nextCommand)
+    {
+        if (nextCommand == "Update Shape")
+            return (
+                command == "Update Shape" || command == "Add Shape Point" ||
+                command == "Add Shape Points");
+        return command == nextCommand && kStateCommands.count(command);
+    }
+
 } // namespace mrv
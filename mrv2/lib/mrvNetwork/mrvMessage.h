@@ -5,6 +5,8 @@
 #pragma once
 
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 
@@ -15,4 +17,24 @@ namespace mrv
 
     typedef nlohmann::json Message;
 
+    //! Replace the annotation point lists of a message with packed binary
+    //! blobs before sending it.  Receivers unpack them when converting the
+    //! message back to shapes.
+    void packMessage(Message& message);
+
+    //! Bundle several messages in a single zlib compressed message.
+    Message compressMessages(
+        const std::string& command, const std::vector<Message>& messages);
+
+    //! Extract the messages of a message built with compressMessages.
+    std::vector<Message> uncompressMessages(const Message& message);
+
+    //! Returns whether a message with nextCommand makes a message with
+    //! command useless, so the latter need not be sent or applied.  That
+    //! is the case of commands that only carry the latest state, like
+    //! "seek", and of "Update Shape", which carries all the points of the
+    //! last shape.
+    bool isSuperseded(
+        const std::string& command, const std::string& nextCommand);
+
 } // namespace mrv
@@ -2,6 +2,11 @@
 // mrv2
 // Copyright Contributors to the mrv2 Project. All rights reserved.
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
 #include <Poco/Net/StreamSocket.h>
 #include <Poco/Net/NetException.h>
 
@@ -12,76 +17,200 @@
 namespace
 {
     const char* kModule = "publisher";
-}
+
+    //! Limits of the messages queued for a client.  A client that falls
+    //! further behind is disconnected; it gets the current state again
+    //! when it reconnects.
+    const size_t kMaxQueuedMessages = 4096;
+    const size_t kMaxQueuedBytes = 64 * 1024 * 1024;
+} // namespace
 
 namespace mrv
 {
+    typedef std::shared_ptr<const std::vector<uint8_t> > MessageData;
 
-    //! Relay a message from a client to all clients except the one
-    //! that sent the original message
-    void
-    MessagePublisher::publish(const Message& message, const ClientIP& clientIP)
+    namespace
     {
-        int size;
-        auto it = sockets.begin();
-        while (it != sockets.end())
+        //! Encode a message, with its length header, ready to be sent.
+        MessageData encodeMessage(const Message& message)
         {
-            if (it->first == clientIP)
+            try
             {
-                ++it;
-                continue;
+                Message packed = message;
+                packMessage(packed);
+                const std::vector< uint8_t > v_bson =
+                    nlohmann::json::to_bson(packed);
+                const int messageLength = v_bson.size();
+                if (messageLength <= 0)
+                    return nullptr;
+
+                auto out = std::make_shared<std::vector<uint8_t> >(
+                    sizeof(messageLength) + messageLength);
+                const int messageLengthHtoNL = htonl(messageLength);
+                memcpy(
+                    out->data(), &messageLengthHtoNL, sizeof(messageLength));
+                memcpy(
+                    out->data() + sizeof(messageLength), v_bson.data(),
+                    messageLength);
+                return out;
+            }
+            catch (const std::exception& e)
+            {
+                LOG_ERROR("std::exception caught: " << e.what());
             }
+            return nullptr;
+        }
+    } // namespace
 
-            Poco::Net::StreamSocket& m_socket = it->second;
+    struct MessagePublisher::Client
+    {
+        struct Item
+        {
+            std::string command;
+            MessageData data;
+        };
 
-            try
-            {
-                std::vector< uint8_t > v_bson =
-                    nlohmann::json::to_bson(message);
+        Poco::Net::StreamSocket socket;
 
-                int messageLength = v_bson.size();
-                if (messageLength <= 0)
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::deque<Item> queue;
+        size_t queuedBytes = 0;
+        bool running = true;
+
+        std::atomic<bool> failed = false;
+        std::thread thread;
+
+        //! Queue a message.  Returns false if the client fell too far
+        //! behind.
+        bool push(const std::string& command, const MessageData& data)
+        {
+            {
+                std::lock_guard lk(mutex);
+                // A message replaces the last one queued, not sent yet,
+                // if it supersedes it.
+                if (!queue.empty() &&
+                    isSuperseded(queue.back().command, command))
                 {
-                    continue;
+                    queue.back().command = command;
+                    queuedBytes -= queue.back().data->size();
+                    queue.back().data = data;
                 }
+                else
+                {
+                    if (queue.size() >= kMaxQueuedMessages ||
+                        queuedBytes + data->size() > kMaxQueuedBytes)
+                        return false;
+                    queue.push_back({command, data});
+                }
+                queuedBytes += data->size();
+            }
+            condition.notify_one();
+            return true;
+        }
 
-                // Send command
-                int messageLengthHtoNL = htonl(messageLength);
-
-                size = m_socket.sendBytes(
-                    &messageLengthHtoNL, sizeof(messageLength));
-                if (size <= 0)
+        void run()
+        {
+            while (true)
+            {
+                Item item;
                 {
-                    it = sockets.erase(it);
-                    continue;
+                    std::unique_lock lk(mutex);
+                    condition.wait(
+                        lk, [this] { return !queue.empty() || !running; });
+                    if (!running)
+                        break;
+                    item = std::move(queue.front());
+                    queue.pop_front();
+                    queuedBytes -= item.data->size();
                 }
 
-                int len = 0;
-                while (len < messageLength)
+                try
                 {
-                    size = m_socket.sendBytes(
-                        v_bson.data() + len, messageLength - len);
-                    if (size <= 0)
+                    const auto& data = *item.data;
+                    const int dataLength = static_cast<int>(data.size());
+                    int len = 0;
+                    while (len < dataLength)
                     {
-                        continue;
+                        int size = socket.sendBytes(
+                            data.data() + len, dataLength - len);
+                        if (size <= 0)
+                            throw Poco::Net::ConnectionResetException();
+                        len += size;
                     }
-                    len += size;
+                }
+                catch (const Poco::Exception& ex)
+                {
+                    // Handle the exception here, which indicates the client
+                    // disconnect event
+                    LOG_ERROR("Poco::Exception caught: " << ex.displayText());
+                    failed = true;
+                    break;
+                }
+                catch (const std::exception& e)
+                {
+                    LOG_ERROR("std::exception caught: " << e.what());
+                    failed = true;
+                    break;
                 }
             }
-            catch (const Poco::Exception& ex)
+        }
+
+        void stop()
+        {
+            {
+                std::lock_guard lk(mutex);
+                running = false;
+            }
+            condition.notify_all();
+            if (thread.joinable())
+                thread.join();
+        }
+    };
+
+    MessagePublisher::MessagePublisher() {}
+
+    MessagePublisher::~MessagePublisher()
+    {
+        std::lock_guard lk(mutex);
+        for (auto& client : clients)
+            client.second->stop();
+        clients.clear();
+    }
+
+    //! Relay a message from a client to all clients except the one
+    //! that sent the original message
+    void
+    MessagePublisher::publish(const Message& message, const ClientIP& clientIP)
+    {
+        std::lock_guard lk(mutex);
+
+        _removeFailed();
+
+        if (clients.empty() ||
+            (clients.size() == 1 && clients.count(clientIP)))
+            return;
+
+        // Encode the message, with its length header, once for all the
+        // clients.
+        MessageData data = encodeMessage(message);
+        if (!data)
+            return;
+
+        const std::string command = message.value("command", std::string());
+
+        auto it = clients.begin();
+        while (it != clients.end())
+        {
+            if (it->first == clientIP)
             {
-                // Handle the exception here, which indicates the client
-                // disconnect event
-                LOG_ERROR("Poco::Exception caught: " << ex.displayText());
-                it = remove(it->first);
+                ++it;
                 continue;
             }
-            catch (const std::exception& e)
+
+            if (!_push(it->first, *it->second, command, data))
             {
-                // Handle the exception here, which indicates the client
-                // disconnect event
-                LOG_ERROR("std::exception caught: " << e.what());
-                it = remove(it->first);
+                it = clients.erase(it);
                 continue;
             }
 
@@ -90,24 +219,89 @@ namespace mrv
     }
 
     void
-    MessagePublisher::add(const ClientIP& ip, Poco::Net::StreamSocket& socket)
+    MessagePublisher::send(const Message& message, const ClientIP& clientIP)
     {
-        sockets[ip] = socket;
+        std::lock_guard lk(mutex);
+
+        _removeFailed();
 
+        auto it = clients.find(clientIP);
+        if (it == clients.end())
+            return;
+
+        MessageData data = encodeMessage(message);
+        if (!data)
+            return;
+
+        const std::string command = message.value("command", std::string());
+        if (!_push(it->first, *it->second, command, data))
+            clients.erase(it);
+    }
+
+    void
+    MessagePublisher::add(const ClientIP& ip, Poco::Net::StreamSocket& socket)
+    {
         Poco::Timespan timeout(2, 0); // 2 Sec
         socket.setSendTimeout(timeout);
+
+        auto client = std::make_shared<Client>();
+        client->socket = socket;
+        client->thread = std::thread([client] { client->run(); });
+
+        std::lock_guard lk(mutex);
+        auto it = clients.find(ip);
+        if (it != clients.end())
+            it->second->stop();
+        clients[ip] = client;
+    }
+
+    void MessagePublisher::remove(const ClientIP& ip)
+    {
+        std::shared_ptr<Client> client;
+        {
+            std::lock_guard lk(mutex);
+            auto it = clients.find(ip);
+            if (it == clients.end())
+                return;
+            client = it->second;
+            clients.erase(it);
+        }
+        client->stop();
     }
 
-    IPsToSocket::iterator MessagePublisher::remove(const ClientIP& ip)
+    bool MessagePublisher::_push(
+        const ClientIP& ip, Client& client, const std::string& command,
+        const MessageData& data)
     {
-        auto it = sockets.find(ip);
-        if (it != sockets.end())
+        if (client.push(command, data))
+            return true;
+
+        std::string msg =
+            tl::string::Format(_("{0} is too far behind.  Disconnecting it."))
+                .arg(ipToHostname(ip));
+        LOG_WARNING(msg);
+        client.socket.shutdown();
+        client.stop();
+        return false;
+    }
+
+    void MessagePublisher::_removeFailed()
+    {
+        auto it = clients.begin();
+        while (it != clients.end())
         {
-            std::string msg =
-                tl::string::Format(_("Removing {0} from message publisher."))
-                    .arg(ipToHostname(ip));
-            it = sockets.erase(it);
+            if (it->second->failed)
+            {
+                std::string msg =
+                    tl::string::Format(
+                        _("Removing {0} from message publisher."))
+                        .arg(ipToHostname(it->first));
+                LOG_INFO(msg);
+                it->second->stop();
+                it = clients.erase(it);
+                continue;
+            }
+            ++it;
         }
-        return it;
     }
 } // namespace mrv
@@ -5,6 +5,8 @@
 // Example of a basic pub/sub mechanism
 #pragma once
 
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -18,23 +20,41 @@ namespace mrv
     using Poco::Net::Socket;
 
     typedef std::string ClientIP;
-    typedef std::unordered_map<ClientIP, Poco::Net::StreamSocket> IPsToSocket;
 
+    //! Publishes messages to the connected clients.  Each message is
+    //! encoded once and each client gets it from its own queue and writer
+    //! thread, so a slow client does not delay the others.
     class MessagePublisher
     {
     public:
+        MessagePublisher();
+        ~MessagePublisher();
+
         //! Relay a message from a client to all clients except the one
         //! that sent the original message
         void publish(const Message& message, const ClientIP& client = "");
 
+        //! Send a message to a single client.
+        void send(const Message& message, const ClientIP& client);
+
         void add(const ClientIP& ip, Poco::Net::StreamSocket& socket);
 
-        IPsToSocket::iterator remove(const ClientIP& ip);
+        void remove(const ClientIP& ip);
 
     private:
-        void shutdown(Poco::Net::StreamSocket& socket);
+        struct Client;
+
+        //! Queue a message for a client.  Returns false, after stopping
+        //! the client, if it fell too far behind.
+        bool _push(
+            const ClientIP& ip, Client& client, const std::string& command,
+            const std::shared_ptr<const std::vector<uint8_t> >& data);
+
+        //! Remove the clients whose connection failed.
+        void _removeFailed();
 
-        IPsToSocket sockets;
+        std::mutex mutex;
+        std::unordered_map<ClientIP, std::shared_ptr<Client> > clients;
     };
 
 } // namespace mrv
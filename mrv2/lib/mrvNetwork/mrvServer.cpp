@@ -55,10 +55,7 @@ namespace mrv
         std::thread* disconnectionThread = new std::thread(
             [this]
             {
-                while (running())
-                {
-                    // m_running is volatile so this loop is not optimized
-                }
+                waitForStop();
                 reactor.stop(); // release reactor.run()
             });
         m_threads.push_back(disconnectionThread);
@@ -75,6 +72,8 @@ namespace mrv
 
     void Server::pushMessage(const Message& message)
     {
+        if (capture(message))
+            return;
         if (m_lock)
             return;
         ConnectionHandler* handler = ConnectionHandler::handler();
@@ -10,20 +10,39 @@
 
 #include "mrvNetwork/mrvCompareOptions.h"
 #include "mrvNetwork/mrvFilesModelItem.h"
-#include "mrvNetwork/mrvProtocolVersion.h"
 #include "mrvNetwork/mrvConnectionHandler.h"
 
 namespace mrv
 {
     void ConnectionHandler::syncClient()
+    {
+        // Collect the state messages instead of sending them to all
+        // clients.
+        std::vector<Message> messages;
+        TCP::setCapture(&messages);
+        try
+        {
+            syncState();
+        }
+        catch (...)
+        {
+            TCP::setCapture(nullptr);
+            throw;
+        }
+        TCP::setCapture(nullptr);
+
+        Message msg = compressMessages("Sync State", messages);
+        messagePublisher.send(msg, getIP());
+    }
+
+    void ConnectionHandler::syncState()
     {
         ViewerUI* ui = App::ui;
         PreferencesUI* prefs = ui->uiPrefs;
         auto view = ui->uiView;
         auto player = view->getTimelinePlayer();
 
-        // Send the protocol version as first thing.
-        pushMessage("Protocol Version", kProtocolVersion);
+        // The protocol version was sent when the client connected.
 
         int value;
 
@@ -73,7 +92,7 @@ namespace mrv
             auto annotationsPtr = player->getAllAnnotations();
 
             std::vector< draw::Annotation > annotations;
-            annotations.resize(annotationsPtr.size());
+            annotations.reserve(annotationsPtr.size());
             for (const auto& annotationPtr : annotationsPtr)
             {
                 annotations.push_back(*annotationPtr.get());
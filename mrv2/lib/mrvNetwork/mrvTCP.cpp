@@ -2,6 +2,7 @@
 // mrv2
 // Copyright Contributors to the mrv2 Project. All rights reserved.
 
+#include <algorithm>
 #include <iostream>
 
 #include <tlCore/Time.h>
@@ -19,6 +20,40 @@ namespace
 #else
     const std::string kHostsFile = "/etc/hosts";
 #endif
+
+    //! Coalesce a message into the last one of the send queue, if possible.
+    //! Only the last message is looked at, so the order of different
+    //! commands is kept.
+    bool coalesceMessage(mrv::Message& last, const mrv::Message& message)
+    {
+        const std::string lastCommand = last.value("command", std::string());
+        const std::string command = message.value("command", std::string());
+        if (command == "Add Shape Point")
+        {
+            // Batch the points of a stroke.  The batch keeps the other
+            // fields of the oldest message, like the time the benchmark
+            // stamps on it.
+            if (lastCommand == "Add Shape Point")
+            {
+                last["command"] = "Add Shape Points";
+                last["value"] = nlohmann::json::array(
+                    {last["value"], message["value"]});
+                return true;
+            }
+            if (lastCommand == "Add Shape Points")
+            {
+                last["value"].push_back(message["value"]);
+                return true;
+            }
+            return false;
+        }
+        if (mrv::isSuperseded(lastCommand, command))
+        {
+            last = message;
+            return true;
+        }
+        return false;
+    }
 } // namespace
 
 namespace mrv
@@ -61,6 +96,8 @@ namespace mrv
 
     std::mutex TCP::m_receiveMutex;
     std::list< Message > TCP::m_receive;
+    std::atomic<int> TCP::m_maxSendRate = 60;
+    thread_local std::vector< Message >* TCP::m_capture = nullptr;
 
     TCP::TCP() {}
 
@@ -80,7 +117,7 @@ namespace mrv
 
     void TCP::stop()
     {
-        m_running = false;
+        setStopped();
         for (auto t : m_threads)
         {
             if (t->joinable())
@@ -101,12 +138,83 @@ namespace mrv
 #endif
     }
 
+    void TCP::setStopped()
+    {
+        {
+            std::lock_guard lk(m_sendMutex);
+            m_running = false;
+        }
+        m_sendCondition.notify_all();
+    }
+
+    void TCP::setCapture(std::vector< Message >* messages)
+    {
+        m_capture = messages;
+    }
+
+    bool TCP::capture(const Message& message)
+    {
+        if (!m_capture)
+            return false;
+        m_capture->push_back(message);
+        return true;
+    }
+
+    void TCP::setMaxSendRate(int value)
+    {
+        m_maxSendRate = std::max(0, value);
+    }
+
+    int TCP::maxSendRate()
+    {
+        return m_maxSendRate;
+    }
+
+    void TCP::waitForSend()
+    {
+        std::unique_lock lk(m_sendMutex);
+        m_sendCondition.wait(
+            lk, [this] { return !m_send.empty() || !m_running; });
+
+        // Let the messages pushed meanwhile coalesce with the queued ones.
+        const int rate = m_maxSendRate;
+        if (rate > 0)
+        {
+            const auto next =
+                m_lastSend + std::chrono::microseconds(1000000 / rate);
+            m_sendCondition.wait_until(
+                lk, next, [this] { return !m_running; });
+        }
+    }
+
+    std::list< Message > TCP::takeSend()
+    {
+        std::list< Message > out;
+        std::lock_guard lk(m_sendMutex);
+        out.swap(m_send);
+        m_lastSend = std::chrono::steady_clock::now();
+        return out;
+    }
+
+    void TCP::waitForStop()
+    {
+        std::unique_lock lk(m_sendMutex);
+        m_sendCondition.wait(lk, [this] { return !m_running; });
+    }
+
     void TCP::pushMessage(const Message& message)
     {
+        if (capture(message))
+            return;
         if (m_lock)
             return;
-        std::lock_guard lk(m_sendMutex);
-        m_send.push_back(message);
+        {
+            std::lock_guard lk(m_sendMutex);
+            if (!m_send.empty() && coalesceMessage(m_send.back(), message))
+                return;
+            m_send.push_back(message);
+        }
+        m_sendCondition.notify_one();
     }
 
     void TCP::pushMessage(const std::string& command, bool value)
@@ -4,6 +4,9 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <list>
 #include <vector>
 #include <string>
@@ -63,6 +66,16 @@ namespace mrv
         void
         pushMessage(const std::string& command, const otime::TimeRange& value);
 
+        //! Maximum number of times per second the queued messages are
+        //! sent.  Messages pushed in between are coalesced.  0 means no
+        //! limit.
+        static void setMaxSendRate(int value);
+        static int maxSendRate();
+
+        //! Collect the messages pushed from the calling thread instead of
+        //! sending them.  Pass nullptr to stop collecting.
+        static void setCapture(std::vector< Message >* messages);
+
         void lock() { m_lock = true; }
         void unlock() { m_lock = false; }
         bool isLocked() { return m_lock == true; }
@@ -79,12 +92,29 @@ namespace mrv
 
         Message receiveMessage();
 
+        //! Add the message to the capture of the calling thread, if any.
+        //! Returns whether it was captured.
+        static bool capture(const Message& message);
+
+        //! Wait until there are messages to send or the connection is
+        //! stopped, without going over the maximum send rate.
+        void waitForSend();
+
+        //! Take the messages to send, emptying the queue.
+        std::list< Message > takeSend();
+
+        //! Wait until the connection is stopped.
+        void waitForStop();
+
+        //! Stop the threads' loops without joining them.
+        void setStopped();
+
     protected:
 #ifdef MRV2_NETWORK
         Poco::Net::StreamSocket m_socket;
         Poco::Net::SocketAddress m_address; // Example server/client address
 #endif
-        volatile bool m_running = false;
+        std::atomic<bool> m_running = false;
 
         bool m_lock = false;
 
@@ -92,7 +122,12 @@ namespace mrv
 
         std::vector< std::thread* > m_threads;
         std::mutex m_sendMutex;
+        std::condition_variable m_sendCondition;
         std::list< Message > m_send;
+        std::chrono::steady_clock::time_point m_lastSend;
+
+        static std::atomic<int> m_maxSendRate;
+        static thread_local std::vector< Message >* m_capture;
 
         static std::mutex m_receiveMutex;
         static std::list< Message > m_receive;
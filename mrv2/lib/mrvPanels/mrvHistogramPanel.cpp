@@ -110,6 +110,44 @@ namespace mrv
 
             cg->end();
 
+            cg = new Fl_Group(X, Y, W, 20);
+            cg->begin();
+            b = new Fl_Box(X, Y, 120, 20, _("Range"));
+            cW = new Widget< Fl_Choice >(X + b->w(), Y, W - b->w(), 20);
+            c = cW;
+            c->add(_("0 to 1"));
+            c->add(_("Linear HDR"));
+            c->add(_("Log2 Exposure"));
+            c->value(0);
+            cW->callback(
+                [=](auto o)
+                {
+                    Histogram::Range c = (Histogram::Range)o->value();
+                    _r->histogram->range(c);
+                    p.ui->uiView->redrawWindows();
+                });
+
+            cg->end();
+
+            cg = new Fl_Group(X, Y, W, 20);
+            cg->begin();
+            b = new Fl_Box(X, Y, 120, 20, _("Bins"));
+            cW = new Widget< Fl_Choice >(X + b->w(), Y, W - b->w(), 20);
+            c = cW;
+            c->add("256");
+            c->add("1024");
+            c->add("4096");
+            c->value(0);
+            cW->callback(
+                [=](auto o)
+                {
+                    const unsigned bins[] = {256, 1024, 4096};
+                    _r->histogram->bins(bins[o->value()]);
+                    p.ui->uiView->redrawWindows();
+                });
+
+            cg->end();
+
             // Create a square histogram
             r.histogram = new Histogram(X, Y, W, 270);
             r.histogram->main(p.ui);
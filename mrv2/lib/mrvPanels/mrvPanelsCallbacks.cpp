@@ -16,6 +16,7 @@ namespace mrv
         FilesPanel* filesPanel = nullptr;
         ComparePanel* comparePanel = nullptr;
         PlaylistPanel* playlistPanel = nullptr;
+        RenderQueuePanel* renderQueuePanel = nullptr;
         SettingsPanel* settingsPanel = nullptr;
         EnvironmentMapPanel* environmentMapPanel = nullptr;
         LogsPanel* logsPanel = nullptr;
@@ -25,6 +26,7 @@ namespace mrv
         ImageInfoPanel* imageInfoPanel = nullptr;
         HistogramPanel* histogramPanel = nullptr;
         VectorscopePanel* vectorscopePanel = nullptr;
+        WaveformPanel* waveformPanel = nullptr;
         Stereo3DPanel* stereo3DPanel = nullptr;
         BackgroundPanel* backgroundPanel = nullptr;
 #ifdef MRV2_PYBIND11
@@ -108,6 +110,8 @@ namespace mrv
                 compare_panel_cb(nullptr, ui);
             if (playlistPanel && playlistPanel->is_panel())
                 playlist_panel_cb(nullptr, ui);
+            if (renderQueuePanel && renderQueuePanel->is_panel())
+                render_queue_panel_cb(nullptr, ui);
             if (settingsPanel && settingsPanel->is_panel())
                 settings_panel_cb(nullptr, ui);
             if (logsPanel && logsPanel->is_panel())
@@ -128,6 +132,8 @@ namespace mrv
                 histogram_panel_cb(nullptr, ui);
             if (vectorscopePanel && vectorscopePanel->is_panel())
                 vectorscope_panel_cb(nullptr, ui);
+            if (waveformPanel && waveformPanel->is_panel())
+                waveform_panel_cb(nullptr, ui);
             if (stereo3DPanel && stereo3DPanel->is_panel())
                 stereo3D_panel_cb(nullptr, ui);
             if (backgroundPanel && backgroundPanel->is_panel())
@@ -157,6 +163,8 @@ namespace mrv
                 compare_panel_cb(nullptr, ui);
             if (playlistPanel && !playlistPanel->is_panel())
                 playlist_panel_cb(nullptr, ui);
+            if (renderQueuePanel && !renderQueuePanel->is_panel())
+                render_queue_panel_cb(nullptr, ui);
             if (settingsPanel && !settingsPanel->is_panel())
                 settings_panel_cb(nullptr, ui);
             if (logsPanel && !logsPanel->is_panel())
@@ -177,6 +185,8 @@ namespace mrv
                 histogram_panel_cb(nullptr, ui);
             if (vectorscopePanel && !vectorscopePanel->is_panel())
                 vectorscope_panel_cb(nullptr, ui);
+            if (waveformPanel && !waveformPanel->is_panel())
+                waveform_panel_cb(nullptr, ui);
             if (stereo3DPanel && !stereo3DPanel->is_panel())
                 stereo3D_panel_cb(nullptr, ui);
             if (backgroundPanel && !backgroundPanel->is_panel())
@@ -470,6 +480,41 @@ namespace mrv
             ui->uiMain->fill_menu(ui->uiMenuBar);
         }
 
+        void waveform_panel_cb(Fl_Widget* w, ViewerUI* ui)
+        {
+            bool send = ui->uiPrefs->SendUI->value();
+            if (send)
+            {
+                tcp->pushMessage(
+                    "Waveform Panel", static_cast<bool>(!waveformPanel));
+            }
+
+            if (waveformPanel)
+            {
+                delete waveformPanel;
+                waveformPanel = nullptr;
+                ui->uiMain->fill_menu(ui->uiMenuBar);
+                return;
+            }
+            waveformPanel = new WaveformPanel(ui);
+            ui->uiMain->fill_menu(ui->uiMenuBar);
+        }
+
+        void render_queue_panel_cb(Fl_Widget* w, ViewerUI* ui)
+        {
+            // The render queue runs on this machine only, so it is not
+            // sent to the network.
+            if (renderQueuePanel)
+            {
+                delete renderQueuePanel;
+                renderQueuePanel = nullptr;
+                ui->uiMain->fill_menu(ui->uiMenuBar);
+                return;
+            }
+            renderQueuePanel = new RenderQueuePanel(ui);
+            ui->uiMain->fill_menu(ui->uiMenuBar);
+        }
+
         void environment_map_panel_cb(Fl_Widget* w, ViewerUI* ui)
         {
             bool send = ui->uiPrefs->SendUI->value();
@@ -613,6 +658,8 @@ namespace mrv
                     "Histogram Panel", static_cast<bool>(histogramPanel));
                 tcp->pushMessage(
                     "Vectorscope Panel", static_cast<bool>(vectorscopePanel));
+                tcp->pushMessage(
+                    "Waveform Panel", static_cast<bool>(waveformPanel));
             }
         }
 
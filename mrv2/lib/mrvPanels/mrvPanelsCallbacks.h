@@ -21,9 +21,11 @@
 #include "mrvPanels/mrvImageInfoPanel.h"
 #include "mrvPanels/mrvLogsPanel.h"
 #include "mrvPanels/mrvPlaylistPanel.h"
+#include "mrvPanels/mrvRenderQueuePanel.h"
 #include "mrvPanels/mrvSettingsPanel.h"
 #include "mrvPanels/mrvStereo3DPanel.h"
 #include "mrvPanels/mrvVectorscopePanel.h"
+#include "mrvPanels/mrvWaveformPanel.h"
 
 #ifdef MRV2_NETWORK
 #    include "mrvPanels/mrvNetworkPanel.h"
@@ -53,6 +55,7 @@ namespace mrv
         extern FilesPanel* filesPanel;
         extern ComparePanel* comparePanel;
         extern PlaylistPanel* playlistPanel;
+        extern RenderQueuePanel* renderQueuePanel;
         extern SettingsPanel* settingsPanel;
         extern LogsPanel* logsPanel;
         extern DevicesPanel* devicesPanel;
@@ -61,6 +64,7 @@ namespace mrv
         extern ImageInfoPanel* imageInfoPanel;
         extern HistogramPanel* histogramPanel;
         extern VectorscopePanel* vectorscopePanel;
+        extern WaveformPanel* waveformPanel;
         extern EnvironmentMapPanel* environmentMapPanel;
         extern Stereo3DPanel* stereo3DPanel;
         extern BackgroundPanel* backgroundPanel;
@@ -115,9 +119,11 @@ namespace mrv
         void ndi_panel_cb(Fl_Widget* w, ViewerUI* ui);
         void python_panel_cb(Fl_Widget* w, ViewerUI* ui);
         void playlist_panel_cb(Fl_Widget* w, ViewerUI* ui);
+        void render_queue_panel_cb(Fl_Widget* w, ViewerUI* ui);
         void settings_panel_cb(Fl_Widget* w, ViewerUI* ui);
         void usd_panel_cb(Fl_Widget* w, ViewerUI* ui);
         void vectorscope_panel_cb(Fl_Widget* w, ViewerUI* ui);
+        void waveform_panel_cb(Fl_Widget* w, ViewerUI* ui);
         void stereo3D_panel_cb(Fl_Widget* w, ViewerUI* ui);
         ///@}
     } // namespace panel
@@ -0,0 +1,217 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// mrv2
+// Copyright Contributors to the mrv2 Project. All rights reserved.
+
+#include <algorithm>
+#include <cstdint>
+
+#include <FL/Fl_Button.H>
+
+#include <tlCore/Path.h>
+#include <tlCore/StringFormat.h>
+
+#include "mrvCore/mrvCPU.h"
+
+#include "mrvWidgets/mrvBrowser.h"
+#include "mrvWidgets/mrvFunctional.h"
+#include "mrvWidgets/mrvHorSlider.h"
+
+#include "mrvFl/mrvRenderQueue.h"
+
+#include "mrvPanels/mrvPanelsCallbacks.h"
+#include "mrvPanels/mrvRenderQueuePanel.h"
+
+#include "mrvApp/mrvApp.h"
+
+#include "mrViewer.h"
+
+namespace mrv
+{
+    namespace
+    {
+        const int kColumnWidths[] = {40, 200, 80, 80, 0};
+
+        const char* getStatusLabel(RenderJob::Status status)
+        {
+            switch (status)
+            {
+            case RenderJob::Status::Queued:
+                return _("Queued");
+            case RenderJob::Status::Running:
+                return _("Running");
+            case RenderJob::Status::Done:
+                return _("Done");
+            case RenderJob::Status::Failed:
+                return _("Failed");
+            case RenderJob::Status::Cancelled:
+                return _("Cancelled");
+            }
+            return "";
+        }
+
+        //! Called in the main thread when a job changes.
+        void render_queue_changed_cb(void*)
+        {
+            if (panel::renderQueuePanel)
+                panel::renderQueuePanel->update();
+        }
+    } // namespace
+
+    namespace panel
+    {
+        struct RenderQueuePanel::Private
+        {
+            Browser* browser = nullptr;
+        };
+
+        RenderQueuePanel::RenderQueuePanel(ViewerUI* ui) :
+            _r(new Private),
+            PanelWidget(ui)
+        {
+            add_group("Render Queue");
+
+            Fl_SVG_Image* svg = load_svg("Save.svg");
+            g->bind_image(svg);
+
+            g->callback(
+                [](Fl_Widget* w, void* d)
+                {
+                    ViewerUI* ui = static_cast< ViewerUI* >(d);
+                    delete renderQueuePanel;
+                    renderQueuePanel = nullptr;
+                    ui->uiMain->fill_menu(ui->uiMenuBar);
+                },
+                ui);
+
+            // The jobs change in the threads that run them.
+            ui->app->renderQueue()->setCallback(
+                [] { Fl::awake(render_queue_changed_cb, nullptr); });
+        }
+
+        RenderQueuePanel::~RenderQueuePanel()
+        {
+            TLRENDER_P();
+            p.ui->app->renderQueue()->setCallback(nullptr);
+        }
+
+        void RenderQueuePanel::add_controls()
+        {
+            TLRENDER_P();
+            MRV2_R();
+
+            Pack* pack = g->get_pack();
+            pack->spacing(5);
+
+            g->clear();
+            g->begin();
+
+            int X = g->x();
+            int Y = g->y();
+            int W = g->w() - 3;
+
+            auto queue = p.ui->app->renderQueue();
+
+            r.browser = new Browser(X, Y, W, 200);
+            r.browser->type(FL_HOLD_BROWSER);
+            r.browser->column_widths(kColumnWidths);
+            r.browser->showcolsep(1);
+            r.browser->textsize(12);
+
+            Fl_Group* bg = new Fl_Group(X, Y, W, 25);
+            bg->begin();
+
+            auto bW = new Widget< Fl_Button >(X, Y, W / 2, 25, _("Cancel"));
+            Fl_Button* b = bW;
+            b->tooltip(_("Cancel the selected job."));
+            bW->callback(
+                [=](auto o)
+                {
+                    const int line = _r->browser->value();
+                    if (line <= 0)
+                        return;
+                    const int id = static_cast<int>(
+                        reinterpret_cast<intptr_t>(_r->browser->data(line)));
+                    queue->cancel(id);
+                });
+
+            bW = new Widget< Fl_Button >(
+                X + W / 2, Y, W - W / 2, 25, _("Remove Finished"));
+            b = bW;
+            b->tooltip(_("Remove the jobs that are done, failed or were "
+                         "cancelled."));
+            bW->callback([=](auto o) { queue->clearFinished(); });
+
+            bg->end();
+
+            auto sV = new Widget< HorSlider >(X, Y, W, 20, _("Jobs:"));
+            HorSlider* s = sV;
+            s->range(1, std::max(1U, cpu_count()));
+            s->step(1);
+            s->tooltip(_("Maximum number of jobs that run at once."));
+            s->default_value(queue->maxJobs());
+            sV->callback(
+                [=](auto o)
+                { queue->setMaxJobs(static_cast<unsigned>(o->value())); });
+
+            g->resizable(g);
+
+            update();
+        }
+
+        void RenderQueuePanel::update()
+        {
+            TLRENDER_P();
+            MRV2_R();
+
+            int selected = -1;
+            if (r.browser->value() > 0)
+            {
+                selected = static_cast<int>(reinterpret_cast<intptr_t>(
+                    r.browser->data(r.browser->value())));
+            }
+
+            r.browser->clear();
+
+            for (const auto& job : p.ui->app->renderQueue()->jobs())
+            {
+                std::string progress;
+                if (job.status == RenderJob::Status::Running)
+                {
+                    progress = string::Format("{0}").arg(job.frame);
+                    if (time::isValid(job.inOutRange))
+                    {
+                        const int64_t start =
+                            job.inOutRange.start_time().to_frames();
+                        const int64_t duration =
+                            job.inOutRange.duration().to_frames();
+                        if (duration > 0)
+                        {
+                            const int64_t percent =
+                                (job.frame - start) * 100 / duration;
+                            progress = string::Format("{0} ({1}%)")
+                                           .arg(job.frame)
+                                           .arg(percent);
+                        }
+                    }
+                }
+
+                const file::Path path(job.output);
+                const std::string line =
+                    string::Format("{0}\t{1}\t{2}\t{3}\t{4}")
+                        .arg(job.id)
+                        .arg(path.get(-1, file::PathType::FileName))
+                        .arg(getStatusLabel(job.status))
+                        .arg(progress)
+                        .arg(job.message);
+                r.browser->add(
+                    line.c_str(),
+                    reinterpret_cast<void*>(static_cast<intptr_t>(job.id)));
+                if (job.id == selected)
+                    r.browser->value(r.browser->size());
+            }
+
+            r.browser->redraw();
+        }
+
+    } // namespace panel
+} // namespace mrv
@@ -0,0 +1,29 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// mrv2
+// Copyright Contributors to the mrv2 Project. All rights reserved.
+
+#pragma once
+
+#include "mrvPanelWidget.h"
+
+namespace mrv
+{
+    namespace panel
+    {
+        class RenderQueuePanel : public PanelWidget
+        {
+        public:
+            RenderQueuePanel(ViewerUI* ui);
+            ~RenderQueuePanel();
+
+            void add_controls() override;
+
+            //! Refresh the list of jobs.
+            void update();
+
+        private:
+            MRV2_PRIVATE();
+        };
+
+    } // namespace panel
+} // namespace mrv
@@ -12,6 +12,8 @@ namespace py = pybind11;
 
 #include <tlCore/StringFormat.h>
 
+#include "mrvCore/mrvThumbnailCache.h"
+
 #include "mrvPanels/mrvThumbnailPanel.h"
 
 #include "mrViewer.h"
@@ -49,34 +51,16 @@ namespace mrv
             auto i = thumbnailRequests.begin();
             while (i != thumbnailRequests.end())
             {
-                if (i->second.future.valid() &&
-                    i->second.future.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+                auto& request = i->second.request;
+                if (request.future.valid() &&
+                    request.future.wait_for(std::chrono::seconds(0)) ==
+                        std::future_status::ready)
                 {
-                    if (auto image = i->second.future.get())
+                    if (auto rgbImage = thumbnail::storeImage(
+                            i->second.cacheKey, request.future.get()))
                     {
-                        if (image::PixelType::RGBA_U8 == image->getPixelType())
-                        {
-                            const int w = image->getWidth();
-                            const int h = image->getHeight();
-                            const int depth = 4;
-
-                            uint8_t* pixelData = new uint8_t[w * h * depth];
-
-                            auto rgbImage = new Fl_RGB_Image(
-                                pixelData, w, h, depth);
-                            rgbImage->alloc_array = true;
-
-                            uint8_t* d = pixelData;
-                            const uint8_t* s = image->getData();
-                            for (int y = 0; y < h; ++y)
-                            {
-                                memcpy(
-                                    d + (h - 1 - y) * w * 4, s + y * w * 4,
-                                    w * 4);
-                            }
-                            i->first->bind_image(rgbImage);
-                            i->first->redraw();
-                        }
+                        i->first->bind_image(rgbImage);
+                        i->first->redraw();
                     }
                     i = thumbnailRequests.erase(i);
                 }
@@ -115,6 +99,28 @@ namespace mrv
             {
                 const auto context = App::app->getContext();
                 auto thumbnailSystem = context->getSystem<ui::ThumbnailSystem>();
+
+                auto it = thumbnailRequests.find(widget);
+                if (it != thumbnailRequests.end())
+                {
+                    const auto& request = it->second.request;
+                    thumbnailSystem->cancelRequests( { request.id } );
+                    thumbnailRequests.erase(it);
+                }
+
+                // The key uses the requested time, so we can look up the
+                // cache without opening the timeline.
+                const std::string& cacheKey =
+                    thumbnail::cacheKey(path, size.h, currentTime, layerId);
+                if (!_clearCache)
+                {
+                    if (auto rgbImage = thumbnail::cachedImage(cacheKey))
+                    {
+                        widget->bind_image(rgbImage);
+                        widget->redraw();
+                        return;
+                    }
+                }
                 
 #ifdef MRV2_PYBIND11
                 py::gil_scoped_release release;
@@ -136,14 +142,6 @@ namespace mrv
                         time = endTime;
                 }
 
-                auto it = thumbnailRequests.find(widget);
-                if (it != thumbnailRequests.end())
-                {
-                    const auto& request = it->second;
-                    thumbnailSystem->cancelRequests( { request.id } );
-                    thumbnailRequests.erase(it);
-                }
-
                 io::Options options;
                 if (_clearCache)
                 {
@@ -153,8 +151,10 @@ namespace mrv
 
                 options["Layer"] = string::Format("{0}").arg(layerId);
                 
-                thumbnailRequests[widget] =
+                auto& data = thumbnailRequests[widget];
+                data.request =
                     thumbnailSystem->getThumbnail(path, size.h, time, options);
+                data.cacheKey = cacheKey;
             }
             catch (const std::exception& e)
             {
@@ -175,7 +175,7 @@ namespace mrv
             std::vector<uint64_t> ids;
             for (const auto& i : thumbnailRequests)
             {
-                const auto& request = i.second;
+                const auto& request = i.second.request;
                 ids.push_back(request.id);
             }
             thumbnailSystem->cancelRequests(ids);
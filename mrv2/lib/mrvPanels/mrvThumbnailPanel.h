@@ -52,7 +52,14 @@ namespace mrv
             //! Whether to clear the cache for the thumbnails.
             bool _clearCache = false;
 
-            std::map<Fl_Widget*, ui::ThumbnailRequest> thumbnailRequests;
+            struct ThumbnailData
+            {
+                ui::ThumbnailRequest request;
+
+                //! Key of the persistent thumbnail cache.
+                std::string cacheKey;
+            };
+            std::map<Fl_Widget*, ThumbnailData> thumbnailRequests;
         };
 
     } // namespace panel
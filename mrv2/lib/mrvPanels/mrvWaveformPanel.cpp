@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// mrv2
+// Copyright Contributors to the mrv2 Project. All rights reserved.
+
+#include "FL/Fl_Choice.H"
+
+#include "mrvWidgets/mrvFunctional.h"
+#include "mrvWidgets/mrvWaveform.h"
+
+#include "mrvFl/mrvColorAreaInfo.h"
+
+#include "mrvGL/mrvGLViewport.h"
+
+#include "mrvPanels/mrvPanelsCallbacks.h"
+#include "mrvPanels/mrvWaveformPanel.h"
+
+#include "mrViewer.h"
+
+namespace mrv
+{
+    namespace panel
+    {
+        struct WaveformPanel::Private
+        {
+            Waveform* waveform = nullptr;
+        };
+
+        WaveformPanel::WaveformPanel(ViewerUI* ui) :
+            _r(new Private),
+            PanelWidget(ui)
+        {
+            add_group("Waveform");
+
+            Fl_SVG_Image* svg = load_svg("Waveform.svg");
+            g->bind_image(svg);
+
+            g->callback(
+                [](Fl_Widget* w, void* d)
+                {
+                    ViewerUI* ui = static_cast< ViewerUI* >(d);
+                    delete waveformPanel;
+                    waveformPanel = nullptr;
+                    ui->uiMain->fill_menu(ui->uiMenuBar);
+                },
+                ui);
+        }
+
+        WaveformPanel::~WaveformPanel() {}
+
+        void WaveformPanel::add_controls()
+        {
+            TLRENDER_P();
+            MRV2_R();
+
+            Pack* pack = g->get_pack();
+            pack->spacing(5);
+
+            g->clear();
+            g->begin();
+
+            int X = g->x();
+            int Y = g->y();
+            int W = g->w() - 3;
+            int H = g->h();
+
+            Fl_Group* cg;
+            Fl_Box* b;
+            Fl_Choice* c;
+
+            cg = new Fl_Group(X, Y, W, 20);
+            cg->begin();
+            b = new Fl_Box(X, Y, 120, 20, _("Mode"));
+            auto cW = new Widget< Fl_Choice >(X + b->w(), Y, W - b->w(), 20);
+            c = cW;
+            c->add(_("Lumma"));
+            c->add(_("RGB Parade"));
+            c->add(_("RGB Overlay"));
+            c->value(0);
+            cW->callback(
+                [=](auto o)
+                {
+                    Waveform::Mode c = (Waveform::Mode)o->value();
+                    _r->waveform->mode(c);
+                    p.ui->uiView->redrawWindows();
+                });
+            cg->end();
+
+            r.waveform = new Waveform(X, Y, W, 256);
+            r.waveform->main(p.ui);
+
+            g->resizable(g);
+        }
+
+        void WaveformPanel::update(const area::Info& info)
+        {
+            _r->waveform->update(info);
+        }
+
+    } // namespace panel
+} // namespace mrv
@@ -101,6 +101,9 @@ namespace mrv
         menu->add(
             _("File/Save/Movie or Sequence"), kSaveSequence.hotkey(),
             (Fl_Callback*)save_movie_cb, ui, mode);
+        menu->add(
+            _("File/Save/Movie or Sequence in Background"), 0,
+            (Fl_Callback*)save_movie_in_background_cb, ui, mode);
         menu->add(
             _("File/Save/Single Frame"), kSaveImage.hotkey(),
             (Fl_Callback*)save_single_frame_cb, ui, mode | FL_MENU_DIVIDER);
@@ -441,6 +444,20 @@ namespace mrv
                 else
                     item->clear();
             }
+            else if (tmp == _("Waveform"))
+            {
+                if (waveformPanel)
+                    item->set();
+                else
+                    item->clear();
+            }
+            else if (tmp == _("Render Queue"))
+            {
+                if (renderQueuePanel)
+                    item->set();
+                else
+                    item->clear();
+            }
             else if (tmp == _("Compare"))
             {
                 if (comparePanel)
@@ -2,11 +2,17 @@
 // mrv2
 // Copyright Contributors to the mrv2 Project. All rights reserved.
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 #include <FL/Enumerations.H>
 #include <FL/fl_draw.H>
 
 #include <Imath/ImathFun.h>
 
+#include "mrvCore/mrvParallel.h"
+
 #include "mrvWidgets/mrvHistogram.h"
 
 #include "mrViewer.h"
@@ -19,6 +25,10 @@ namespace mrv
         Fl_Box(X, Y, W, H, L),
         _channel(kRGB),
         _histtype(kLog),
+        _range(kLDR),
+        _bins(256),
+        minValue(0.F),
+        maxValue(1.F),
         maxLumma(0),
         maxColor(0)
     {
@@ -33,67 +43,177 @@ namespace mrv
             draw_pixels();
     }
 
-    void Histogram::count_pixel(const uint8_t* rgb) noexcept
+    namespace
     {
-        uint8_t r = rgb[0];
-        uint8_t g = rgb[1];
-        uint8_t b = rgb[2];
-
-        ++red[r];
-        if (red[r] > maxColor)
-            maxColor = red[r];
-
-        ++green[g];
-        if (green[g] > maxColor)
-            maxColor = green[g];
-
-        ++blue[b];
-        if (blue[b] > maxColor)
-            maxColor = blue[b];
-
-        unsigned int lum = unsigned(r * 0.30f + g * 0.59f + b * 0.11f);
-        lumma[lum] += 1;
-        if (lumma[lum] > maxLumma)
-            maxLumma = lumma[lum];
-    }
+        //! Minimum number of rows binned by each thread.
+        const int kMinRows = 16;
+
+        //! Lowest value considered in log2 range, to avoid log2(0).
+        const float kMinLog2Value = 1.0F / 65536.F;
+
+        inline float to_lumma(const image::Color4f& p) noexcept
+        {
+            return p.r * 0.30f + p.g * 0.59f + p.b * 0.11f;
+        }
+    } // namespace
 
     void Histogram::update(const area::Info& info)
     {
         Viewport* view = ui->uiView;
-        const auto& renderSize = view->getRenderSize();
         const image::Color4f* image = view->image();
+        const math::Box2i& imageBox = view->imageBox();
 
+        const unsigned bins = std::max(_bins, 2U);
         maxColor = maxLumma = 0;
-        memset(red, 0, sizeof(float) * 256);
-        memset(green, 0, sizeof(float) * 256);
-        memset(blue, 0, sizeof(float) * 256);
-        memset(lumma, 0, sizeof(float) * 256);
+        red.assign(bins, 0.F);
+        green.assign(bins, 0.F);
+        blue.assign(bins, 0.F);
+        lumma.assign(bins, 0.F);
+
+        if (!image)
+        {
+            redraw();
+            return;
+        }
 
-        if (!image || !renderSize.isValid())
+        // The view only reads back the selected area, so we index the
+        // image relative to its box.
+        const math::Box2i box = info.box.intersect(imageBox);
+        if (box.min.x > box.max.x || box.min.y > box.max.y)
         {
             redraw();
             return;
         }
 
-        int xmin = info.box.min.x;
-        int ymin = info.box.min.y;
-        int xmax = info.box.max.x;
-        int ymax = info.box.max.y;
+        const size_t stride = imageBox.w();
+        auto getRow = [=](int Y)
+        { return image + (Y - imageBox.min.y) * stride - imageBox.min.x; };
+
+        // For HDR ranges, find the peak (and lowest positive) value of
+        // the area first.
+        minValue = 0.F;
+        maxValue = 1.F;
+        if (_range != kLDR)
+        {
+            const int chunks =
+                parallel_chunks(box.max.y - box.min.y + 1, kMinRows);
+            std::vector<float> peaks(chunks, 0.F);
+            std::vector<float> lows(chunks, std::numeric_limits<float>::max());
+            parallel_for(
+                box.min.y, box.max.y + 1,
+                [&](int chunk, int y0, int y1)
+                {
+                    float peak = 0.F;
+                    float low = std::numeric_limits<float>::max();
+                    for (int Y = y0; Y < y1; ++Y)
+                    {
+                        const image::Color4f* row = getRow(Y);
+                        for (int X = box.min.x; X <= box.max.x; ++X)
+                        {
+                            const auto& pixel = row[X];
+                            // Skip inf and NaN pixels, common in HDR EXRs.
+                            if (!std::isfinite(pixel.r) ||
+                                !std::isfinite(pixel.g) ||
+                                !std::isfinite(pixel.b))
+                                continue;
+                            const float m =
+                                std::max(pixel.r, std::max(pixel.g, pixel.b));
+                            const float l =
+                                std::min(pixel.r, std::min(pixel.g, pixel.b));
+                            peak = std::max(peak, m);
+                            if (l > kMinLog2Value)
+                                low = std::min(low, l);
+                        }
+                    }
+                    peaks[chunk] = peak;
+                    lows[chunk] = low;
+                },
+                kMinRows);
+
+            const float peak = *std::max_element(peaks.begin(), peaks.end());
+            float low = *std::min_element(lows.begin(), lows.end());
+            if (_range == kLinearHDR)
+            {
+                maxValue = std::max(1.F, peak);
+            }
+            else
+            {
+                if (low > peak)
+                    low = kMinLog2Value;
+                minValue = std::floor(std::log2(std::max(low, kMinLog2Value)));
+                maxValue =
+                    std::ceil(std::log2(std::max(peak, kMinLog2Value * 2)));
+                if (maxValue <= minValue)
+                    maxValue = minValue + 1.F;
+            }
+        }
 
-        image::Color4f* pixel;
-        uint8_t rgb[3];
-        for (int Y = ymin; Y <= ymax; ++Y)
+        // Bin with one histogram per thread and merge them at the end.
+        const bool log2Range = _range == kLog2;
+        const float lo = minValue;
+        const float scale = bins / (maxValue - minValue);
+        const int last = bins - 1;
+        auto toBin = [=](float v)
+        {
+            if (log2Range)
+                v = std::log2(std::max(v, kMinLog2Value));
+            // Clamp before the cast, as large values overflow an int.
+            return static_cast<int>(
+                std::clamp((v - lo) * scale, 0.F, static_cast<float>(last)));
+        };
+
+        const int chunks = parallel_chunks(box.max.y - box.min.y + 1, kMinRows);
+        std::vector<uint32_t> counts(size_t(chunks) * 4 * bins, 0);
+        parallel_for(
+            box.min.y, box.max.y + 1,
+            [&](int chunk, int y0, int y1)
+            {
+                uint32_t* r = counts.data() + size_t(chunk) * 4 * bins;
+                uint32_t* g = r + bins;
+                uint32_t* b = g + bins;
+                uint32_t* l = b + bins;
+                for (int Y = y0; Y < y1; ++Y)
+                {
+                    const image::Color4f* row = getRow(Y);
+                    for (int X = box.min.x; X <= box.max.x; ++X)
+                    {
+                        // Pixels are stored in BGRA order.
+                        const auto& pixel = row[X];
+                        const image::Color4f rgb(pixel.b, pixel.g, pixel.r);
+                        if (!std::isfinite(rgb.r) || !std::isfinite(rgb.g) ||
+                            !std::isfinite(rgb.b))
+                            continue;
+                        ++r[toBin(rgb.r)];
+                        ++g[toBin(rgb.g)];
+                        ++b[toBin(rgb.b)];
+                        ++l[toBin(to_lumma(rgb))];
+                    }
+                }
+            },
+            kMinRows);
+
+        for (int chunk = 0; chunk < chunks; ++chunk)
         {
-            for (int X = xmin; X <= xmax; ++X)
+            const uint32_t* r = counts.data() + size_t(chunk) * 4 * bins;
+            const uint32_t* g = r + bins;
+            const uint32_t* b = g + bins;
+            const uint32_t* l = b + bins;
+            for (unsigned i = 0; i < bins; ++i)
             {
-                const auto& pixel = image[X + Y * renderSize.w];
-                rgb[0] = (uint8_t)Imath::clamp(pixel.b * 255.0f, 0.f, 255.f);
-                rgb[1] = (uint8_t)Imath::clamp(pixel.g * 255.0f, 0.f, 255.f);
-                rgb[2] = (uint8_t)Imath::clamp(pixel.r * 255.0f, 0.f, 255.f);
-                count_pixel(rgb);
+                red[i] += r[i];
+                green[i] += g[i];
+                blue[i] += b[i];
+                lumma[i] += l[i];
             }
         }
 
+        for (unsigned i = 0; i < bins; ++i)
+        {
+            maxColor = std::max(
+                maxColor, std::max(red[i], std::max(green[i], blue[i])));
+            maxLumma = std::max(maxLumma, lumma[i]);
+        }
+
         redraw();
     }
 
@@ -111,13 +231,30 @@ namespace mrv
         }
     }
 
+    float Histogram::bin_value(
+        const std::vector<float>& v, int i, int W) const noexcept
+    {
+        const size_t bins = v.size();
+        if (bins == 0 || W <= 0)
+            return 0.F;
+
+        size_t start = size_t(((float)i / (float)(W + 1)) * bins);
+        size_t end = size_t(((float)(i + 1) / (float)(W + 1)) * bins);
+        start = std::min(start, bins - 1);
+        end = std::max(end, start + 1);
+        end = std::min(end, bins);
+        float out = 0.F;
+        for (size_t j = start; j < end; ++j)
+            out = std::max(out, v[j]);
+        return out;
+    }
+
     void Histogram::draw_pixels() const noexcept
     {
 
         // Draw the pixel info
         int W = w() - 8 - 3;
         int H = h() - 8;
-        int idx;
         float v;
 
         float maxC, maxL;
@@ -147,11 +284,10 @@ namespace mrv
 
             int maxY = y();
 
-            idx = int(((float)i / (float)W) * 255);
             if (_channel == kLumma)
             {
                 fl_color(255, 255, 255);
-                v = histogram_scale(lumma[idx], maxL);
+                v = histogram_scale(bin_value(lumma, i, W), maxL);
                 int Y = Y2 - int(H * v);
                 fl_line(X, Y, X, Y2);
             }
@@ -159,7 +295,7 @@ namespace mrv
             if (_channel == kRed || _channel == kRGB)
             {
                 fl_color(255, 0, 0);
-                v = histogram_scale(red[idx], maxC);
+                v = histogram_scale(bin_value(red, i, W), maxC);
                 int Y = Y2 - int(H * v);
                 if (Y > maxY)
                     maxY = Y;
@@ -169,7 +305,7 @@ namespace mrv
             if (_channel == kGreen || _channel == kRGB)
             {
                 fl_color(0, 255, 0);
-                v = histogram_scale(green[idx], maxC);
+                v = histogram_scale(bin_value(green, i, W), maxC);
                 int Y = Y2 - int(H * v);
                 if (Y > maxY)
                     maxY = Y;
@@ -179,7 +315,7 @@ namespace mrv
             if (_channel == kBlue || _channel == kRGB)
             {
                 fl_color(0, 0, 255);
-                v = histogram_scale(blue[idx], maxC);
+                v = histogram_scale(bin_value(blue, i, W), maxC);
                 int Y = Y2 - int(H * v);
                 if (Y > maxY)
                     maxY = Y;
@@ -194,6 +330,19 @@ namespace mrv
             }
         }
 
+        // Mark where 1.0 falls in HDR ranges.
+        if (_range != kLDR)
+        {
+            const float one = _range == kLog2 ? 0.F : 1.F;
+            if (one > minValue && one < maxValue)
+            {
+                int X = x() + int(W * (one - minValue) / (maxValue - minValue));
+                fl_line_style(FL_DASH, 1);
+                fl_color(255, 255, 0);
+                fl_line(X, y(), X, Y2);
+            }
+        }
+
         fl_line_style(0);
     }
 
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include <FL/Fl_Box.H>
 
 #include <tlCore/Util.h>
@@ -33,6 +35,13 @@ namespace mrv
             kLumma,
         };
 
+        //! Range of values binned.
+        enum Range {
+            kLDR,      //!< 0 to 1, values outside are clamped.
+            kLinearHDR, //!< 0 to the peak value of the area.
+            kLog2,     //!< Exposure stops (log2) of the values in the area.
+        };
+
     public:
         Histogram(int X, int Y, int W, int H, const char* L = 0);
 
@@ -50,6 +59,14 @@ namespace mrv
         };
         Type histogram_type() const { return _histtype; };
 
+        //! Set the range of values binned.  Takes effect on next update.
+        void range(Range r) { _range = r; }
+        Range range() const { return _range; }
+
+        //! Set the number of bins.  Takes effect on next update.
+        void bins(unsigned b) { _bins = b; }
+        unsigned bins() const { return _bins; }
+
         virtual void draw() override;
 
         void update(const area::Info& info);
@@ -60,21 +77,30 @@ namespace mrv
     protected:
         void draw_pixels() const noexcept;
 
-        void count_pixel(const uint8_t* rgb) noexcept;
-
         inline float histogram_scale(float val, float maxVal) const noexcept;
 
+        //! Return the maximum of the bins that fall in column i of W.
+        float
+        bin_value(const std::vector<float>& v, int i, int W) const noexcept;
+
         Channel _channel;
         Type _histtype;
+        Range _range;
+        unsigned _bins;
+
+        //! Values of the first and last bin edges.  For kLog2 they are
+        //! in stops.
+        float minValue;
+        float maxValue;
 
         float maxLumma;
-        float lumma[256];
+        std::vector<float> lumma;
 
         float maxColor;
 
-        float red[256];
-        float green[256];
-        float blue[256];
+        std::vector<float> red;
+        std::vector<float> green;
+        std::vector<float> blue;
 
         ViewerUI* ui;
     };
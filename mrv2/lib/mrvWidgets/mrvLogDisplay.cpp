@@ -65,13 +65,7 @@ namespace mrv
     {
         LogData* d = (LogData*)v;
 
-        LogDisplay* log = d->log;
-        log->style_buffer()->append(d->style);
-
-        Fl_Text_Buffer* buffer = log->buffer();
-        buffer->append(d->message);
-        log->scroll(buffer->length(), 0);
-        log->trim();
+        d->log->append(d->message, d->style);
 
         delete d;
     }
@@ -106,24 +100,49 @@ namespace mrv
     {
         mStyleBuffer->text("");
         mBuffer->text("");
+        lineBytes.clear();
+        partialLineBytes = 0;
         redraw();
     }
 
     void LogDisplay::trim()
     {
-        if (maxLines == 0)
+        if (maxLines == 0 || lineBytes.size() < maxLines)
             return;
 
-        int lines = mBuffer->count_lines(0, mBuffer->length());
-        if (lines < maxLines)
+        int endByte = 0;
+        while (lineBytes.size() > maxLines)
+        {
+            endByte += lineBytes.front();
+            lineBytes.pop_front();
+        }
+        if (endByte == 0)
             return;
-        int last_line = lines - maxLines;
-        int endByte = mBuffer->skip_lines(0, last_line);
         mStyleBuffer->remove(0, endByte);
         mBuffer->remove(0, endByte);
         redraw();
     }
 
+    void LogDisplay::append(const char* text, const char* style)
+    {
+        style_buffer()->append(style);
+        buffer()->append(text);
+
+        for (const char* c = text; *c; ++c)
+        {
+            ++partialLineBytes;
+            if (*c == '\n')
+            {
+                lineBytes.push_back(partialLineBytes);
+                partialLineBytes = 0;
+            }
+        }
+
+        scroll(buffer()->length(), 0);
+        trim();
+        redraw();
+    }
+
     inline void LogDisplay::print(const char* x, const char style)
     {
         if (App::ui)
@@ -141,12 +160,8 @@ namespace mrv
         }
         else
         {
-            style_buffer()->append(data->style);
-            buffer()->append(data->message);
-            scroll(buffer()->length(), 0);
+            append(data->message, data->style);
             delete data;
-            trim();
-            redraw();
         }
     }
 
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <deque>
 #include <thread>
 
 #include <FL/Fl_Text_Display.H>
@@ -36,6 +37,10 @@ namespace mrv
 
         void print(const char* x, const char style);
 
+        //! Append text with its style buffer, which has one style character
+        //! per byte of text.  Must be called from the main thread.
+        void append(const char* text, const char* style);
+
         void info(const char* x);
         void output(const char* x);
         void warning(const char* x);
@@ -48,6 +53,11 @@ namespace mrv
     protected:
         std::thread::id main_thread;
         unsigned maxLines;
+
+        //! Byte length of each complete line in the buffer, so trimming
+        //! does not need to count the lines of the whole buffer.
+        std::deque<int> lineBytes;
+        int partialLineBytes = 0;
     };
 
     extern LogDisplay* uiLogDisplay;
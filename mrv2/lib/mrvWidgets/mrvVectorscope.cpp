@@ -2,14 +2,15 @@
 // mrv2
 // Copyright Contributors to the mrv2 Project. All rights reserved.
 
+#include <cmath>
+
 #include <FL/Enumerations.H>
 #include <FL/fl_draw.H>
 
-#include <Imath/ImathMatrix.h>
-#include <Imath/ImathVec.h>
-
 #include <tlCore/Math.h>
 
+#include "mrvCore/mrvParallel.h"
+
 #include "mrvWidgets/mrvVectorscope.h"
 
 #include "mrViewer.h"
@@ -17,12 +18,20 @@
 
 namespace mrv
 {
+    namespace
+    {
+        //! Minimum number of rows accumulated by each thread.
+        const int kMinRows = 16;
+    } // namespace
+
     struct Vectorscope::Private
     {
         int diameter;
-        math::Size2i renderSize;
-        math::Box2i box;
-        image::Color4f* image = nullptr;
+
+        //! Density plot of the last update, as RGB pixels of size x size.
+        int size = 0;
+        std::vector<uint8_t> pixels;
+
         ViewerUI* ui;
     };
 
@@ -55,11 +64,8 @@ namespace mrv
         if (w() < p.diameter)
             p.diameter = w();
 
+        draw_pixels();
         draw_grid();
-        if (p.image)
-        {
-            draw_pixels();
-        }
     }
 
     void Vectorscope::update(const area::Info& info)
@@ -67,121 +73,138 @@ namespace mrv
         TLRENDER_P();
 
         Viewport* view = p.ui->uiView;
-        const auto& newRenderSize = view->getRenderSize();
         const image::Color4f* viewImage = view->image();
-        p.box = info.box;
+        const math::Box2i& imageBox = view->imageBox();
+
+        int size = h();
+        if (w() < size)
+            size = w();
 
-        if (!viewImage || !newRenderSize.isValid())
+        // Only the selected area that the view read back is plotted.
+        const math::Box2i box = info.box.intersect(imageBox);
+        if (!viewImage || size <= 0 || box.min.x > box.max.x ||
+            box.min.y > box.max.y)
         {
+            p.size = 0;
+            p.pixels.clear();
             redraw();
             return;
         }
 
-        const size_t dataSize =
-            newRenderSize.w * newRenderSize.h * sizeof(image::Color4f);
-        if (newRenderSize != p.renderSize)
+        // Accumulate hits and colors of each cell of the plot, with one
+        // grid per thread that are merged at the end.
+        struct Cell
+        {
+            uint32_t count;
+            float r, g, b;
+        };
+        const size_t cells = size_t(size) * size;
+        const int chunks = parallel_chunks(box.max.y - box.min.y + 1, kMinRows);
+        std::vector<Cell> grids(cells * chunks, Cell{0, 0.F, 0.F, 0.F});
+
+        const size_t stride = imageBox.w();
+        const float center = size / 2.F;
+        parallel_for(
+            box.min.y, box.max.y + 1,
+            [&](int chunk, int y0, int y1)
+            {
+                Cell* grid = grids.data() + cells * chunk;
+                for (int Y = y0; Y < y1; ++Y)
+                {
+                    const image::Color4f* row = viewImage +
+                                                (Y - imageBox.min.y) * stride -
+                                                imageBox.min.x;
+                    for (int X = box.min.x; X <= box.max.x; ++X)
+                    {
+                        image::Color4f color = row[X];
+                        color.r = std::clamp(color.r, 0.F, 1.F);
+                        color.g = std::clamp(color.g, 0.F, 1.F);
+                        color.b = std::clamp(color.b, 0.F, 1.F);
+
+                        // The graticule is laid out for the hue of the
+                        // pixels as stored (BGRA).
+                        const image::Color4f hsv = color::rgb::to_hsv(color);
+
+                        // Rotate based on hue, scale based on saturation.
+                        const float angle =
+                            math::deg2rad(-15.0 - hsv.r * 360.0f);
+                        const float radius = hsv.g * 0.375f * size;
+                        const int px = int(center - radius * std::sin(angle));
+                        const int py = int(center + radius * std::cos(angle));
+                        if (px < 0 || py < 0 || px >= size || py >= size)
+                            continue;
+
+                        Cell& cell = grid[size_t(py) * size + px];
+                        ++cell.count;
+                        cell.r += color.b;
+                        cell.g += color.g;
+                        cell.b += color.r;
+                    }
+                }
+            },
+            kMinRows);
+
+        for (int chunk = 1; chunk < chunks; ++chunk)
         {
-            p.renderSize = newRenderSize;
-            free(p.image);
-            p.image = (image::Color4f*)malloc(dataSize);
+            const Cell* grid = grids.data() + cells * chunk;
+            for (size_t i = 0; i < cells; ++i)
+            {
+                grids[i].count += grid[i].count;
+                grids[i].r += grid[i].r;
+                grids[i].g += grid[i].g;
+                grids[i].b += grid[i].b;
+            }
         }
-        memcpy(p.image, viewImage, dataSize);
-
-        redraw();
-    }
-
-    void Vectorscope::draw_pixel(image::Color4f& color) const noexcept
-    {
-        TLRENDER_P();
-
-        using namespace Imath;
-
-        if (color.r < 0)
-            color.r = 0;
-        if (color.g < 0)
-            color.g = 0;
-        if (color.b < 0)
-            color.b = 0;
-
-        if (color.r > 1.F)
-            color.r = 1.F;
-        if (color.g > 1.F)
-            color.g = 1.F;
-        if (color.b > 1.F)
-            color.b = 1.F;
-
-        // We swap R and B channels
-        uint8_t r = color.b * 255.F;
-        uint8_t g = color.g * 255.F;
-        uint8_t b = color.r * 255.F;
 
-        image::Color4f hsv = color::rgb::to_hsv(color);
+        uint32_t maxCount = 0;
+        for (size_t i = 0; i < cells; ++i)
+            maxCount = std::max(maxCount, grids[i].count);
 
-        int W = p.diameter / 2;
-        int H = p.diameter / 2;
-
-#ifdef __linux__
-        M44f m;
-
-        // Translate to center
-        m.translate(V3f(x() + W, y() + H, 0));
-
-        // Rotate base on hue
-        m.rotate(V3f(0, 0, math::deg2rad(-15.0 - hsv.r * 360.0f)));
-
-        // Scale based on saturation
-        float s = hsv.g * 0.375f;
-        m.scale(V3f(s, s, 1));
-
-        V3f pos(0, p.diameter, 0);
-
-        pos = pos * m;
-
-        fl_rectf(pos.x, pos.y, 1, 1, r, g, b);
-#else
-        fl_push_matrix();
-
-        // Position at center of circle
-        fl_translate(x() + W, y() + H);
-
-        // Rotate base on hue
-        fl_rotate(15.0 + hsv.r * 360.0f);
-
-        // Scale based on saturation
-        float s = hsv.g * 0.375f;
-        fl_scale(s, s);
-
-        fl_color(r, g, b);
-        fl_begin_points();
-        fl_vertex(0, p.diameter);
-        fl_end_points();
+        // Map the hits logarithmically to intensity, tinted with the
+        // average color of the pixels of each cell.
+        p.size = size;
+        p.pixels.assign(cells * 3, 0);
+        if (maxCount > 0)
+        {
+            const float logMax = std::log1p(float(maxCount));
+            for (size_t i = 0; i < cells; ++i)
+            {
+                const Cell& cell = grids[i];
+                if (cell.count == 0)
+                    continue;
+
+                const float intensity =
+                    0.25F + 0.75F * std::log1p(float(cell.count)) / logMax;
+                float r = cell.r, g = cell.g, b = cell.b;
+                const float m = std::max(r, std::max(g, b));
+                if (m > 0.F)
+                {
+                    r /= m;
+                    g /= m;
+                    b /= m;
+                }
+                else
+                {
+                    r = g = b = 1.F;
+                }
+                uint8_t* out = p.pixels.data() + i * 3;
+                out[0] = uint8_t(r * intensity * 255.F);
+                out[1] = uint8_t(g * intensity * 255.F);
+                out[2] = uint8_t(b * intensity * 255.F);
+            }
+        }
 
-        fl_pop_matrix();
-#endif
+        redraw();
     }
 
     void Vectorscope::draw_pixels() const noexcept
     {
         TLRENDER_P();
 
-        if (!p.box.isValid())
+        if (p.size <= 0 || p.pixels.empty())
             return;
 
-        int stepX = (p.box.max.x - p.box.min.x) / p.diameter;
-        int stepY = (p.box.max.y - p.box.min.y) / p.diameter;
-        if (stepX < 1)
-            stepX = 1;
-        if (stepY < 1)
-            stepY = 1;
-
-        for (int Y = p.box.min.y; Y < p.box.max.y; Y += stepY)
-        {
-            for (int X = p.box.min.x; X < p.box.max.x; X += stepX)
-            {
-                image::Color4f& color = p.image[X + Y * p.renderSize.w];
-                draw_pixel(color);
-            }
-        }
+        fl_draw_image(p.pixels.data(), x(), y(), p.size, p.size, 3);
     }
 
     void Vectorscope::draw_grid() noexcept
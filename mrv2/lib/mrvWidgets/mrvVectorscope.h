@@ -33,7 +33,6 @@ namespace mrv
 
     protected:
         void draw_grid() noexcept;
-        void draw_pixel(image::Color4f& rgb) const noexcept;
         void draw_pixels() const noexcept;
 
         TLRENDER_PRIVATE();
@@ -0,0 +1,269 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// mrv2
+// Copyright Contributors to the mrv2 Project. All rights reserved.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include <FL/Enumerations.H>
+#include <FL/fl_draw.H>
+
+#include "mrvCore/mrvParallel.h"
+
+#include "mrvWidgets/mrvWaveform.h"
+
+#include "mrViewer.h"
+#include "mrvCore/mrvI8N.h"
+
+namespace mrv
+{
+    namespace
+    {
+        //! Minimum number of rows accumulated by each thread.
+        const int kMinRows = 16;
+
+        //! Rec. 709 luminance of a pixel stored as BGRA.
+        inline float to_lumma(const image::Color4f& p) noexcept
+        {
+            return p.b * 0.2126F + p.g * 0.7152F + p.r * 0.0722F;
+        }
+    } // namespace
+
+    struct Waveform::Private
+    {
+        Mode mode = kLumma;
+
+        //! Density plot of the last update, as RGB pixels of
+        //! width x height.
+        int width = 0;
+        int height = 0;
+        std::vector<uint8_t> pixels;
+
+        ViewerUI* ui = nullptr;
+    };
+
+    Waveform::Waveform(int X, int Y, int W, int H, const char* L) :
+        Fl_Box(X, Y, W, H, L),
+        _p(new Private)
+    {
+        tooltip(_("Mark an area in the image with SHIFT + the left mouse "
+                  "button"));
+    }
+
+    Waveform::~Waveform() {}
+
+    void Waveform::main(ViewerUI* m)
+    {
+        _p->ui = m;
+    }
+
+    ViewerUI* Waveform::main()
+    {
+        return _p->ui;
+    }
+
+    void Waveform::mode(Mode m)
+    {
+        _p->mode = m;
+    }
+
+    Waveform::Mode Waveform::mode() const
+    {
+        return _p->mode;
+    }
+
+    void Waveform::draw()
+    {
+        fl_rectf(x(), y(), w(), h(), 0, 0, 0);
+        draw_pixels();
+        draw_grid();
+    }
+
+    void Waveform::update(const area::Info& info)
+    {
+        TLRENDER_P();
+
+        Viewport* view = p.ui->uiView;
+        const image::Color4f* viewImage = view->image();
+        const math::Box2i& imageBox = view->imageBox();
+
+        const int channels = p.mode == kLumma ? 1 : 3;
+        const int W = w();
+        const int H = h();
+        const int columns = p.mode == kParade ? W / 3 : W;
+
+        // Only the selected area that the view read back is plotted.
+        const math::Box2i box = info.box.intersect(imageBox);
+        if (!viewImage || columns <= 0 || H <= 1 || box.min.x > box.max.x ||
+            box.min.y > box.max.y)
+        {
+            p.width = p.height = 0;
+            p.pixels.clear();
+            redraw();
+            return;
+        }
+
+        // Column of the plot that each column of the area falls in.
+        const int boxW = box.max.x - box.min.x + 1;
+        std::vector<int> columnOf(boxW);
+        for (int i = 0; i < boxW; ++i)
+            columnOf[i] = int(int64_t(i) * columns / boxW);
+
+        // Accumulate the hits of each level of each column, with one grid
+        // per thread that are merged at the end.
+        const size_t cells = size_t(columns) * H;
+        const size_t gridSize = cells * channels;
+        const int chunks = parallel_chunks(box.max.y - box.min.y + 1, kMinRows);
+        std::vector<uint32_t> grids(gridSize * chunks, 0);
+
+        const size_t stride = imageBox.w();
+        const float levels = float(H - 1);
+        const Mode mode = p.mode;
+        parallel_for(
+            box.min.y, box.max.y + 1,
+            [&](int chunk, int y0, int y1)
+            {
+                uint32_t* grid = grids.data() + gridSize * chunk;
+                for (int Y = y0; Y < y1; ++Y)
+                {
+                    const image::Color4f* row = viewImage +
+                                                (Y - imageBox.min.y) * stride +
+                                                (box.min.x - imageBox.min.x);
+                    if (mode == kLumma)
+                    {
+                        for (int i = 0; i < boxW; ++i)
+                        {
+                            const float v =
+                                std::clamp(to_lumma(row[i]), 0.F, 1.F);
+                            const int level = int((1.F - v) * levels + 0.5F);
+                            ++grid[size_t(level) * columns + columnOf[i]];
+                        }
+                        continue;
+                    }
+
+                    for (int i = 0; i < boxW; ++i)
+                    {
+                        // Pixels are stored as BGRA.
+                        const float values[3] = {row[i].b, row[i].g, row[i].r};
+                        for (int c = 0; c < 3; ++c)
+                        {
+                            const float v = std::clamp(values[c], 0.F, 1.F);
+                            const int level = int((1.F - v) * levels + 0.5F);
+                            ++grid
+                                [cells * c + size_t(level) * columns +
+                                 columnOf[i]];
+                        }
+                    }
+                }
+            },
+            kMinRows);
+
+        for (int chunk = 1; chunk < chunks; ++chunk)
+        {
+            const uint32_t* grid = grids.data() + gridSize * chunk;
+            for (size_t i = 0; i < gridSize; ++i)
+                grids[i] += grid[i];
+        }
+
+        uint32_t maxCount = 0;
+        for (size_t i = 0; i < gridSize; ++i)
+            maxCount = std::max(maxCount, grids[i]);
+
+        // Map the hits logarithmically to intensity.
+        p.width = W;
+        p.height = H;
+        p.pixels.assign(size_t(W) * H * 3, 0);
+        if (maxCount == 0)
+        {
+            redraw();
+            return;
+        }
+
+        const float logMax = std::log1p(float(maxCount));
+        for (int c = 0; c < channels; ++c)
+        {
+            const uint32_t* grid = grids.data() + cells * c;
+            const int offsetX = mode == kParade ? columns * c : 0;
+            for (int Y = 0; Y < H; ++Y)
+            {
+                for (int X = 0; X < columns; ++X)
+                {
+                    const uint32_t count = grid[size_t(Y) * columns + X];
+                    if (count == 0)
+                        continue;
+
+                    const float intensity =
+                        0.25F + 0.75F * std::log1p(float(count)) / logMax;
+                    const uint8_t v = uint8_t(intensity * 255.F);
+                    uint8_t* out =
+                        p.pixels.data() + (size_t(Y) * W + offsetX + X) * 3;
+                    switch (mode)
+                    {
+                    case kLumma:
+                        out[0] = out[1] = out[2] = v;
+                        break;
+                    case kParade:
+                        out[0] = out[1] = out[2] = v / 4;
+                        out[c] = v;
+                        break;
+                    case kRGB:
+                        out[c] = v;
+                        break;
+                    }
+                }
+            }
+        }
+
+        redraw();
+    }
+
+    void Waveform::draw_pixels() const noexcept
+    {
+        TLRENDER_P();
+
+        if (p.width <= 0 || p.height <= 0 || p.pixels.empty())
+            return;
+
+        fl_draw_image(p.pixels.data(), x(), y(), p.width, p.height, 3);
+    }
+
+    void Waveform::draw_grid() const noexcept
+    {
+        TLRENDER_P();
+
+        const int H = h() - 1;
+
+        // Draw the 0, 25, 50, 75 and 100% levels.
+        fl_font(FL_HELVETICA, 10);
+        for (int i = 0; i <= 4; ++i)
+        {
+            const int Y = y() + H - H * i / 4;
+            fl_color(96, 96, 96);
+            fl_line_style(FL_DOT);
+            fl_line(x(), Y, x() + w() - 1, Y);
+            fl_line_style(0);
+
+            char buf[8];
+            snprintf(buf, sizeof(buf), "%d", i * 25);
+            fl_color(255, 255, 0);
+            // Keep the 100% label inside the widget.
+            const int textY = i == 4 ? Y + fl_height() - fl_descent() : Y - 2;
+            fl_draw(buf, x() + 2, textY);
+        }
+
+        // Separate the channels of the parade.
+        if (p.mode == kParade)
+        {
+            const int columns = w() / 3;
+            fl_color(255, 255, 255);
+            for (int c = 1; c < 3; ++c)
+            {
+                const int X = x() + columns * c;
+                fl_line(X, y(), X, y() + H);
+            }
+        }
+    }
+
+} // namespace mrv
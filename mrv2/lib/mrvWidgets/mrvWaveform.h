@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// mrv2
+// Copyright Contributors to the mrv2 Project. All rights reserved.
+
+#pragma once
+
+#include <FL/Fl_Box.H>
+
+#include <tlCore/Util.h>
+
+#include "mrvFl/mrvColorAreaInfo.h"
+
+class ViewerUI;
+
+namespace mrv
+{
+    using namespace tl;
+
+    class Waveform : public Fl_Box
+    {
+    public:
+        enum Mode {
+            kLumma,  //!< Luminance waveform.
+            kParade, //!< Red, green and blue waveforms side by side.
+            kRGB,    //!< Red, green and blue waveforms overlaid.
+        };
+
+    public:
+        Waveform(int X, int Y, int W, int H, const char* L = 0);
+        ~Waveform();
+
+        //! Set the mode of the waveform.  Takes effect on next update.
+        void mode(Mode m);
+        Mode mode() const;
+
+        virtual void draw() override;
+
+        void update(const area::Info& info);
+
+        void main(ViewerUI* m);
+        ViewerUI* main();
+
+    protected:
+        void draw_pixels() const noexcept;
+        void draw_grid() const noexcept;
+
+        TLRENDER_PRIVATE();
+    };
+
+} // namespace mrv